@@ -0,0 +1,186 @@
+#pragma once
+#include "pathfinding/grid.h"
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Map families used by the benchmarks
+enum class MapFamily {
+    Open = 0,     // No obstacles
+    Random = 1,   // 25% of the cells are walls
+    Maze = 2,     // Corridors one cell wide
+    Rooms = 3     // Square rooms joined by doors
+};
+
+inline const char* mapFamilyName(MapFamily family) {
+    switch (family) {
+        case MapFamily::Open: return "open";
+        case MapFamily::Random: return "random";
+        case MapFamily::Maze: return "maze";
+        case MapFamily::Rooms: return "rooms";
+    }
+    return "unknown";
+}
+
+// Maps are generated from a fixed seed so every run measures the same grids
+inline Grid makeBenchMap(MapFamily family, int width, int height, unsigned int seed = 42) {
+    Grid grid(width, height);
+    std::mt19937 rng(seed);
+
+    switch (family) {
+        case MapFamily::Open:
+            break;
+
+        case MapFamily::Random: {
+            std::uniform_int_distribution<int> percent(0, 99);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (percent(rng) < 25) {
+                        grid.setCell(x, y, CellType::Wall);
+                    }
+                }
+            }
+            break;
+        }
+
+        case MapFamily::Maze: {
+            // Iterative depth-first carving between the cells with even coordinates
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    grid.setCell(x, y, CellType::Wall);
+                }
+            }
+
+            int cellsX = (width + 1) / 2;
+            int cellsY = (height + 1) / 2;
+            std::vector<std::uint8_t> visited(static_cast<size_t>(cellsX) * cellsY, 0);
+            std::vector<std::pair<int, int>> stack = {{0, 0}};
+            visited[0] = 1;
+            grid.setCell(0, 0, CellType::Empty);
+
+            const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+            while (!stack.empty()) {
+                auto [cx, cy] = stack.back();
+
+                int options[4];
+                int count = 0;
+                for (int d = 0; d < 4; ++d) {
+                    int nx = cx + dirs[d][0];
+                    int ny = cy + dirs[d][1];
+                    if (nx >= 0 && nx < cellsX && ny >= 0 && ny < cellsY && !visited[ny * cellsX + nx]) {
+                        options[count++] = d;
+                    }
+                }
+
+                if (count == 0) {
+                    stack.pop_back();
+                    continue;
+                }
+
+                int d = options[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+                int nx = cx + dirs[d][0];
+                int ny = cy + dirs[d][1];
+                visited[ny * cellsX + nx] = 1;
+                grid.setCell(cx * 2 + dirs[d][0], cy * 2 + dirs[d][1], CellType::Empty);
+                grid.setCell(nx * 2, ny * 2, CellType::Empty);
+                stack.push_back({nx, ny});
+            }
+            break;
+        }
+
+        case MapFamily::Rooms: {
+            // Walls every 16 cells with a two cell door in each wall segment
+            const int roomSize = 16;
+            std::uniform_int_distribution<int> doorOffset(1, roomSize - 3);
+
+            for (int y = roomSize; y < height; y += roomSize) {
+                for (int x0 = 0; x0 < width; x0 += roomSize) {
+                    int door = x0 + doorOffset(rng);
+                    for (int x = x0; x < std::min(x0 + roomSize, width); ++x) {
+                        if (x != door && x != door + 1) {
+                            grid.setCell(x, y, CellType::Wall);
+                        }
+                    }
+                }
+            }
+            for (int x = roomSize; x < width; x += roomSize) {
+                for (int y0 = 0; y0 < height; y0 += roomSize) {
+                    int door = y0 + doorOffset(rng);
+                    for (int y = y0; y < std::min(y0 + roomSize, height); ++y) {
+                        if (y != door && y != door + 1) {
+                            grid.setCell(x, y, CellType::Wall);
+                        }
+                    }
+                }
+            }
+            break;
+        }
+    }
+
+    return grid;
+}
+
+// Reachable (start, goal) pairs at most maxDistance steps apart.
+// Goals are picked among the cells reached by a bounded breadth-first search from the start,
+// so every query has a solution and query length does not grow with the map.
+inline std::vector<std::pair<Position, Position>> makeBenchQueries(const Grid& grid, int count,
+                                                                  int maxDistance,
+                                                                  unsigned int seed = 7) {
+    std::vector<std::pair<Position, Position>> queries;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> randomX(0, grid.getWidth() - 1);
+    std::uniform_int_distribution<int> randomY(0, grid.getHeight() - 1);
+
+    std::vector<int> distance(static_cast<size_t>(grid.getWidth()) * grid.getHeight(), -1);
+    std::vector<Position> touched;
+
+    for (int attempt = 0; attempt < count * 100 && static_cast<int>(queries.size()) < count; ++attempt) {
+        Position start(randomX(rng), randomY(rng));
+        if (!grid.isWalkable(start)) {
+            continue;
+        }
+
+        std::vector<Position> reached;
+        std::queue<Position> frontier;
+        frontier.push(start);
+        distance[start.y * grid.getWidth() + start.x] = 0;
+        touched.push_back(start);
+
+        while (!frontier.empty()) {
+            Position current = frontier.front();
+            frontier.pop();
+            int currentDistance = distance[current.y * grid.getWidth() + current.x];
+
+            // Prefer goals in the far half of the range
+            if (currentDistance >= maxDistance / 2) {
+                reached.push_back(current);
+            }
+            if (currentDistance == maxDistance) {
+                continue;
+            }
+
+            for (const Position& next : grid.getNeighbors(current)) {
+                int& nextDistance = distance[next.y * grid.getWidth() + next.x];
+                if (nextDistance < 0) {
+                    nextDistance = currentDistance + 1;
+                    touched.push_back(next);
+                    frontier.push(next);
+                }
+            }
+        }
+
+        for (const Position& pos : touched) {
+            distance[pos.y * grid.getWidth() + pos.x] = -1;
+        }
+        touched.clear();
+
+        if (!reached.empty()) {
+            Position goal = reached[std::uniform_int_distribution<size_t>(0, reached.size() - 1)(rng)];
+            queries.push_back({start, goal});
+        }
+    }
+
+    return queries;
+}
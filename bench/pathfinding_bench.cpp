@@ -0,0 +1,349 @@
+#include <benchmark/benchmark.h>
+#include "bench_maps.h"
+#include "pathfinding/pathfinder.h"
+#include "pathfinding/contractionhierarchy.h"
+#include "pathfinding/pathdatabase.h"
+#include "pathfinding/subgoalgraph.h"
+#include "pathfinding/symmetryreduction.h"
+#include "pathfinding/gridstate.h"
+#include "pathfinding/fsa.h"
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+
+// Count every heap allocation so benchmarks can report allocations per query
+namespace {
+    std::atomic<size_t> allocationCount{0};
+}
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// Map sizes: the 40x30 demo grid, then square maps
+const int kMapSizes[][2] = {{40, 30}, {256, 256}, {1024, 1024}, {4096, 4096}};
+
+// Queries stay local so the largest maps run in bounded time;
+// map size then shows up through memory and cache behaviour
+const int kQueryCount = 64;
+const int kQueryDistance = 64;
+
+// Enough nodes for any query of kQueryDistance steps
+const int kMaxSearchNodes = 1 << 17;
+
+struct BenchMap {
+    Grid grid;
+    std::vector<std::pair<Position, Position>> queries;
+};
+
+// Maps are expensive to build at 4096x4096, so each one is generated once
+const BenchMap& getBenchMap(MapFamily family, int sizeIndex) {
+    static std::map<std::pair<int, int>, std::unique_ptr<BenchMap>> maps;
+
+    auto& map = maps[{static_cast<int>(family), sizeIndex}];
+    if (!map) {
+        Grid grid = makeBenchMap(family, kMapSizes[sizeIndex][0], kMapSizes[sizeIndex][1]);
+        auto queries = makeBenchQueries(grid, kQueryCount, kQueryDistance);
+        map = std::make_unique<BenchMap>(BenchMap{std::move(grid), std::move(queries)});
+    }
+    return *map;
+}
+
+void BM_FindPath(benchmark::State& state, MapFamily family, int sizeIndex, OpenListPolicy policy,
+                 Connectivity connectivity) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    if (map.queries.empty()) {
+        state.SkipWithError("no reachable queries");
+        return;
+    }
+
+    // Snapshots share the cells, so only the movement rules differ
+    Grid grid = map.grid;
+    grid.setMovement(connectivity);
+
+    Pathfinder pathfinder(kMaxSearchNodes);
+    pathfinder.setOpenListPolicy(policy);
+    std::vector<Position> path;
+    size_t query = 0;
+    size_t expansions = 0;
+    size_t failures = 0;
+
+    size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        const auto& [start, goal] = map.queries[query];
+        query = (query + 1) % map.queries.size();
+
+        if (!pathfinder.findPath(grid, start, goal, path)) {
+            failures++;
+        }
+        expansions += pathfinder.getLastSearchSteps();
+        benchmark::DoNotOptimize(path.data());
+    }
+    size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    state.counters["expansions/s"] = benchmark::Counter(static_cast<double>(expansions), benchmark::Counter::kIsRate);
+    state.counters["expansions/query"] = benchmark::Counter(static_cast<double>(expansions), benchmark::Counter::kAvgIterations);
+    state.counters["allocs/query"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    if (failures) {
+        state.counters["failures"] = static_cast<double>(failures);
+    }
+}
+
+void BM_GetNeighbors(benchmark::State& state, MapFamily family, int sizeIndex) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    const Grid& grid = map.grid;
+    int x = 0;
+    int y = 0;
+
+    size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        std::vector<Position> neighbors = grid.getNeighbors(Position{x, y});
+        benchmark::DoNotOptimize(neighbors.data());
+
+        if (++x == grid.getWidth()) {
+            x = 0;
+            y = (y + 1) % grid.getHeight();
+        }
+    }
+    size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    state.counters["allocs/call"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_GetSuccessors(benchmark::State& state, MapFamily family, int sizeIndex) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    const Grid& grid = map.grid;
+
+    // Successors stay allocated until the search object goes away, so it is
+    // recreated outside the timed region once its node pool is used up
+    const int callsPerSearch = 4096;
+    auto search = std::make_unique<AStarSearch<GridState>>(callsPerSearch * 4);
+    int calls = 0;
+    int x = 0;
+    int y = 0;
+
+    for (auto _ : state) {
+        if (calls == callsPerSearch) {
+            state.PauseTiming();
+            search = std::make_unique<AStarSearch<GridState>>(callsPerSearch * 4);
+            calls = 0;
+            state.ResumeTiming();
+        }
+
+        GridState node(Position{x, y}, &grid);
+        benchmark::DoNotOptimize(node.GetSuccessors(search.get(), nullptr));
+        calls++;
+
+        if (++x == grid.getWidth()) {
+            x = 0;
+            y = (y + 1) % grid.getHeight();
+        }
+    }
+}
+
+// Whole paths for the same queries as BM_FindPath, one next-step query per cell
+void BM_PathDatabase(benchmark::State& state, MapFamily family, int sizeIndex) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    if (map.queries.empty()) {
+        state.SkipWithError("no reachable queries");
+        return;
+    }
+
+    PathDatabase database;
+    database.build(map.grid);
+    std::vector<Position> path;
+    size_t query = 0;
+    size_t steps = 0;
+
+    for (auto _ : state) {
+        const auto& [start, goal] = map.queries[query];
+        query = (query + 1) % map.queries.size();
+
+        database.getPath(start, goal, path);
+        steps += path.size();
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.counters["steps/s"] = benchmark::Counter(static_cast<double>(steps), benchmark::Counter::kIsRate);
+    state.counters["bytes"] = static_cast<double>(database.getMemoryBytes());
+}
+
+// BM_FindPath8 queries answered over a simple subgoal graph of the map
+void BM_FindPathSubgoal(benchmark::State& state, MapFamily family, int sizeIndex) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    if (map.queries.empty()) {
+        state.SkipWithError("no reachable queries");
+        return;
+    }
+
+    Grid grid = map.grid;
+    grid.setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    SubgoalGraph graph;
+    graph.build(grid);
+    Pathfinder pathfinder(kMaxSearchNodes);
+    pathfinder.setSubgoalGraph(&graph);
+    std::vector<Position> path;
+    size_t query = 0;
+    size_t expansions = 0;
+
+    for (auto _ : state) {
+        const auto& [start, goal] = map.queries[query];
+        query = (query + 1) % map.queries.size();
+
+        pathfinder.findPath(grid, start, goal, path);
+        expansions += pathfinder.getLastSearchSteps();
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.counters["expansions/query"] = benchmark::Counter(static_cast<double>(expansions), benchmark::Counter::kAvgIterations);
+    state.counters["subgoals"] = static_cast<double>(graph.getSubgoalCount());
+}
+
+// BM_FindPath queries answered from a contraction hierarchy of the map
+void BM_FindPathHierarchy(benchmark::State& state, MapFamily family, int sizeIndex) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    if (map.queries.empty()) {
+        state.SkipWithError("no reachable queries");
+        return;
+    }
+
+    ContractionHierarchy hierarchy;
+    hierarchy.build(map.grid);
+    Pathfinder pathfinder(kMaxSearchNodes);
+    pathfinder.setContractionHierarchy(&hierarchy);
+    std::vector<Position> path;
+    size_t query = 0;
+    size_t expansions = 0;
+
+    for (auto _ : state) {
+        const auto& [start, goal] = map.queries[query];
+        query = (query + 1) % map.queries.size();
+
+        pathfinder.findPath(map.grid, start, goal, path);
+        expansions += pathfinder.getLastSearchSteps();
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.counters["expansions/query"] = benchmark::Counter(static_cast<double>(expansions), benchmark::Counter::kAvgIterations);
+    state.counters["shortcuts"] = static_cast<double>(hierarchy.getShortcutCount());
+}
+
+// BM_FindPath queries searched over the rectangular symmetry reduction of the map
+void BM_FindPathSymmetry(benchmark::State& state, MapFamily family, int sizeIndex) {
+    const BenchMap& map = getBenchMap(family, sizeIndex);
+    if (map.queries.empty()) {
+        state.SkipWithError("no reachable queries");
+        return;
+    }
+
+    SymmetryReduction reduction;
+    reduction.build(map.grid);
+    Pathfinder pathfinder(kMaxSearchNodes);
+    pathfinder.setSymmetryReduction(&reduction);
+    std::vector<Position> path;
+    size_t query = 0;
+    size_t expansions = 0;
+
+    for (auto _ : state) {
+        const auto& [start, goal] = map.queries[query];
+        query = (query + 1) % map.queries.size();
+
+        pathfinder.findPath(map.grid, start, goal, path);
+        expansions += pathfinder.getLastSearchSteps();
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.counters["expansions/query"] = benchmark::Counter(static_cast<double>(expansions), benchmark::Counter::kAvgIterations);
+    state.counters["build_us"] = reduction.getBuildMicros();
+    state.counters["border_cells"] = static_cast<double>(reduction.getBorderCount());
+}
+
+void BM_FsaAllocFree(benchmark::State& state) {
+    using Node = AStarSearch<GridState>::Node;
+    const int batch = static_cast<int>(state.range(0));
+
+    FixedSizeAllocator<Node> allocator(batch);
+    std::vector<Node*> nodes(batch);
+
+    for (auto _ : state) {
+        for (int i = 0; i < batch; ++i) {
+            nodes[i] = allocator.alloc();
+        }
+        benchmark::DoNotOptimize(nodes.data());
+        for (int i = 0; i < batch; ++i) {
+            allocator.free(nodes[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+// Benchmark names read e.g. BM_FindPath/maze/1024x1024; BM_FindPathHeap runs the
+// same queries with the binary heap open list instead of the default bucket queue,
+// BM_FindPath8 and BM_FindPath8Heap with 8-connected moves, BM_PathDatabase from a path database,
+// BM_FindPathSubgoal over a subgoal graph, BM_FindPathHierarchy from a contraction hierarchy,
+// BM_FindPathSymmetry over a rectangular symmetry reduction
+void registerMapBenchmarks() {
+    const MapFamily families[] = {MapFamily::Open, MapFamily::Random, MapFamily::Maze, MapFamily::Rooms};
+
+    for (MapFamily family : families) {
+        for (int sizeIndex = 0; sizeIndex < 4; ++sizeIndex) {
+            std::string suffix = std::string("/") + mapFamilyName(family) + "/" +
+                                 std::to_string(kMapSizes[sizeIndex][0]) + "x" +
+                                 std::to_string(kMapSizes[sizeIndex][1]);
+            benchmark::RegisterBenchmark(("BM_FindPath" + suffix).c_str(), BM_FindPath, family, sizeIndex,
+                                         OpenListPolicy::Buckets, Connectivity::Four);
+            benchmark::RegisterBenchmark(("BM_FindPathHeap" + suffix).c_str(), BM_FindPath, family, sizeIndex,
+                                         OpenListPolicy::Heap, Connectivity::Four);
+            benchmark::RegisterBenchmark(("BM_FindPath8" + suffix).c_str(), BM_FindPath, family, sizeIndex,
+                                         OpenListPolicy::Buckets, Connectivity::Eight);
+            benchmark::RegisterBenchmark(("BM_FindPath8Heap" + suffix).c_str(), BM_FindPath, family, sizeIndex,
+                                         OpenListPolicy::Heap, Connectivity::Eight);
+            if (sizeIndex < 3) {
+                benchmark::RegisterBenchmark(("BM_FindPathSubgoal" + suffix).c_str(), BM_FindPathSubgoal, family, sizeIndex);
+                benchmark::RegisterBenchmark(("BM_FindPathSymmetry" + suffix).c_str(), BM_FindPathSymmetry, family, sizeIndex);
+            }
+            benchmark::RegisterBenchmark(("BM_GetNeighbors" + suffix).c_str(), BM_GetNeighbors, family, sizeIndex);
+            // One Dijkstra search per cell to build, so only the demo grid
+            if (sizeIndex == 0) {
+                benchmark::RegisterBenchmark(("BM_PathDatabase" + suffix).c_str(), BM_PathDatabase, family, sizeIndex);
+            }
+            if (sizeIndex < 2) {
+                benchmark::RegisterBenchmark(("BM_FindPathHierarchy" + suffix).c_str(), BM_FindPathHierarchy, family, sizeIndex);
+            }
+            benchmark::RegisterBenchmark(("BM_GetSuccessors" + suffix).c_str(), BM_GetSuccessors, family, sizeIndex);
+        }
+    }
+
+    benchmark::RegisterBenchmark("BM_FsaAllocFree", BM_FsaAllocFree)->Arg(64)->Arg(1024);
+}
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    registerMapBenchmarks();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
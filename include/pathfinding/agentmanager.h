@@ -0,0 +1,82 @@
+#pragma once
+#include "grid.h"
+#include "pathfinder.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Handle of an agent stored in an AgentManager (index into its arrays)
+using AgentId = std::uint32_t;
+
+// Stores many characters in structure-of-arrays form. Each agent is a few
+// plain integers (position, packed color, path offset/length/cursor), all
+// paths share one pooled buffer and searches go through a small pool of
+// Pathfinder engines instead of one engine per agent.
+class AgentManager {
+public:
+    // Constructor - searchEngines is the number of shared Pathfinder instances
+    explicit AgentManager(size_t searchEngines = 1);
+
+    // Agents
+    AgentId addAgent(const Position& pos, sf::Color color = sf::Color::Green);
+    size_t size() const { return posX_.size(); }
+    void reserve(size_t agentCount);
+
+    // Position and color access
+    Position getPosition(AgentId id) const {
+        return Position(posX_[id], posY_[id]);
+    }
+
+    void setPosition(AgentId id, const Position& pos);
+
+    sf::Color getColor(AgentId id) const {
+        return sf::Color(color_[id]);
+    }
+
+    void setColor(AgentId id, const sf::Color& color) {
+        color_[id] = color.toInteger();
+    }
+
+    // A* Pathfinding
+    bool findPathTo(AgentId id, const Grid& grid, const Position& target);
+    void setPath(AgentId id, const std::vector<Position>& steps);  // Steps exclude the current position
+    void clearPath(AgentId id);
+    bool hasPath(AgentId id) const { return pathCursor_[id] < pathLength_[id]; }
+    size_t getRemainingPathLength(AgentId id) const { return pathLength_[id] - pathCursor_[id]; }
+    Position getPathStep(AgentId id, size_t step) const;  // step-th remaining position
+
+    // Move every agent with a path one step along it
+    void followPaths();
+
+    // Rendering
+    void render(sf::RenderWindow& window, float tileSize) const;
+
+    // Pool introspection
+    size_t getPathPoolSize() const { return pathX_.size(); }
+    size_t getSearchEngineCount() const { return engines_.size(); }
+
+private:
+    // Per-agent state
+    std::vector<std::int32_t> posX_;
+    std::vector<std::int32_t> posY_;
+    std::vector<std::uint32_t> color_;       // sf::Color packed as RGBA
+    std::vector<std::uint32_t> pathOffset_;  // First slot of the path in the pool
+    std::vector<std::uint32_t> pathLength_;  // Number of steps in the path
+    std::vector<std::uint32_t> pathCursor_;  // Next step to take
+
+    // Pooled path storage shared by all agents
+    std::vector<std::int32_t> pathX_;
+    std::vector<std::int32_t> pathY_;
+    size_t pathGarbage_;  // Pool slots no longer referenced by any agent
+
+    // Shared search engines, handed out round-robin
+    std::vector<std::unique_ptr<Pathfinder>> engines_;
+    size_t nextEngine_;
+    std::vector<Position> scratchPath_;
+
+    Pathfinder& acquireEngine();
+    void assignPath(AgentId id, const Position* steps, size_t count);
+    void releasePath(AgentId id);
+    void compactPathPool();
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "grid.h"
 #include "pathfinder.h"
+#include "pathrequestscheduler.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 
@@ -8,6 +9,7 @@ class Character {
 public:
     // Constructor
     Character(const Position& startPos, sf::Color color = sf::Color::Green);
+    ~Character();
     
     // Movement
     bool moveUp(const Grid& grid);
@@ -44,7 +46,25 @@ public:
     void followPath();  // Move one step along the current path
     void clearPath();   // Clear the current path
     bool hasPath() const { return !currentPath_.empty(); }
-    const std::vector<Position>& getCurrentPath() const { return currentPath_; }
+    const PathResult& getCurrentPath() const { return currentPath_; }  // Steps (or waypoints) still to take
+    void setPathCache(PathCache* cache) { pathfinder_.setPathCache(cache); }
+    
+    // Keep only the waypoints of paths found by findPathTo; followPath then walks the
+    // straight lines between them one cell at a time
+    void setPathSmoothing(bool enabled) { pathSmoothing_ = enabled; }
+    bool getPathSmoothing() const { return pathSmoothing_; }
+
+    // Static maps: findPathTo keeps only the target and followPath asks database for each
+    // step (not owned). The map must not change while such a path is followed; findPathTo
+    // searches as usual when the database does not match the grid.
+    void setPathDatabase(const PathDatabase* database) { pathDatabase_ = database; }
+    const PathDatabase* getPathDatabase() const { return pathDatabase_; }
+
+    // Deferred pathfinding through a shared scheduler, which must outlive the character.
+    // A new request or the character's destruction cancels the pending one.
+    void requestPathTo(PathRequestScheduler& scheduler, const Position& target, int urgency = 0);
+    bool receivePath(PathRequestScheduler& scheduler);  // Returns true once a path has been taken over
+    bool hasPendingRequest() const { return pendingRequest_ != 0; }
 
 private:
     Position position_;
@@ -52,8 +72,19 @@ private:
     
     // Pathfinding members
     Pathfinder pathfinder_;
-    std::vector<Position> currentPath_;
-    size_t pathIndex_;  // Current index in the path
+    PathResult currentPath_;  // Cursor marks the next step
+    PathRequestId pendingRequest_;  // 0 when no request is queued
+    PathRequestScheduler* requestScheduler_;  // Scheduler holding pendingRequest_ (not owned)
+    
+    // Smoothing - the line being walked towards the next waypoint
+    bool pathSmoothing_;
+    Connectivity lineConnectivity_;
+    GridLine line_;
+    std::vector<Position> waypoints_;
+    
+    // Next steps come from the database; the path only holds the target
+    const PathDatabase* pathDatabase_;
+    bool followDatabase_;
     
     bool tryMove(const Grid& grid, const Position& newPos);
 };
\ No newline at end of file
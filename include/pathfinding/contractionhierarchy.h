@@ -0,0 +1,94 @@
+#pragma once
+#include "grid.h"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Contraction hierarchy over the walkable cells of a grid, for many long queries on a map
+// that does not change. Cells are contracted one by one in order of importance; each
+// contraction adds shortcut arcs between its remaining neighbors wherever no other path
+// is as cheap (a "witness"). A query then only follows arcs up the order, from the start
+// and back from the goal, and expands the shortcuts of the meeting path back into cells.
+// Moves and costs are those of the grid (moving into a cell pays that cell's cost, so
+// arcs are directed), and path costs are the ones Pathfinder::findPath finds.
+// Walls and terrain make the hierarchy pay off; wide open areas of one terrain have so many
+// equally short paths that A* already walks straight to the goal there.
+class ContractionHierarchy {
+public:
+    ContractionHierarchy();
+
+    // Contract every walkable cell of grid. Cells that do not touch each other are
+    // contracted in rounds spread over threads (0 picks one per core).
+    void build(const Grid& grid, unsigned int threads = 0);
+
+    // True if the hierarchy was built from the grid as it is now
+    bool isValidFor(const Grid& grid) const;
+
+    // Shortest path start -> goal, both included. The grid must be the one the hierarchy
+    // was built from. Returns false if there is none.
+    bool findPath(const Grid& grid, const Position& start, const Position& goal, std::vector<Position>& path);
+
+    size_t getNodeCount() const { return positions_.size(); }
+    size_t getShortcutCount() const { return shortcutCount_; }
+    size_t getMemoryBytes() const;
+
+    // Statistics of the last findPath
+    float getLastPathCost() const { return lastPathCost_; }
+    size_t getLastExpansions() const { return lastExpansions_; }
+
+private:
+    // Arc to or from node; a shortcut records the node it skips (-1 for a grid move)
+    struct Arc {
+        int node;
+        float cost;
+        int middle;
+    };
+
+    // Arcs of every node in one array, by node
+    struct ArcTable {
+        std::vector<std::uint32_t> offsets;
+        std::vector<Arc> arcs;
+
+        const Arc* begin(int node) const { return arcs.data() + offsets[node]; }
+        const Arc* end(int node) const { return arcs.data() + offsets[node + 1]; }
+    };
+
+    int nodeAt(const Position& pos) const {
+        return pos.x >= 0 && pos.y >= 0 && pos.x < width_ && pos.y < height_ ? nodeAt_[pos.y * width_ + pos.x] : -1;
+    }
+
+    // True if the grid moves and costs as it did when the hierarchy was built
+    bool sameRules(const Grid& grid) const;
+
+    // Append the cells of arc from -> to after from, expanding shortcuts
+    void unpack(int from, int to, int middle, std::vector<Position>& path) const;
+
+    int width_, height_;
+    std::uint64_t revision_;
+    std::uint64_t cellHash_;  // Grid::getCellHash() of the grid described
+    Connectivity connectivity_;
+    CornerCutting cornerCutting_;
+    std::array<float, kCellTypeCount> terrainCosts_;
+    std::vector<int> nodeAt_;           // Node of every cell, -1 for walls
+    std::vector<Position> positions_;   // Cell of every node
+    ArcTable up_;                       // Arcs from each node to nodes contracted later
+    ArcTable down_;                     // Arcs into each node from nodes contracted later
+    size_t shortcutCount_;
+
+    // Query scratch, one side per search direction
+    struct Label {
+        std::uint32_t stamp;
+        float distance;
+        int parent;
+        int middle;  // Of the arc from the parent
+    };
+    struct Side {
+        std::vector<Label> labels;
+        std::vector<std::pair<float, int>> open;  // Binary heap on distance
+    };
+    Side sides_[2];
+    std::uint32_t stamp_;
+    float lastPathCost_;
+    size_t lastExpansions_;
+};
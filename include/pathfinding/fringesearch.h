@@ -0,0 +1,44 @@
+#pragma once
+#include "searchengine.h"
+#include <cstdint>
+#include <vector>
+
+// Fringe Search (Bjornsson et al.): IDA*-style iterations over a list of frontier nodes, so
+// there is no priority queue and each iteration just sweeps the list. Every node visited
+// lives in one fixed-size hash table allocated from the memory budget; the frontier list
+// is threaded through the same entries. A search that fills the table fails as out of memory.
+class FringeSearch : public SearchEngine {
+public:
+    explicit FringeSearch(size_t memoryBudget = kDefaultMemoryBudget);
+    
+    bool findPath(const Grid& grid, const Position& start, const Position& goal,
+                  std::vector<Position>& path) override;
+    
+    size_t getMemoryBytes() const override { return slots_.capacity() * sizeof(Slot); }
+    
+    // Most nodes a search can visit
+    size_t getNodeCapacity() const { return maxNodes_; }
+
+private:
+    struct Slot {
+        std::uint32_t generation;  // Search the slot was filled in
+        int cell;                  // y * width + x
+        float g;
+        int parent;                // Slot of the parent, -1 for the start
+        int prev, next;            // Fringe links, -1 at the ends
+        bool inFringe;
+    };
+    
+    // Slot of cell, or the empty slot where it would go
+    int findSlot(int cell) const;
+    
+    void linkAfter(int slot, int after);
+    void unlink(int slot);
+    
+    std::vector<Slot> slots_;
+    size_t mask_;       // Table size - 1 (a power of two)
+    int shift_;         // Hashes keep their top log2(table size) bits
+    size_t maxNodes_;   // Kept below the table size so probes stay short
+    std::uint32_t generation_;
+    int head_;          // First slot of the fringe
+};
@@ -42,7 +42,7 @@ class FixedSizeAllocator {
 
    public:  // methods
     FixedSizeAllocator(unsigned int MaxElements = FSA_DEFAULT_SIZE)
-        : m_pFirstUsed(NULL), m_MaxElements(MaxElements) {
+        : m_pFirstUsed(NULL), m_MaxElements(MaxElements), m_HighWater(0) {
         // Allocate enough memory for the maximum number of elements
 
         char* pMem = new char[m_MaxElements * sizeof(FSA_ELEMENT)];
@@ -52,8 +52,8 @@ class FixedSizeAllocator {
         // Set the free list first pointer
         m_pFirstFree = m_pMemory;
 
-        // Clear the memory
-        memset(m_pMemory, 0, sizeof(FSA_ELEMENT) * m_MaxElements);
+        // Clear the memory (raw storage: elements are constructed in place when allocated)
+        memset(static_cast<void*>(m_pMemory), 0, sizeof(FSA_ELEMENT) * m_MaxElements);
 
         // Point at first element
         FSA_ELEMENT* pElement = m_pFirstFree;
@@ -105,6 +105,12 @@ class FixedSizeAllocator {
             }
 
             m_pFirstUsed = pNewNode;
+
+            // remember how far into the memory block allocations have reached
+            unsigned int index = (unsigned int)(pNewNode - m_pMemory) + 1;
+            if (index > m_HighWater) {
+                m_HighWater = index;
+            }
         }
 
         return reinterpret_cast<USER_TYPE*>(pNewNode);
@@ -144,6 +150,37 @@ class FixedSizeAllocator {
         }
     }
 
+    // Return every element to the free list at once. Destructors are not called.
+    // Only elements below the high-water mark were ever handed out, so relinking those
+    // in order and joining them to the untouched rest is enough: the cost is the number
+    // of elements used since the last FreeAll, not the capacity.
+    void FreeAll() {
+        if (m_HighWater == 0) {
+            return;
+        }
+
+        for (unsigned int i = 0; i < m_HighWater; i++) {
+            m_pMemory[i].pPrev = i ? &m_pMemory[i - 1] : NULL;
+            m_pMemory[i].pNext = &m_pMemory[i + 1];
+        }
+
+        if (m_HighWater < m_MaxElements) {
+            m_pMemory[m_HighWater].pPrev = &m_pMemory[m_HighWater - 1];
+        } else {
+            m_pMemory[m_HighWater - 1].pNext = NULL;
+        }
+
+        m_pFirstFree = m_pMemory;
+        m_pFirstUsed = NULL;
+        m_HighWater = 0;
+    }
+
+    // Number of elements at the start of the block that have been handed out since
+    // construction or the last FreeAll
+    unsigned int GetHighWaterMark() const {
+        return m_HighWater;
+    }
+
     // For debugging this displays both lists (using the prev/next list pointers)
     void Debug() {
         printf("free list ");
@@ -182,6 +219,7 @@ class FixedSizeAllocator {
     FSA_ELEMENT* m_pFirstUsed;
     unsigned int m_MaxElements;
     FSA_ELEMENT* m_pMemory;
+    unsigned int m_HighWater;
 };
 
 #endif  // defined FSA_H
\ No newline at end of file
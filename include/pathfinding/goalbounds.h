@@ -0,0 +1,75 @@
+#pragma once
+#include "grid.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Goal bounding: for every cell and each of its moves, the bounding box of the cells that
+// some shortest path from the cell starts with that move. A search heading for a goal
+// outside a move's box can skip the move and still finds an optimal path.
+// Tables take one Dijkstra search per cell to build, so they suit the static parts of a
+// map; they describe the grid revision they were built at and go stale on any edit.
+class GoalBounds {
+public:
+    // Cells reached optimally through one move, in 16-bit coordinates
+    struct Box {
+        std::uint16_t minX, minY, maxX, maxY;
+
+        bool contains(const Position& pos) const {
+            return pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY;
+        }
+    };
+
+    // Largest grid side the 16-bit boxes can describe
+    static constexpr int kMaxSide = 0xffff;
+
+    GoalBounds();
+
+    // Precompute the tables of every cell, spread over threads (0 picks one per core).
+    // Returns false and leaves the tables empty if the grid is too large.
+    bool build(const Grid& grid, unsigned int threads = 0);
+
+    // Bring the tables up to date after edits to the cells in [regionMin, regionMax] only.
+    // Recomputes just the cells whose reachable area touches the region (the whole
+    // table after a change of size, movement rules or terrain costs).
+    // Returns the number of cells recomputed.
+    size_t rebuild(const Grid& grid, const Position& regionMin, const Position& regionMax,
+                   unsigned int threads = 0);
+
+    // True if the tables describe the grid as it is now
+    bool isValidFor(const Grid& grid) const;
+
+    // True unless the move from -> to (neighbors) is on no shortest path to goal
+    bool allows(const Position& from, const Position& to, const Position& goal) const {
+        return boxes_[index(from, to)].contains(goal);
+    }
+
+    const Box& getBox(const Position& from, const Position& to) const { return boxes_[index(from, to)]; }
+
+    std::uint64_t getRevision() const { return revision_; }
+    size_t getMemoryBytes() const { return boxes_.capacity() * sizeof(Box); }
+
+private:
+    // Boxes of a cell start here
+    size_t cellIndex(const Position& pos) const {
+        return (static_cast<size_t>(pos.y) * width_ + pos.x) * Grid::kMaxNeighbors;
+    }
+
+    size_t index(const Position& from, const Position& to) const {
+        return cellIndex(from) + Grid::moveIndex(from, to);
+    }
+
+    // True if the grid moves and costs as it did when the tables were built
+    bool sameRules(const Grid& grid) const;
+
+    // Recompute the tables of the given cells (all cells if null), spread over threads
+    void compute(const Grid& grid, const std::vector<int>* cells, unsigned int threads);
+
+    int width_, height_;
+    std::uint64_t revision_;
+    std::uint64_t cellHash_;  // Grid::getCellHash() of the grid described
+    Connectivity connectivity_;
+    CornerCutting cornerCutting_;
+    std::array<float, kCellTypeCount> terrainCosts_;
+    std::vector<Box> boxes_;  // kMaxNeighbors per cell
+};
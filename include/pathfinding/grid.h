@@ -1,4 +1,9 @@
 #pragma once
+#include <cstdint>
+#include <array>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <SFML/Graphics.hpp>
 
@@ -18,17 +23,103 @@ struct Position {
     }
 };
 
-// Grid cell types
-enum class CellType {
+// Grid cell types, one byte per cell. Every type but Wall is walkable, at the
+// cost the grid's terrain cost table gives it.
+enum class CellType : std::uint8_t {
     Empty = 0,    // Walkable
-    Wall = 1      // Blocked/obstacle
+    Wall = 1,     // Blocked/obstacle
+    Road = 2,     // Walkable, cheap
+    Mud = 3,      // Walkable, slow
+    Water = 4     // Walkable, slowest
 };
 
+constexpr int kCellTypeCount = 5;
+
+// Moves a search may take from a cell
+enum class Connectivity : std::uint8_t {
+    Four = 4,     // Cardinal moves only
+    Eight = 8     // Cardinal and diagonal moves
+};
+
+// When a diagonal move may pass between the two cardinal cells it touches
+enum class CornerCutting : std::uint8_t {
+    Allow,        // Always, even between two walls
+    NoSqueeze,    // Unless both cells are walls
+    Forbid        // Only if both cells are walkable (MovingAI rules)
+};
+
+// Straight walk between two cells, one move at a time: a 4-connected walk through the
+// cells the segment crosses, or a Bresenham line of cardinal and diagonal moves.
+// Walking the same segment always visits the same cells, so a clear line of sight
+// (Grid::hasLineOfSight) can be followed step by step.
+class GridLine {
+public:
+    GridLine() : GridLine(Position(0, 0), Position(0, 0), Connectivity::Eight) {}
+    GridLine(const Position& from, const Position& to, Connectivity connectivity);
+    
+    bool done() const { return current_ == to_; }
+    const Position& current() const { return current_; }
+    
+    // Move to the next cell and return it; only valid while !done()
+    const Position& next();
+
+private:
+    Position current_, to_;
+    Connectivity connectivity_;
+    int nx_, ny_;     // Cells to cover along each axis
+    int sx_, sy_;     // Direction of each axis
+    int ix_, iy_;     // Cells covered so far (4-connected walk)
+    int error_;       // Bresenham error term (8-connected walk)
+};
+
+// One cell modification made through Grid::setCell
+struct CellChange {
+    Position position;
+    CellType oldType;  // Type before the first change in the batch
+    CellType newType;  // Type after the last change in the batch
+};
+
+// Changes delivered together to grid subscribers
+struct GridChangeBatch {
+    std::uint64_t fromRevision;      // Grid revision before the batch
+    std::uint64_t toRevision;        // Grid revision after the batch
+    std::uint64_t cellHash;          // Grid::getCellHash() after the batch
+    std::vector<CellChange> changes; // One entry per modified cell
+    std::vector<Position> blocks;    // Block coordinates touched by the batch
+};
+
+using GridChangeListener = std::function<void(const GridChangeBatch&)>;
+using GridSubscriptionId = std::uint32_t;
+
 class Grid {
 public:
+    // Side of the square regions used for dirty tracking
+    static constexpr int kBlockSize = 32;
+    
+    // Most neighbors a cell can have
+    static constexpr int kMaxNeighbors = 8;
+    
+    // Cost factor of a diagonal move: sqrt(2) in 1/1024 fixed point, so sums of
+    // moves stay exact in float and equal-cost paths compare equal
+    static constexpr float kDiagonalCost = 1448.0f / 1024.0f;
+    
     // Constructor - create grid with given dimensions
     Grid(int width, int height);
     
+    // Copies are copy-on-write snapshots: cells are shared per block and only
+    // the blocks edited afterwards get duplicated. Subscribers are not copied.
+    Grid(const Grid& other);
+    Grid& operator=(const Grid& other);
+    Grid(Grid&& other) = default;
+    Grid& operator=(Grid&& other) = default;
+    
+    // Immutable view for searches running while this grid keeps being edited.
+    // Call from the thread that edits the grid; the snapshot may then be used anywhere.
+    Grid snapshot() const { return Grid(*this); }
+    
+    // True if both grids still share the storage of the given block
+    bool sharesBlockWith(const Grid& other, int blockX, int blockY) const;
+    
     // Basic grid properties
     int getWidth() const { return width_; }
     int getHeight() const { return height_; }
@@ -39,14 +130,85 @@ public:
     bool isInBounds(const Position& pos) const;
     bool isInBounds(int x, int y) const;
     
+    // True if to is one of from's neighbors under the movement rules
+    bool canMove(const Position& from, const Position& to) const;
+    
+    // True if the GridLine from from to to only takes moves allowed by the movement rules.
+    // When cost is given it receives the cost of walking the line.
+    bool hasLineOfSight(const Position& from, const Position& to, float* cost = nullptr) const;
+    
     // Modify grid
     void setCell(const Position& pos, CellType type);
     void setCell(int x, int y, CellType type);
     CellType getCell(const Position& pos) const;
     CellType getCell(int x, int y) const;
     
+    // Terrain costs - the cost of entering a cell of the given type. Walls cannot be
+    // entered; other costs must be positive. Changing a cost flushes pending changes
+    // and bumps the revision.
+    bool setTerrainCost(CellType type, float cost);
+    float getTerrainCost(CellType type) const { return terrainCosts_[static_cast<int>(type)]; }
+    
+    // Cost of entering a walkable cell (no bounds check)
+    float getMoveCost(const Position& pos) const { return terrainCosts_[static_cast<int>(cellAt(pos.x, pos.y))]; }
+    
+    // Cost of moving between two neighbors: the terrain cost of to, scaled for diagonal moves
+    float getStepCost(const Position& from, const Position& to) const {
+        float cost = getMoveCost(to);
+        return from.x != to.x && from.y != to.y ? cost * kDiagonalCost : cost;
+    }
+    
+    // Cheapest walkable terrain present on the grid - scales the search heuristic
+    float getMinMoveCost() const { return minMoveCost_; }
+    // Cheapest walkable terrain in the cost table, present or not
+    float getMinTerrainCost() const;
+    // True when every walkable cell costs getMinMoveCost(), so searches can skip the lookup
+    bool hasUniformCosts() const { return uniformCosts_; }
+    size_t getCellCount(CellType type) const { return cellCounts_[static_cast<int>(type)]; }
+    
+    // Incremented every time setCell actually changes a cell
+    std::uint64_t getRevision() const { return revision_; }
+    
+    // Hash of the cell types, kept up to date by setCell. Revisions only count edits, so
+    // precomputed structures compare this to tell their grid from another of the same size.
+    std::uint64_t getCellHash() const { return cellHash_; }
+    
+    // Dirty regions - blocks stay dirty until cleared by their consumer
+    int getBlocksX() const { return blocksX_; }
+    int getBlocksY() const { return blocksY_; }
+    bool isBlockDirty(int blockX, int blockY) const;
+    std::vector<Position> getDirtyBlocks() const;
+    void clearDirtyBlocks();
+    
+    // Change notification - changes are batched until flushChanges is called
+    GridSubscriptionId subscribe(GridChangeListener listener);
+    void unsubscribe(GridSubscriptionId id);
+    bool hasPendingChanges() const { return !pending_.changes.empty(); }
+    // Revision subscribers have last been brought to; behind getRevision() while changes are pending
+    std::uint64_t getFlushedRevision() const { return hasPendingChanges() ? pending_.fromRevision : revision_; }
+    void flushChanges();
+    
+    // Movement rules used by getNeighbors. Changing them flushes pending changes
+    // and bumps the revision.
+    void setMovement(Connectivity connectivity, CornerCutting cornerCutting = CornerCutting::Forbid);
+    Connectivity getConnectivity() const { return connectivity_; }
+    CornerCutting getCornerCutting() const { return cornerCutting_; }
+    
     // For A* pathfinding - get valid neighbors
     std::vector<Position> getNeighbors(const Position& pos) const;
+    // Same without allocating: writes up to kMaxNeighbors positions to out, returns their count
+    int getNeighbors(const Position& pos, Position* out) const;
+    
+    // Number (0 to kMaxNeighbors - 1) of the move between neighbors from -> to, row by row
+    // from the top left, and the cell a numbered move leads to
+    static int moveIndex(const Position& from, const Position& to) {
+        int index = (to.y - from.y + 1) * 3 + (to.x - from.x + 1);
+        return index > 4 ? index - 1 : index;
+    }
+    static Position moveTarget(const Position& from, int move) {
+        int index = move >= 4 ? move + 1 : move;
+        return Position(from.x + index % 3 - 1, from.y + index / 3 - 1);
+    }
     
     // Rendering
     void render(sf::RenderWindow& window, float tileSize) const;
@@ -55,6 +217,50 @@ public:
     void addTestObstacles();
 
 private:
+    // Cells of one kBlockSize x kBlockSize block, shared between snapshots, plus one bit
+    // per cell marking walls so walkability checks touch an eighth of the memory
+    struct Tile {
+        std::array<CellType, kBlockSize * kBlockSize> cells;
+        std::array<std::uint32_t, kBlockSize> wallRows;  // Bit x of row y set for walls
+    };
+    static_assert(kBlockSize == 32, "wallRows holds one 32-bit word per block row");
+    
     int width_, height_;
-    std::vector<std::vector<CellType>> cells_;
+    int blocksX_, blocksY_;
+    std::vector<std::shared_ptr<const Tile>> tiles_;
+    std::uint64_t revision_;
+    std::uint64_t cellHash_;
+    
+    // Terrain cost per cell type and how many cells of each type the grid holds
+    std::array<float, kCellTypeCount> terrainCosts_;
+    std::array<size_t, kCellTypeCount> cellCounts_;
+    float minMoveCost_;
+    bool uniformCosts_;
+    
+    Connectivity connectivity_;
+    CornerCutting cornerCutting_;
+    
+    CellType cellAt(int x, int y) const {
+        return tiles_[(y / kBlockSize) * blocksX_ + (x / kBlockSize)]
+            ->cells[(y % kBlockSize) * kBlockSize + (x % kBlockSize)];
+    }
+    bool wallAt(int x, int y) const {
+        return (tiles_[(y / kBlockSize) * blocksX_ + (x / kBlockSize)]
+            ->wallRows[y % kBlockSize] >> (x % kBlockSize)) & 1u;
+    }
+    Tile& writableTile(int blockIndex);
+    
+    // Dirty tracking
+    std::vector<std::uint8_t> dirtyBlocks_;
+    
+    // Subscribers and the batch being collected for them
+    std::vector<std::pair<GridSubscriptionId, GridChangeListener>> listeners_;
+    GridSubscriptionId nextSubscriptionId_;
+    GridChangeBatch pending_;
+    std::unordered_map<int, size_t> pendingIndex_;  // Cell index -> entry in pending_.changes
+    std::vector<std::uint8_t> pendingBlocks_;
+    
+    void recordChange(int x, int y, CellType oldType, CellType newType);
+    void updateCostSummary();
+    void movementChanged();
 };
\ No newline at end of file
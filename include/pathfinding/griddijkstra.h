@@ -0,0 +1,65 @@
+#pragma once
+#include "grid.h"
+#include <cstdint>
+#include <vector>
+
+// Single-source Dijkstra over a grid, for one-to-many distance queries.
+// Per-cell data is kept between searches and invalidated with a generation stamp,
+// so a search only pays for the cells it actually reaches.
+class GridDijkstra {
+public:
+    GridDijkstra();
+    
+    // Distance from source to every target (infinity when unreachable), in one search
+    // that stops as soon as all targets are settled. Returns the number of reachable targets.
+    size_t distancesTo(const Grid& grid, const Position& source,
+                       const std::vector<Position>& targets, std::vector<float>& distances);
+    
+    // Settle every cell within maxCost of source
+    void expandFrom(const Grid& grid, const Position& source, float maxCost);
+    
+    // Settle every cell reachable from source, also recording which first moves from
+    // source start shortest paths to each cell (see getFirstMoves)
+    void firstMovesFrom(const Grid& grid, const Position& source);
+    
+    // Distance of a cell settled by the last search, infinity otherwise
+    float getDistance(const Position& pos) const;
+    
+    // After firstMovesFrom: bit m set if some shortest path from the source to pos starts
+    // with move m (Grid::moveIndex). Zero for the source and for unreached cells.
+    std::uint8_t getFirstMoves(const Position& pos) const;
+    
+    // Number of cells settled by the last search
+    size_t getLastExpansions() const { return lastExpansions_; }
+
+private:
+    struct QueueEntry {
+        float cost;
+        int cell;
+        
+        bool operator>(const QueueEntry& other) const { return cost > other.cost; }
+    };
+    
+    // Start a new generation, resizing the per-cell data if the grid changed size
+    void begin(const Grid& grid);
+    
+    // Settle cells in cost order until maxCost is passed or pendingTargets reaches zero
+    void run(const Grid& grid, const Position& source, float maxCost, size_t pendingTargets,
+             bool firstMoves = false);
+    
+    // The search itself, with the terrain lookup compiled out when every cell costs the same
+    // and the first move bookkeeping compiled out when not asked for
+    template <bool UniformCosts, bool FirstMoves>
+    void runKernel(const Grid& grid, const Position& source, float maxCost, size_t pendingTargets);
+    
+    int width_, height_;
+    std::uint32_t generation_;
+    std::vector<float> distance_;
+    std::vector<std::uint32_t> reached_;   // Generation in which distance_ was last written
+    std::vector<std::uint32_t> settled_;   // Generation in which the cell was settled
+    std::vector<std::uint32_t> target_;    // Generation in which the cell was asked for
+    std::vector<std::uint8_t> firstMoves_; // Valid for reached cells of a firstMovesFrom search
+    bool firstMovesValid_;                 // The last search was a firstMovesFrom search
+    std::vector<QueueEntry> heap_;         // Min-heap with lazy deletion of stale entries
+    size_t lastExpansions_;
+};
@@ -1,13 +1,56 @@
 #pragma once
+#include "goalbounds.h"
 #include "grid.h"
 #include "stlastar.h"
 #include <cmath>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// Several acceptable goals for one search; the search stops at whichever is reached first,
+// which is the nearest one since the heuristic stays admissible
+class GoalSet {
+public:
+    // Above this many goals the heuristic uses the bounding box instead of every goal
+    static constexpr size_t kMaxExactGoals = 64;
+    
+    GoalSet() : minX_(0), minY_(0), maxX_(-1), maxY_(-1) {}
+    explicit GoalSet(const std::vector<Position>& goals);
+    
+    void add(const Position& goal);
+    void clear();
+    
+    bool contains(const Position& pos) const;
+    bool empty() const { return goals_.empty(); }
+    size_t size() const { return goals_.size(); }
+    const std::vector<Position>& getGoals() const { return goals_; }
+    
+    // Lower bound on the distance from pos to the nearest goal: the minimum over all goals
+    // for small sets, the distance to the goals' bounding box for large ones
+    float estimate(const Position& pos, Connectivity connectivity = Connectivity::Four) const;
+
+private:
+    static std::uint64_t key(const Position& pos) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(pos.x)) << 32) |
+               static_cast<std::uint32_t>(pos.y);
+    }
+    
+    std::vector<Position> goals_;
+    std::unordered_set<std::uint64_t> keys_;
+    int minX_, minY_, maxX_, maxY_;  // Bounding box of the goals
+};
 
 // GridState represents a position on the grid for A* pathfinding
 class GridState : public AStarState<GridState> {
 public:
     Position position;
     const Grid* grid;  // Reference to the grid for validation
+    const GoalSet* goals;  // Set on the goal state to accept any of several goals (not owned)
+    const GoalBounds* goalBounds;  // Set on the goal state to prune moves away from it (not owned)
+    
+    // With the default terrain costs, 4-connected step costs and the heuristic are multiples
+    // of a half, so searches can use a bucket queue
+    static constexpr float kCostQuantum = 0.5f;
     
     // Constructors
     GridState();
@@ -17,6 +60,10 @@ public:
     // Assignment operator
     GridState& operator=(const GridState& other);
 
+    // Heuristic between two cells at unit terrain cost
+    static float estimate(const Position& from, const Position& to,
+                          Connectivity connectivity = Connectivity::Four);
+    
     // A* interface implementations
     float GoalDistanceEstimate(GridState& nodeGoal) override;
     bool IsGoal(GridState& nodeGoal) override;
@@ -0,0 +1,54 @@
+#pragma once
+#include "searchengine.h"
+#include <cstdint>
+#include <vector>
+
+// Iterative deepening A*: depth-first searches bounded by an f threshold that rises to the
+// smallest f that went over it. Only the current branch is kept, plus a transposition table
+// of fixed size (from the memory budget) that prunes cells already reached as cheaply in the
+// same iteration. When the table is too small entries are overwritten, which costs repeated
+// work but never correctness.
+class IDAStarSearch : public SearchEngine {
+public:
+    explicit IDAStarSearch(size_t memoryBudget = kDefaultMemoryBudget);
+    
+    bool findPath(const Grid& grid, const Position& start, const Position& goal,
+                  std::vector<Position>& path) override;
+    
+    size_t getMemoryBytes() const override {
+        return table_.capacity() * sizeof(Entry) + stack_.capacity() * sizeof(Frame);
+    }
+    
+    // Give up after this many expansions (zero means no limit); counts as out of memory
+    void setMaxExpansions(size_t maxExpansions) { maxExpansions_ = maxExpansions; }
+    
+    size_t getLastIterations() const { return lastIterations_; }
+
+private:
+    struct Entry {
+        std::uint32_t stamp;   // Iteration the entry was written in
+        int cell;
+        float g;
+    };
+    
+    // One node of the current branch and the neighbors still to try
+    struct Frame {
+        Position position;
+        float g;
+        int count;
+        int next;
+        Position neighbors[Grid::kMaxNeighbors];
+    };
+    
+    // True if cell was already reached this iteration for at most g; records it otherwise
+    bool seenCheaper(int cell, float g);
+    
+    void pushFrame(const Grid& grid, const Position& position, float g);
+    
+    std::vector<Entry> table_;
+    int shift_;   // Hashes keep their top log2(table size) bits
+    std::vector<Frame> stack_;
+    std::uint32_t stamp_;
+    size_t maxExpansions_;
+    size_t lastIterations_;
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// Severity of a log message
+enum class LogLevel {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4,
+    Off = 5
+};
+
+// Messages below this level are removed at compile time (arguments are not evaluated)
+#ifndef PATHFINDING_LOG_MIN_LEVEL
+#define PATHFINDING_LOG_MIN_LEVEL 0
+#endif
+
+// Numeric arguments a single message can carry
+constexpr size_t kMaxLogArgs = 4;
+
+// One message: the format is kept as a pointer, so it must be a string literal.
+// "{}" placeholders are replaced by the arguments when the record is formatted.
+struct LogRecord {
+    LogLevel level;
+    const char* format;
+    double args[kMaxLogArgs];
+    std::uint8_t argCount;
+};
+
+// Receives every message that passes the level filters
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const LogRecord& record) = 0;
+};
+
+// Formats and writes each message straight away (one line each, no flush)
+class ConsoleLogSink : public LogSink {
+public:
+    explicit ConsoleLogSink(std::ostream& out);
+    void write(const LogRecord& record) override;
+
+private:
+    std::ostream& out_;
+    std::mutex mutex_;
+};
+
+// Bounded lock-free queue of records for any number of producer and consumer threads.
+// Producers only copy the record; formatting happens in drain. Messages are dropped
+// (and counted) when the buffer is full.
+class RingBufferLogSink : public LogSink {
+public:
+    // Capacity is rounded up to a power of two
+    explicit RingBufferLogSink(size_t capacity = 4096);
+
+    void write(const LogRecord& record) override;
+
+    // Take the oldest record, returns false if the buffer is empty
+    bool pop(LogRecord& record);
+
+    // Format every queued record into out, returns how many were written
+    size_t drain(std::ostream& out);
+
+    size_t getCapacity() const { return mask_ + 1; }
+    size_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    alignas(64) std::atomic<size_t> dequeuePos_;
+    std::atomic<size_t> dropped_;
+};
+
+// Global sink (not owned); nullptr, the default, discards everything
+void setLogSink(LogSink* sink);
+LogSink* getLogSink();
+
+// Runtime minimum level, Info by default
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+
+// True if a message of this level would reach a sink
+bool logEnabled(LogLevel level);
+
+// Text of a record, e.g. "[warning] Start position (3, 4) is not walkable"
+std::string formatLogRecord(const LogRecord& record);
+const char* logLevelName(LogLevel level);
+
+void logWriteRecord(const LogRecord& record);
+
+template <typename... Args>
+void logWrite(LogLevel level, const char* format, Args... args) {
+    static_assert(sizeof...(Args) <= kMaxLogArgs, "Too many log arguments");
+    static_assert((std::is_arithmetic<Args>::value && ...), "Log arguments must be numbers");
+
+    LogRecord record{level, format, {static_cast<double>(args)...}, static_cast<std::uint8_t>(sizeof...(Args))};
+    logWriteRecord(record);
+}
+
+// PF_LOG(LogLevel::Info, "Path found in {} steps", steps)
+#define PF_LOG(level, ...)                                                                   \
+    do {                                                                                     \
+        if (static_cast<int>(level) >= PATHFINDING_LOG_MIN_LEVEL && logEnabled(level)) {     \
+            logWrite(level, __VA_ARGS__);                                                    \
+        }                                                                                    \
+    } while (0)
+
+#define PF_LOG_TRACE(...) PF_LOG(LogLevel::Trace, __VA_ARGS__)
+#define PF_LOG_DEBUG(...) PF_LOG(LogLevel::Debug, __VA_ARGS__)
+#define PF_LOG_INFO(...) PF_LOG(LogLevel::Info, __VA_ARGS__)
+#define PF_LOG_WARNING(...) PF_LOG(LogLevel::Warning, __VA_ARGS__)
+#define PF_LOG_ERROR(...) PF_LOG(LogLevel::Error, __VA_ARGS__)
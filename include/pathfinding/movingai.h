@@ -0,0 +1,28 @@
+#pragma once
+#include "grid.h"
+#include <istream>
+#include <string>
+#include <vector>
+
+// Loaders for the MovingAI benchmark formats (https://movingai.com/benchmarks/formats.html)
+
+// One query from a .scen file
+struct MovingAIScenario {
+    int bucket;             // Scenarios of similar length share a bucket
+    std::string mapName;    // Map file the scenario was made for
+    int mapWidth;
+    int mapHeight;
+    Position start;
+    Position goal;
+    double optimalLength;   // Octile distance of the optimal 8-connected path
+};
+
+// Read a .map file into grid ('.', 'G' and 'S' are walkable, everything else is a wall)
+// Returns false and leaves grid untouched if the file is malformed
+bool loadMovingAIMap(std::istream& in, Grid& grid);
+bool loadMovingAIMap(const std::string& path, Grid& grid);
+
+// Read every scenario of a .scen file (version 1 or the older unversioned layout)
+// Returns false on a malformed line; scenarios read before it are kept
+bool loadMovingAIScenarios(std::istream& in, std::vector<MovingAIScenario>& scenarios);
+bool loadMovingAIScenarios(const std::string& path, std::vector<MovingAIScenario>& scenarios);
@@ -0,0 +1,199 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// How AStarSearch orders its open list
+enum class OpenListPolicy {
+    Heap,     // Binary heap on f, for any costs
+    Buckets   // Bucket queue on f / quantum, for states with quantized costs
+};
+
+// Open list of AStarSearch. Either a binary heap of Node* ordered by Compare, or a bucket
+// queue with one bucket per multiple of the cost quantum: push, pop and update are then
+// O(1) and nodes with equal f come out last in, first out. If some f is not a multiple of
+// the quantum (weighted heuristics) the lowest bucket is scanned so the order stays exact.
+// Node needs float f and the size_t fields openKey and openIndex, which belong to this list.
+template <class Node, class Compare>
+class OpenList {
+public:
+    OpenList()
+        : policy_(OpenListPolicy::Heap), quantum_(0.0f), size_(0), minKey_(0), maxKey_(0),
+          exact_(true) {}
+
+    // Only valid while the list is empty
+    void setPolicy(OpenListPolicy policy, float quantum) {
+        policy_ = policy;
+        quantum_ = quantum;
+    }
+
+    OpenListPolicy getPolicy() const { return policy_; }
+
+    bool empty() const { return size() == 0; }
+    size_t size() const { return policy_ == OpenListPolicy::Heap ? heap_.size() : size_; }
+
+    void push(Node* node) {
+        if (policy_ == OpenListPolicy::Heap) {
+            heap_.push_back(node);
+            std::push_heap(heap_.begin(), heap_.end(), Compare());
+            return;
+        }
+
+        size_t key = static_cast<size_t>(node->f / quantum_);
+        if (key >= buckets_.size()) {
+            buckets_.resize(key + 1);
+        }
+        if (size_ == 0 || key < minKey_) {
+            minKey_ = key;
+        }
+        if (size_ == 0 || key > maxKey_) {
+            maxKey_ = key;
+        }
+        if (static_cast<float>(key) * quantum_ != node->f) {
+            exact_ = false;
+        }
+
+        std::vector<Node*>& bucket = buckets_[key];
+        node->openKey = key;
+        node->openIndex = bucket.size();
+        bucket.push_back(node);
+        size_++;
+    }
+
+    // Node with the lowest f
+    Node* top() {
+        if (policy_ == OpenListPolicy::Heap) {
+            return heap_.front();
+        }
+
+        while (buckets_[minKey_].empty()) {
+            minKey_++;
+        }
+
+        std::vector<Node*>& bucket = buckets_[minKey_];
+        if (exact_) {
+            return bucket.back();
+        }
+
+        Node* best = bucket.back();
+        for (Node* node : bucket) {
+            if (node->f < best->f) {
+                best = node;
+            }
+        }
+        return best;
+    }
+
+    Node* pop() {
+        if (policy_ == OpenListPolicy::Heap) {
+            std::pop_heap(heap_.begin(), heap_.end(), Compare());
+            Node* node = heap_.back();
+            heap_.pop_back();
+            return node;
+        }
+
+        Node* node = top();
+        remove(node);
+        return node;
+    }
+
+    // Restore the order after the f of a node on the list went down
+    void update(Node* node) {
+        if (policy_ == OpenListPolicy::Heap) {
+            // A prefix of a heap is a heap, so sifting the node up within it is enough
+            typename std::vector<Node*>::iterator position = std::find(heap_.begin(), heap_.end(), node);
+            std::push_heap(heap_.begin(), position + 1, Compare());
+            return;
+        }
+
+        remove(node);
+        push(node);
+    }
+
+    void erase(Node* node) {
+        if (policy_ == OpenListPolicy::Heap) {
+            typename std::vector<Node*>::iterator position = std::find(heap_.begin(), heap_.end(), node);
+            if (position != heap_.end()) {
+                heap_.erase(position);
+                std::make_heap(heap_.begin(), heap_.end(), Compare());
+            }
+            return;
+        }
+
+        if (node->openKey < buckets_.size() && node->openIndex < buckets_[node->openKey].size() &&
+            buckets_[node->openKey][node->openIndex] == node) {
+            remove(node);
+        }
+    }
+
+    // Restore the order after the f of every node changed
+    void rebuild() {
+        if (policy_ == OpenListPolicy::Heap) {
+            std::make_heap(heap_.begin(), heap_.end(), Compare());
+            return;
+        }
+
+        scratch_.clear();
+        forEach([this](Node* node) { scratch_.push_back(node); });
+        clear();
+        for (Node* node : scratch_) {
+            push(node);
+        }
+    }
+
+    template <class Visit>
+    void forEach(Visit visit) {
+        if (policy_ == OpenListPolicy::Heap) {
+            for (Node* node : heap_) {
+                visit(node);
+            }
+            return;
+        }
+
+        if (size_ == 0) {
+            return;
+        }
+        for (size_t key = minKey_; key <= maxKey_; key++) {
+            for (Node* node : buckets_[key]) {
+                visit(node);
+            }
+        }
+    }
+
+    // Empty the list, keeping its memory for the next search
+    void clear() {
+        heap_.clear();
+        if (size_ > 0) {
+            for (size_t key = minKey_; key <= maxKey_; key++) {
+                buckets_[key].clear();
+            }
+        }
+        size_ = 0;
+        minKey_ = 0;
+        maxKey_ = 0;
+        exact_ = true;
+    }
+
+private:
+    // Swap the last node of the bucket into the gap
+    void remove(Node* node) {
+        std::vector<Node*>& bucket = buckets_[node->openKey];
+        Node* last = bucket.back();
+        bucket[node->openIndex] = last;
+        last->openIndex = node->openIndex;
+        bucket.pop_back();
+        size_--;
+    }
+
+    OpenListPolicy policy_;
+    float quantum_;
+
+    std::vector<Node*> heap_;
+
+    std::vector<std::vector<Node*>> buckets_;
+    size_t size_;
+    size_t minKey_;   // No bucket below this one holds nodes
+    size_t maxKey_;   // Nor above this one
+    bool exact_;      // Every f pushed since the last clear was a multiple of the quantum
+    std::vector<Node*> scratch_;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include "grid.h"
+#include <array>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Counters describing how well the cache is doing
+struct PathCacheStats {
+    size_t hits = 0;           // Exact (start, goal) matches
+    size_t suffixHits = 0;     // Served from the tail of a cached path
+    size_t misses = 0;
+    size_t evictions = 0;      // Entries dropped to respect the memory caps
+    size_t invalidations = 0;  // Entries dropped because the grid changed
+
+    float hitRate() const {
+        size_t lookups = hits + suffixHits + misses;
+        return lookups ? static_cast<float>(hits + suffixHits) / lookups : 0.0f;
+    }
+};
+
+// LRU cache of found paths keyed on (start, goal, grid revision and cell hash).
+// A lookup that misses can still be served from any cached path to the same goal
+// that passes through the start (sub-paths of shortest paths are shortest).
+// Cell edits reported through invalidateCell or onGridChanged only evict the paths they
+// can affect; edits that were not reported are detected through the grid revision and
+// clear the cache. Edits a subscribed cache is still waiting for only make lookups miss.
+// A grid of other size, movement rules, terrain costs or cells clears it too, so one cache
+// may serve several grids, just not at the same time.
+class PathCache {
+public:
+    // Constructor - caps on number of paths and total stored positions
+    explicit PathCache(size_t maxEntries = 256, size_t maxCells = 65536);
+
+    // Returns true and fills path/cost if the query can be answered from the cache
+    bool lookup(const Grid& grid, const Position& start, const Position& goal,
+                std::vector<Position>& path, float& cost);
+
+    // Remember a path found on the grid's current revision
+    void store(const Grid& grid, const Position& start, const Position& goal,
+               const std::vector<Position>& path, float cost);
+
+    // Report that pos of grid was just set to newType
+    void invalidateCell(const Grid& grid, const Position& pos, CellType newType);
+
+    // Grid subscriber entry point, e.g. grid.subscribe([&](auto& b) { cache.onGridChanged(b); })
+    void onGridChanged(const GridChangeBatch& batch);
+
+    void clear();
+
+    // Size and statistics
+    size_t size() const { return entries_.size(); }
+    size_t getCachedCells() const { return cachedCells_; }
+    std::uint64_t getRevision() const { return revision_; }
+    const PathCacheStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = PathCacheStats(); }
+
+private:
+    struct Entry {
+        Position start;
+        Position goal;
+        std::vector<Position> path;
+        float cost;
+        Position boundsMin;  // Bounding box of the path for quick rejection
+        Position boundsMax;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    struct PositionHash {
+        size_t operator()(const Position& pos) const {
+            return static_cast<size_t>(pos.x) * 73856093u ^ static_cast<size_t>(pos.y) * 19349663u;
+        }
+    };
+
+    struct EndpointsHash {
+        size_t operator()(const std::pair<Position, Position>& endpoints) const {
+            PositionHash hash;
+            return hash(endpoints.first) * 31 + hash(endpoints.second);
+        }
+    };
+
+    struct EndpointsEqual {
+        bool operator()(const std::pair<Position, Position>& a,
+                        const std::pair<Position, Position>& b) const {
+            return a.first == b.first && a.second == b.second;
+        }
+    };
+
+    bool syncRevision(const Grid& grid);
+    bool sameRules(const Grid& grid) const;
+    void adopt(const Grid& grid);
+    void evictAffected(const Position& pos, CellType newType);
+    bool containsCell(const Entry& entry, const Position& pos) const;
+    bool cutsCorner(const Entry& entry, const Position& pos) const;
+    void erase(EntryList::iterator entry);
+    void enforceCaps();
+
+    size_t maxEntries_;
+    size_t maxCells_;
+    size_t cachedCells_;
+    std::uint64_t revision_;
+    std::uint64_t cellHash_;  // Grid::getCellHash() at revision_
+    // Of the grid the entries were found on; changing them clears the cache
+    int width_, height_;
+    std::array<float, kCellTypeCount> terrainCosts_;
+    float minTerrainCost_;
+    Connectivity connectivity_;
+    CornerCutting cornerCutting_;
+
+    EntryList entries_;  // Most recently used first
+    std::unordered_map<std::pair<Position, Position>, EntryList::iterator, EndpointsHash, EndpointsEqual> index_;
+    std::unordered_map<Position, std::vector<EntryList::iterator>, PositionHash> byGoal_;
+
+    PathCacheStats stats_;
+};
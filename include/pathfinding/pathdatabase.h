@@ -0,0 +1,89 @@
+#pragma once
+#include "grid.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Compressed path database: the first move of a shortest path between every pair of
+// walkable cells, for static maps. Cells are numbered in depth-first order so nearby
+// targets mostly share a first move, and each source stores its row of first moves as
+// runs over that numbering. A next-step query is a binary search in one short row.
+//
+// The tables are one flat block of 32-bit words (native byte order) that is also the file
+// format, so a saved database can be memory-mapped and used in place with attach().
+// Building takes one Dijkstra search per walkable cell and is meant to be done offline.
+class PathDatabase {
+public:
+    PathDatabase();
+    PathDatabase(const PathDatabase&) = delete;
+    PathDatabase& operator=(const PathDatabase&) = delete;
+
+    // Precompute every first move of grid, spread over threads (0 picks one per core).
+    // Returns false and leaves the database empty if the grid has too many cells.
+    bool build(const Grid& grid, unsigned int threads = 0);
+
+    // Write the tables, or read tables written by save(). load() copies them into memory
+    // owned by the database; attach() uses data in place (e.g. a mapped file), which must
+    // stay valid and 4-byte aligned for as long as the database uses it.
+    // Returns false and leaves the database empty on a malformed or truncated block.
+    bool save(std::ostream& out) const;
+    bool save(const std::string& path) const;
+    bool load(std::istream& in);
+    bool load(const std::string& path);
+    bool attach(const void* data, size_t bytes);
+
+    bool empty() const { return data_ == nullptr; }
+
+    // True if the tables were built from a grid with the same cells (by Grid::getCellHash()),
+    // movement rules and terrain costs
+    bool isValidFor(const Grid& grid) const;
+
+    // Next cell of a shortest path from -> to. Returns false if to cannot be reached from
+    // from, or if from == to.
+    bool nextStep(const Position& from, const Position& to, Position& next) const;
+
+    // Whole shortest path from -> to, both included, by repeated next-step queries
+    bool getPath(const Position& from, const Position& to, std::vector<Position>& path) const;
+
+    // Size of the tables (as saved)
+    size_t getMemoryBytes() const { return size_ * sizeof(std::uint32_t); }
+    size_t getRunCount() const { return empty() ? 0 : header_.runCount; }
+
+private:
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t width, height;
+        std::uint32_t connectivity, cornerCutting;
+        float terrainCosts[kCellTypeCount];
+        std::uint32_t cellHashLow, cellHashHigh;
+        std::uint32_t walkableCount;
+        std::uint32_t runCount;
+    };
+
+    static constexpr std::uint32_t kMagic = 0x44504650;  // "PFPD"
+    static constexpr std::uint32_t kVersion = 2;  // 2: cells hashed by Grid::getCellHash()
+    static constexpr std::uint32_t kNoCell = 0xffffffff;
+    static constexpr size_t kHeaderWords = sizeof(Header) / sizeof(std::uint32_t);
+    static constexpr std::uint32_t kMaxWalkable = 1u << 29;  // Numbers keep 3 bits for the move
+
+    // Depth-first number of a cell, kNoCell for walls and cells off the grid
+    std::uint32_t numberOf(const Position& pos) const;
+
+    // Point the table views into data_, after checking the block is consistent
+    bool bind();
+
+    void clear();
+
+    Header header_;                       // Copy of the block's header
+    std::vector<std::uint32_t> storage_;  // The block, when owned
+    const std::uint32_t* data_;           // The block: header, then the tables below
+    size_t size_;                         // In words
+
+    const std::uint32_t* order_;       // Depth-first number of every cell, kNoCell for walls
+    const std::uint32_t* component_;   // Connected component, by number
+    const std::uint32_t* offsets_;     // First run of every number, plus one past the last
+    const std::uint32_t* runs_;        // First number of the run << 3 | move (Grid::moveIndex)
+};
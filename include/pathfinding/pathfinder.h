@@ -1,12 +1,38 @@
 #pragma once
 #include "grid.h"
+#include "contractionhierarchy.h"
+#include "goalbounds.h"
+#include "griddijkstra.h"
 #include "gridstate.h"
+#include "pathcache.h"
+#include "pathdatabase.h"
+#include "pathresult.h"
+#include "searchengine.h"
+#include "searchstats.h"
+#include "subgoalgraph.h"
+#include "symmetryreduction.h"
 #include "stlastar.h"
+#include <memory>
 #include <vector>
 
+// Limits of a bounded search; zero means no limit
+struct SearchBudget {
+    unsigned int maxExpansions = 0;
+    double maxMicros = 0.0;
+};
+
+// Settings of an anytime search (ARA*)
+struct AnytimeOptions {
+    float initialWeight = 3.0f;  // Heuristic weight of the first, quickest solution
+    float weightStep = 0.5f;     // Weight decrease after each solution, down to 1
+    double maxMicros = 0.0;      // Time to keep improving; zero runs until the path is optimal
+};
+
 class Pathfinder {
 public:
     Pathfinder();
+    // Constructor - maxNodes caps the nodes a single search may allocate
+    explicit Pathfinder(int maxNodes);
     ~Pathfinder();
     
     // Find path from start to goal position using A* algorithm
@@ -14,14 +40,128 @@ public:
     bool findPath(const Grid& grid, const Position& start, const Position& goal, 
                   std::vector<Position>& path);
     
+    // Same search, filling result's buffer in place (its capacity is reused between calls)
+    bool findPath(const Grid& grid, const Position& start, const Position& goal,
+                  PathResult& result);
+    
+    // Search within a budget. If the goal is not reached in time, or cannot be reached at
+    // all, path leads to the explored cell closest to the goal and isLastPathPartial() is
+    // true, so agents can start moving right away. Returns false only when no path at
+    // all could be produced (invalid start or goal out of bounds, out of memory).
+    bool findPathBounded(const Grid& grid, const Position& start, const Position& goal,
+                         const SearchBudget& budget, std::vector<Position>& path);
+    
+    // Anytime search: a first path found with a high heuristic weight, then improved while
+    // time remains by reusing the search so far with lower weights. The first path is
+    // always completed, even past the time limit.
+    bool findPathAnytime(const Grid& grid, const Position& start, const Position& goal,
+                         const AnytimeOptions& options, std::vector<Position>& path);
+    
+    // Heuristic weight w of the A* searches (f = g + w * h). Above 1 searches expand
+    // fewer nodes and paths cost at most w times the optimum.
+    void setHeuristicWeight(float weight) { astarsearch_.SetHeuristicWeight(weight); }
+    float getHeuristicWeight() const { return astarsearch_.GetHeuristicWeight(); }
+    
+    // Ordering of the open list: a bucket queue by default, since grid costs are integral
+    void setOpenListPolicy(OpenListPolicy policy) { astarsearch_.SetOpenListPolicy(policy); }
+    OpenListPolicy getOpenListPolicy() const { return astarsearch_.GetOpenListPolicy(); }
+    
+    // Algorithm behind findPath. Fringe and IDAStar keep their memory within memoryBudget
+    // bytes however large the map, at the price of slower searches; the other searches
+    // always use A*.
+    void setSearchAlgorithm(SearchAlgorithm algorithm,
+                            size_t memoryBudget = SearchEngine::kDefaultMemoryBudget);
+    SearchAlgorithm getSearchAlgorithm() const { return algorithm_; }
+    
+    // Guaranteed bound on last path cost / optimal cost (1 for optimal paths)
+    float getLastSuboptimalityBound() const { return lastSuboptimalityBound_; }
+    
+    // True if the last path ends short of its goal (findPathBounded only)
+    bool isLastPathPartial() const { return lastPathPartial_; }
+    
+    // Path to whichever target is closest, found in a single search with every target
+    // as a goal. The reached target is path.back(); unwalkable targets are ignored.
+    bool findPathToNearest(const Grid& grid, const Position& start,
+                           const std::vector<Position>& targets, std::vector<Position>& path);
+    
+    // Cost of the shortest path only: no path is extracted and the search nodes are
+    // released in bulk. distance is infinity when the goal cannot be reached.
+    bool findDistance(const Grid& grid, const Position& start, const Position& goal,
+                      float& distance);
+    
+    // Distances from start to every target in a single search (infinity for unreachable
+    // targets). Returns the number of reachable targets.
+    size_t findDistances(const Grid& grid, const Position& start,
+                         const std::vector<Position>& targets, std::vector<float>& distances);
+    
     // Get the cost of the last found path
     float getLastPathCost() const { return lastPathCost_; }
     
     // Get number of search steps for the last path
     int getLastSearchSteps() const { return lastSearchSteps_; }
+    
+    // Detailed counters and phase timings of the last search (zero on a cache hit
+    // or when built with PATHFINDING_SEARCH_STATS=0)
+    const SearchStats& getLastSearchStats() const { return lastSearchStats_; }
+    
+    // Optional cache consulted before searching (not owned, may be shared)
+    void setPathCache(PathCache* cache) { pathCache_ = cache; }
+    PathCache* getPathCache() const { return pathCache_; }
+    
+    // Optional path database answering findPath without a search while it matches the
+    // grid (not owned, may be shared)
+    void setPathDatabase(const PathDatabase* database) { pathDatabase_ = database; }
+    const PathDatabase* getPathDatabase() const { return pathDatabase_; }
+    
+    // Optional goal bounding tables pruning the A* searches of findPath, findPathAnytime and
+    // findDistance (not owned, may be shared). Ignored while they do not match the grid.
+    void setGoalBounds(const GoalBounds* goalBounds) { goalBounds_ = goalBounds; }
+    const GoalBounds* getGoalBounds() const { return goalBounds_; }
+    
+    // Optional contraction hierarchy that findPath queries instead of searching while it
+    // matches the grid (not owned; keeps per-query scratch, so not shared between threads)
+    void setContractionHierarchy(ContractionHierarchy* hierarchy) { hierarchy_ = hierarchy; }
+    ContractionHierarchy* getContractionHierarchy() const { return hierarchy_; }
+    
+    // Optional subgoal graph that findPath searches instead of the grid while it matches
+    // the grid (not owned; keeps per-query scratch, so not shared between threads)
+    void setSubgoalGraph(SubgoalGraph* subgoalGraph) { subgoalGraph_ = subgoalGraph; }
+    SubgoalGraph* getSubgoalGraph() const { return subgoalGraph_; }
+    
+    // Optional rectangular symmetry reduction that findPath searches instead of the grid
+    // while it matches the grid (not owned; keeps its own search, so not shared between threads)
+    void setSymmetryReduction(SymmetryReduction* reduction) { symmetryReduction_ = reduction; }
+    SymmetryReduction* getSymmetryReduction() const { return symmetryReduction_; }
 
 private:
+    // Check start and goal before searching
+    bool validateEndpoints(const Grid& grid, const Position& start, const Position& goal) const;
+    
+    // Let the goal state carry the goal bounds if they describe grid
+    void attachGoalBounds(const Grid& grid, GridState& nodeEnd) const;
+    
+    // Search from nodeStart to nodeEnd and extract the path on success
+    bool searchPath(const Grid& grid, GridState& nodeStart, GridState& nodeEnd, std::vector<Position>& path,
+                    const SearchBudget& budget = SearchBudget());
+    
+    // Run the search set up on astarsearch_ to completion, recording steps and counters.
+    // A search that exceeds the budget is stopped at its best node.
+    unsigned int runSearch(const SearchBudget& budget = SearchBudget());
+    
     AStarSearch<GridState> astarsearch_;
+    GridDijkstra dijkstra_;
+    SearchAlgorithm algorithm_;
+    std::unique_ptr<SearchEngine> engine_;  // Null for AStar
+    GoalSet goalSet_;  // Targets of the last findPathToNearest, reused between calls
     float lastPathCost_;
     int lastSearchSteps_;
+    bool lastPathPartial_;
+    float lastSuboptimalityBound_;
+    SearchStats lastSearchStats_;
+    PathCache* pathCache_;
+    const GoalBounds* goalBounds_;
+    const PathDatabase* pathDatabase_;
+    ContractionHierarchy* hierarchy_;
+    SubgoalGraph* subgoalGraph_;
+    SymmetryReduction* symmetryReduction_;
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include "grid.h"
+#include "gridstate.h"
+#include "stlastar.h"
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Handle returned when a path request is submitted
+using PathRequestId = std::uint32_t;
+
+enum class PathRequestStatus {
+    Unknown = 0,    // Never submitted or result already taken
+    Pending,        // Waiting in the queue
+    Searching,      // Search in progress
+    Succeeded,      // Path ready
+    Failed          // No path (invalid endpoints, unreachable or out of memory)
+};
+
+// Central queue for pathfinding requests. Identical (start, goal) requests are
+// merged, the queue is ordered by urgency then by distance, and tick() spends
+// at most a fixed number of A* expansions so the search load is spread over frames.
+// The grid passed to tick() must stay alive while a search is in flight.
+class PathRequestScheduler {
+public:
+    explicit PathRequestScheduler(int expansionsPerTick = 500);
+    ~PathRequestScheduler();
+
+    // Queue a request; higher urgency is served first, ties go to shorter requests
+    PathRequestId submit(const Position& start, const Position& goal, int urgency = 0);
+
+    // Run queued searches until the expansion budget is spent
+    void tick(const Grid& grid);
+
+    // Results
+    PathRequestStatus getStatus(PathRequestId id) const;
+    bool takeResult(PathRequestId id, std::vector<Position>& path);  // Returns true if a path was found
+
+    // Withdraw one submit() of id, e.g. when the caller no longer wants the path. The request
+    // is dropped (its search stopped, its result freed) once no merged caller is left.
+    // Returns false if id is unknown.
+    bool cancel(PathRequestId id);
+
+    // Budget
+    void setExpansionsPerTick(int expansions) { expansionsPerTick_ = expansions; }
+    int getExpansionsPerTick() const { return expansionsPerTick_; }
+    int getLastTickExpansions() const { return lastTickExpansions_; }
+
+    // Queue statistics
+    size_t getQueuedCount() const { return queue_.size(); }
+    size_t getRequestCount() const { return requests_.size(); }  // Queued, searching or not yet taken
+    size_t getCompletedCount() const { return completedCount_; }
+    size_t getMergedCount() const { return mergedCount_; }
+
+    // Submit-to-completion latency percentile (0-100) in microseconds over recent requests
+    float getLatencyPercentile(float percentile) const;
+
+private:
+    struct Request {
+        Position start;
+        Position goal;
+        int urgency;
+        int distance;
+        std::uint64_t sequence;
+        int waiters;  // Number of submit() calls merged into this request
+        PathRequestStatus status;
+        std::chrono::steady_clock::time_point submitTime;
+        std::vector<Position> path;
+    };
+
+    // Ordering key of the priority queue
+    struct QueueKey {
+        int urgency;
+        int distance;
+        std::uint64_t sequence;
+        PathRequestId id;
+
+        bool operator<(const QueueKey& other) const;
+    };
+
+    struct EndpointsHash {
+        size_t operator()(const std::pair<Position, Position>& endpoints) const;
+    };
+
+    struct EndpointsEqual {
+        bool operator()(const std::pair<Position, Position>& a,
+                        const std::pair<Position, Position>& b) const {
+            return a.first == b.first && a.second == b.second;
+        }
+    };
+
+    bool startNextSearch(const Grid& grid);
+    void finishActiveSearch(unsigned int searchState);
+    void completeRequest(PathRequestId id, bool succeeded);
+
+    AStarSearch<GridState> astarsearch_;
+    int expansionsPerTick_;
+    int lastTickExpansions_;
+
+    std::unordered_map<PathRequestId, Request> requests_;
+    std::unordered_map<std::pair<Position, Position>, PathRequestId, EndpointsHash, EndpointsEqual> openRequests_;
+    std::set<QueueKey> queue_;
+    PathRequestId nextId_;
+    std::uint64_t nextSequence_;
+
+    bool searching_;
+    PathRequestId activeId_;
+
+    size_t completedCount_;
+    size_t mergedCount_;
+
+    // Ring buffer of recent latencies
+    std::vector<float> latencySamples_;
+    size_t latencyNext_;
+};
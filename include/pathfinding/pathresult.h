@@ -0,0 +1,67 @@
+#pragma once
+#include "grid.h"
+#include <cstdint>
+#include <vector>
+
+// Steps of a found path in one contiguous buffer. Steps are consumed by moving a cursor,
+// so nothing is shifted or reallocated while a path is followed. Moving a PathResult
+// hands over the buffer without copying.
+class PathResult {
+public:
+    PathResult() : cursor_(0) {}
+    explicit PathResult(std::vector<Position> steps) : steps_(std::move(steps)), cursor_(0) {}
+
+    // Remaining steps (from the cursor on)
+    size_t size() const { return steps_.size() - cursor_; }
+    bool empty() const { return cursor_ >= steps_.size(); }
+    const Position& operator[](size_t index) const { return steps_[cursor_ + index]; }
+    const Position& front() const { return steps_[cursor_]; }
+    const Position& back() const { return steps_.back(); }
+    const Position* begin() const { return steps_.data() + cursor_; }
+    const Position* end() const { return steps_.data() + steps_.size(); }
+
+    // Consume steps from the front
+    void advance(size_t count = 1);
+
+    // Whole path including consumed steps
+    const std::vector<Position>& getSteps() const { return steps_; }
+    size_t getCursor() const { return cursor_; }
+
+    // Drop every step but keep the buffer for the next path
+    void clear();
+
+    // Buffer to fill with a new path; resets the cursor
+    std::vector<Position>& resetSteps();
+
+private:
+    std::vector<Position> steps_;
+    size_t cursor_;
+};
+
+// A path stored as runs of moves in one of the 8 directions, one byte per run of up to
+// 32 steps. Straight corridors shrink to a few bytes; meant for paths kept around for long.
+class CompressedPath {
+public:
+    CompressedPath() : start_(0, 0), length_(0) {}
+
+    // Compress a sequence of neighbouring positions (4 or 8-connected)
+    // Returns false and leaves the path empty if two consecutive positions are not neighbours
+    bool assign(const Position* begin, const Position* end);
+    bool assign(const PathResult& path) { return assign(path.begin(), path.end()); }
+
+    // Expand back into positions
+    PathResult decompress() const;
+
+    size_t size() const { return length_; }
+    bool empty() const { return length_ == 0; }
+    const Position& getStart() const { return start_; }
+    size_t getRunCount() const { return runs_.size(); }
+    size_t getMemoryBytes() const { return sizeof(*this) + runs_.capacity(); }
+
+private:
+    static constexpr int kMaxRunLength = 32;
+
+    Position start_;
+    size_t length_;                    // Number of positions including the start
+    std::vector<std::uint8_t> runs_;   // Direction in the top 3 bits, run length - 1 in the low 5
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include "grid.h"
+#include <vector>
+
+// String pulling: replace a path of neighboring cells by the waypoints where it has to
+// turn. Each segment between waypoints is a clear line of sight (Grid::hasLineOfSight)
+// that costs no more than the part of the path it replaces, so following the segments
+// with GridLine is never dearer than the original path.
+// Returns the number of waypoints, including both ends.
+size_t smoothPath(const Grid& grid, const std::vector<Position>& path, std::vector<Position>& waypoints);
+
+// Cells visited walking the straight segments between waypoints, the first waypoint included
+void expandWaypoints(const std::vector<Position>& waypoints, Connectivity connectivity,
+                     std::vector<Position>& path);
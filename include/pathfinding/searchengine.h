@@ -0,0 +1,64 @@
+#pragma once
+#include "grid.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Search algorithm used by Pathfinder::findPath
+enum class SearchAlgorithm {
+    AStar,      // AStarSearch: memory grows with the explored area
+    Fringe,     // FringeSearch: fixed node table sized by the memory budget
+    IDAStar     // IDAStarSearch: fixed transposition table sized by the memory budget
+};
+
+// A grid search that keeps its memory within a budget fixed at construction,
+// whatever the size of the map
+class SearchEngine {
+public:
+    // Memory budget used when none is given
+    static constexpr size_t kDefaultMemoryBudget = 16u << 20;
+    
+    virtual ~SearchEngine() = default;
+    
+    // Path from start to goal, both walkable cells. Returns false when the goal cannot be
+    // reached or the search needed more than its budget (isLastOutOfMemory()).
+    virtual bool findPath(const Grid& grid, const Position& start, const Position& goal,
+                          std::vector<Position>& path) = 0;
+    
+    // Bytes currently held by the engine
+    virtual size_t getMemoryBytes() const = 0;
+    
+    // Results of the last search
+    float getLastPathCost() const { return lastPathCost_; }
+    size_t getLastExpansions() const { return lastExpansions_; }
+    bool isLastOutOfMemory() const { return lastOutOfMemory_; }
+
+protected:
+    SearchEngine() : lastPathCost_(0.0f), lastExpansions_(0), lastOutOfMemory_(false) {}
+    
+    // Largest power of two number of entries of entryBytes that fits the budget (at least 4)
+    static size_t tableSizeFor(size_t memoryBudget, size_t entryBytes) {
+        size_t size = 4;
+        while (size <= memoryBudget / entryBytes / 2) {
+            size *= 2;
+        }
+        return size;
+    }
+    
+    // Fibonacci hashing: the top bits of the product index a table of 2^(64 - shift) entries
+    static size_t hashCell(int cell, int shift) {
+        return static_cast<size_t>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell)) *
+                                    0x9E3779B97F4A7C15ull) >> shift);
+    }
+    static int hashShift(size_t tableSize) {
+        int shift = 64;
+        for (size_t size = tableSize; size > 1; size /= 2) {
+            shift--;
+        }
+        return shift;
+    }
+    
+    float lastPathCost_;
+    size_t lastExpansions_;
+    bool lastOutOfMemory_;
+};
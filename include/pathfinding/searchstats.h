@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+
+// Statistics are collected unless the build sets PATHFINDING_SEARCH_STATS=0,
+// in which case the counters are compiled out of the search loop entirely
+#ifndef PATHFINDING_SEARCH_STATS
+#define PATHFINDING_SEARCH_STATS 1
+#endif
+
+#if PATHFINDING_SEARCH_STATS
+#define PF_SEARCH_STAT(statement) statement
+#else
+#define PF_SEARCH_STAT(statement)
+#endif
+
+// What a single search did, filled by AStarSearch and Pathfinder
+struct SearchStats {
+    size_t nodesExpanded = 0;      // Nodes whose successors were generated
+    size_t nodesGenerated = 0;     // Successors handed to AddSuccessor
+    size_t openDuplicates = 0;     // Successors dropped for a cheaper copy on the open list
+    size_t closedDuplicates = 0;   // Successors dropped for a cheaper copy on the closed list
+    size_t nodesReopened = 0;      // Closed nodes moved back to open with a lower g
+
+    size_t heapPushes = 0;
+    size_t heapPops = 0;
+    size_t heapRebuilds = 0;       // Open list reorders after an open node improved
+
+    size_t peakOpenSize = 0;
+    size_t peakClosedSize = 0;
+    size_t peakAllocatedNodes = 0; // Highest number of nodes live in the allocator
+
+    // Wall time per phase in microseconds (measured by Pathfinder)
+    double searchMicros = 0.0;
+    double extractionMicros = 0.0;
+    double teardownMicros = 0.0;
+};
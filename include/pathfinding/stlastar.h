@@ -34,11 +34,16 @@ given where due.
 // stl includes
 #include <algorithm>
 #include <cfloat>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
 // fast fixed size memory allocator, used for fast node memory management
 #include "fsa.h"
+#include "openlist.h"
+
+// optional per search counters, see searchstats.h
+#include "searchstats.h"
 
 // Fixed size memory allocator can be disabled to compare performance
 // Uses std new and delete instead if you turn it off
@@ -53,6 +58,19 @@ given where due.
 template <class T>
 class AStarState;
 
+// A state whose step costs and heuristic are always whole multiples of some quantum can
+// declare it as static constexpr float kCostQuantum; the search then defaults to a
+// bucket queue for its open list. States without it get 0 and a binary heap.
+template <class T, class = void>
+struct StateCostQuantum {
+    static constexpr float value = 0.0f;
+};
+
+template <class T>
+struct StateCostQuantum<T, std::void_t<decltype(T::kCostQuantum)>> {
+    static constexpr float value = T::kCostQuantum;
+};
+
 // The AStar search class. UserState is the users state space type
 template <class UserState>
 class AStarSearch {
@@ -79,7 +97,22 @@ class AStarSearch {
         float h;  // heuristic estimate of distance to goal
         float f;  // sum of cumulative cost of predecessors and self and heuristic
 
-        Node() : parent(0), child(0), g(0.0f), h(0.0f), f(0.0f) {}
+        unsigned int closedIteration;  // anytime search iteration in which it was last closed
+        bool incons;                   // on the anytime INCONS list
+
+        size_t openKey;    // position on the open list, managed by OpenList
+        size_t openIndex;
+
+        Node()
+            : parent(0),
+              child(0),
+              g(0.0f),
+              h(0.0f),
+              f(0.0f),
+              closedIteration(0),
+              incons(false),
+              openKey(0),
+              openIndex(0) {}
 
         bool operator==(const Node& otherNode) const {
             return this->m_UserState.IsSameState(otherNode.m_UserState);
@@ -102,22 +135,58 @@ class AStarSearch {
     // constructor just initialises private data
     AStarSearch()
         : m_State(SEARCH_STATE_NOT_INITIALISED),
+          m_Start(NULL),
+          m_Goal(NULL),
           m_CurrentSolutionNode(NULL),
 #if USE_FSA_MEMORY
           m_FixedSizeAllocator(1000),
 #endif
           m_AllocateNodeCount(0),
-          m_CancelRequest(false) {
+          m_CancelRequest(false),
+          m_CostOnly(false),
+          m_SolutionReleased(false),
+          m_SolutionCost(FLT_MAX),
+          m_PartialOnFailure(false),
+          m_PartialSolution(false),
+          m_BestNode(NULL),
+          m_HeuristicWeight(1.0f),
+          m_Weight(1.0f),
+          m_SolutionBound(1.0f),
+          m_Anytime(false),
+          m_WeightStep(0.5f),
+          m_Iteration(0),
+          m_Incumbent(NULL),
+          m_SolutionCount(0) {
+        SetOpenListPolicy(StateCostQuantum<UserState>::value > 0.0f ? OpenListPolicy::Buckets
+                                                                     : OpenListPolicy::Heap);
     }
 
     AStarSearch(int MaxNodes)
         : m_State(SEARCH_STATE_NOT_INITIALISED),
+          m_Start(NULL),
+          m_Goal(NULL),
           m_CurrentSolutionNode(NULL),
 #if USE_FSA_MEMORY
           m_FixedSizeAllocator(MaxNodes),
 #endif
           m_AllocateNodeCount(0),
-          m_CancelRequest(false) {
+          m_CancelRequest(false),
+          m_CostOnly(false),
+          m_SolutionReleased(false),
+          m_SolutionCost(FLT_MAX),
+          m_PartialOnFailure(false),
+          m_PartialSolution(false),
+          m_BestNode(NULL),
+          m_HeuristicWeight(1.0f),
+          m_Weight(1.0f),
+          m_SolutionBound(1.0f),
+          m_Anytime(false),
+          m_WeightStep(0.5f),
+          m_Iteration(0),
+          m_Incumbent(NULL),
+          m_SolutionCount(0) {
+        SetOpenListPolicy(StateCostQuantum<UserState>::value > 0.0f ? OpenListPolicy::Buckets
+                                                                     : OpenListPolicy::Heap);
     }
 
     // call at any time to cancel the search and free up all the memory
@@ -128,6 +197,16 @@ class AStarSearch {
     // Set Start and goal states
     void SetStartAndGoalStates(UserState& Start, UserState& Goal) {
         m_CancelRequest = false;
+        m_SolutionReleased = false;
+        m_SolutionCost = FLT_MAX;
+        m_PartialSolution = false;
+        m_BestNode = NULL;
+        m_Weight = m_HeuristicWeight;
+        m_SolutionBound = FLT_MAX;
+        m_Iteration = 0;
+        m_Incumbent = NULL;
+        m_SolutionCount = 0;
+        m_InconsList.clear();
 
         m_Start = AllocateNode();
         m_Goal = AllocateNode();
@@ -144,15 +223,17 @@ class AStarSearch {
 
         m_Start->g = 0;
         m_Start->h = m_Start->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
-        m_Start->f = m_Start->g + m_Start->h;
+        m_Start->f = m_Start->g + m_Weight * m_Start->h;
         m_Start->parent = 0;
 
         // Push the start node on the Open list
 
-        m_OpenList.push_back(m_Start);  // heap now unsorted
+        PushOpen(m_Start);
 
-        // Sort back element into heap
-        push_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
+        PF_SEARCH_STAT(m_Stats = SearchStats());
+        PF_SEARCH_STAT(m_Stats.heapPushes = 1);
+        PF_SEARCH_STAT(m_Stats.peakOpenSize = 1);
+        PF_SEARCH_STAT(m_Stats.peakAllocatedNodes = m_AllocateNodeCount);
 
         // Initialise counter for search steps
         m_Steps = 0;
@@ -171,6 +252,17 @@ class AStarSearch {
         // Failure is defined as emptying the open list as there is nothing left to
         // search...
         // New: Allow user abort
+        // An anytime iteration is over once nothing on open can improve on the solution
+        if (m_Anytime && m_Incumbent && !m_CancelRequest &&
+            (m_OpenList.empty() || m_Incumbent->g <= m_OpenList.top()->f)) {
+            return EndAnytimeIteration();
+        }
+
+        if (m_OpenList.empty() && !m_CancelRequest && m_PartialOnFailure && m_BestNode) {
+            StopAtBestNode();
+            return m_State;
+        }
+
         if (m_OpenList.empty() || m_CancelRequest) {
             FreeAllNodes();
             m_State = SEARCH_STATE_FAILED;
@@ -181,16 +273,37 @@ class AStarSearch {
         m_Steps++;
 
         // Pop the best node (the one with the lowest f)
-        Node* n = m_OpenList.front();  // get pointer to the node
-        pop_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
-        m_OpenList.pop_back();
+        Node* n = m_OpenList.pop();  // get pointer to the node
+        m_OpenSet.erase(n);
+        PF_SEARCH_STAT(m_Stats.heapPops++);
 
         // Check for the goal, once we pop that we're done
         if (n->m_UserState.IsGoal(m_Goal->m_UserState)) {
+            // Anytime searches keep the goal in the graph so later iterations can improve it
+            if (m_Anytime) {
+                n->closedIteration = m_Iteration;
+                m_ClosedList.insert(n);
+                m_Incumbent = n;
+                return EndAnytimeIteration();
+            }
+
             // The user is going to use the Goal Node he passed in
-            // so copy the parent pointer of n
+            // so copy the parent pointer of n. IsGoal may accept other states than the
+            // one passed in (several goals), so the goal node takes the reached state too
+            m_Goal->m_UserState = n->m_UserState;
             m_Goal->parent = n->parent;
             m_Goal->g = n->g;
+            m_SolutionCost = n->g;
+            m_SolutionBound = std::max(m_Weight, 1.0f);
+            m_SolutionCount = 1;
+
+            // Only the cost is wanted: skip the solution chain and drop every node at once
+            if (m_CostOnly) {
+                ReleaseAllNodes(n);
+                m_SolutionReleased = true;
+                m_State = SEARCH_STATE_SUCCEEDED;
+                return m_State;
+            }
 
             // A special case is that the goal was passed in as the start state
             // so handle that here
@@ -223,6 +336,12 @@ class AStarSearch {
             // m_Successors ...
 
             m_Successors.clear();  // empty vector of successor nodes to n
+            PF_SEARCH_STAT(m_Stats.nodesExpanded++);
+
+            // remember the expanded node closest to the goal for partial solutions
+            if (!m_BestNode || n->h < m_BestNode->h || (n->h == m_BestNode->h && n->g < m_BestNode->g)) {
+                m_BestNode = n;
+            }
 
             // User provides this functions and uses AddSuccessor to add each successor of
             // node 'n' to m_Successors
@@ -258,22 +377,18 @@ class AStarSearch {
                 // If it is but the node that is already on them is better (lower g)
                 // then we can forget about this successor
 
-                // First linear search of open list to find node
+                // First look the node up on the open list
 
-                typename std::vector<Node*>::iterator openlist_result;
+                typename std::unordered_set<Node*, NodeHash, NodeEqual>::iterator openlist_result;
 
-                for (openlist_result = m_OpenList.begin(); openlist_result != m_OpenList.end();
-                     openlist_result++) {
-                    if ((*openlist_result)->m_UserState.IsSameState((*successor)->m_UserState)) {
-                        break;
-                    }
-                }
+                openlist_result = m_OpenSet.find(*successor);
 
-                if (openlist_result != m_OpenList.end()) {
+                if (openlist_result != m_OpenSet.end()) {
                     // we found this state on open
 
                     if ((*openlist_result)->g <= newg) {
                         FreeNode((*successor));
+                        PF_SEARCH_STAT(m_Stats.openDuplicates++);
 
                         // the one on Open is cheaper than this one
                         continue;
@@ -289,6 +404,7 @@ class AStarSearch {
                     if ((*closedlist_result)->g <= newg) {
                         // the one on Closed is cheaper than this one
                         FreeNode((*successor));
+                        PF_SEARCH_STAT(m_Stats.closedDuplicates++);
 
                         continue;
                     }
@@ -301,14 +417,30 @@ class AStarSearch {
                 (*successor)->g = newg;
                 (*successor)->h =
                     (*successor)->m_UserState.GoalDistanceEstimate(m_Goal->m_UserState);
-                (*successor)->f = (*successor)->g + (*successor)->h;
+                (*successor)->f = (*successor)->g + m_Weight * (*successor)->h;
 
                 // Successor in closed list
                 // 1 - Update old version of this node in closed list
                 // 2 - Move it from closed to open list
                 // 3 - Sort heap again in open list
 
-                if (closedlist_result != m_ClosedList.end()) {
+                // Closed during the current anytime iteration: update it in place and
+                // leave it on INCONS until the next iteration instead of reopening it
+                if (closedlist_result != m_ClosedList.end() && m_Anytime &&
+                    (*closedlist_result)->closedIteration == m_Iteration) {
+                    (*closedlist_result)->parent = (*successor)->parent;
+                    (*closedlist_result)->g = (*successor)->g;
+                    (*closedlist_result)->f = (*successor)->f;
+                    FreeNode((*successor));
+
+                    if (!(*closedlist_result)->incons) {
+                        (*closedlist_result)->incons = true;
+                        m_InconsList.push_back(*closedlist_result);
+                    }
+                    PF_SEARCH_STAT(m_Stats.nodesReopened++);
+                }
+
+                else if (closedlist_result != m_ClosedList.end()) {
                     // Update closed node with successor node AStar data
                     //*(*closedlist_result) = *(*successor);
                     (*closedlist_result)->parent = (*successor)->parent;
@@ -320,13 +452,12 @@ class AStarSearch {
                     FreeNode((*successor));
 
                     // Push closed node into open list
-                    m_OpenList.push_back((*closedlist_result));
+                    PushOpen(*closedlist_result);
 
                     // Remove closed node from closed list
                     m_ClosedList.erase(closedlist_result);
-
-                    // Sort back element into heap
-                    push_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
+                    PF_SEARCH_STAT(m_Stats.heapPushes++);
+                    PF_SEARCH_STAT(m_Stats.nodesReopened++);
 
                     // Fix thanks to ...
                     // Greg Douglas <gregdouglasmail@gmail.com>
@@ -339,7 +470,7 @@ class AStarSearch {
                 // 1 - Update old version of this node in open list
                 // 2 - sort heap again in open list
 
-                else if (openlist_result != m_OpenList.end()) {
+                else if (openlist_result != m_OpenSet.end()) {
                     // Update open node with successor node AStar data
                     //*(*openlist_result) = *(*successor);
                     (*openlist_result)->parent = (*successor)->parent;
@@ -350,11 +481,9 @@ class AStarSearch {
                     // Free successor node
                     FreeNode((*successor));
 
-                    // re-make the heap
-                    // make_heap rather than sort_heap is an essential bug fix
-                    // thanks to Mike Ryynanen for pointing this out and then explaining
-                    // it in detail. sort_heap called on an invalid heap does not work
-                    make_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
+                    // move the node up to its new place on the open list
+                    m_OpenList.update(*openlist_result);
+                    PF_SEARCH_STAT(m_Stats.heapRebuilds++);
                 }
 
                 // New successor
@@ -363,17 +492,19 @@ class AStarSearch {
 
                 else {
                     // Push successor node into open list
-                    m_OpenList.push_back((*successor));
-
-                    // Sort back element into heap
-                    push_heap(m_OpenList.begin(), m_OpenList.end(), HeapCompare_f());
+                    PushOpen(*successor);
+                    PF_SEARCH_STAT(m_Stats.heapPushes++);
                 }
             }
 
             // push n onto Closed, as we have expanded it now
 
+            n->closedIteration = m_Iteration;
             m_ClosedList.insert(n);
 
+            PF_SEARCH_STAT(m_Stats.peakOpenSize = std::max(m_Stats.peakOpenSize, m_OpenList.size()));
+            PF_SEARCH_STAT(m_Stats.peakClosedSize = std::max(m_Stats.peakClosedSize, m_ClosedList.size()));
+
         }  // end else (not goal so expand)
 
         return m_State;  // Succeeded bool is false at this point.
@@ -388,6 +519,7 @@ class AStarSearch {
             node->m_UserState = State;
 
             m_Successors.push_back(node);
+            PF_SEARCH_STAT(m_Stats.nodesGenerated++);
 
             return true;
         }
@@ -399,6 +531,11 @@ class AStarSearch {
     // This is done to clean up all used Node memory when you are done with the
     // search
     void FreeSolutionNodes() {
+        // cost-only searches have nothing left to free
+        if (m_SolutionReleased) {
+            return;
+        }
+
         Node* n = m_Start;
 
         if (m_Start->child) {
@@ -425,6 +562,11 @@ class AStarSearch {
 
     // Get start node
     UserState* GetSolutionStart() {
+        if (m_SolutionReleased) {
+            m_CurrentSolutionNode = NULL;
+            return NULL;
+        }
+
         m_CurrentSolutionNode = m_Start;
         if (m_Start) {
             return &m_Start->m_UserState;
@@ -477,7 +619,7 @@ class AStarSearch {
     // Returns FLT_MAX if goal is not defined or there is no solution
     float GetSolutionCost() {
         if (m_Goal && m_State == SEARCH_STATE_SUCCEEDED) {
-            return m_Goal->g;
+            return m_SolutionCost;
         } else {
             return FLT_MAX;
         }
@@ -492,8 +634,12 @@ class AStarSearch {
     }
 
     UserState* GetOpenListStart(float& f, float& g, float& h) {
-        iterDbgOpen = m_OpenList.begin();
-        if (iterDbgOpen != m_OpenList.end()) {
+        // the open list is walked through a copy, in no particular order
+        m_DbgOpenList.clear();
+        m_OpenList.forEach([this](Node* node) { m_DbgOpenList.push_back(node); });
+
+        iterDbgOpen = m_DbgOpenList.begin();
+        if (iterDbgOpen != m_DbgOpenList.end()) {
             f = (*iterDbgOpen)->f;
             g = (*iterDbgOpen)->g;
             h = (*iterDbgOpen)->h;
@@ -510,7 +656,7 @@ class AStarSearch {
 
     UserState* GetOpenListNext(float& f, float& g, float& h) {
         iterDbgOpen++;
-        if (iterDbgOpen != m_OpenList.end()) {
+        if (iterDbgOpen != m_DbgOpenList.end()) {
             f = (*iterDbgOpen)->f;
             g = (*iterDbgOpen)->g;
             h = (*iterDbgOpen)->h;
@@ -556,12 +702,130 @@ class AStarSearch {
         return NULL;
     }
 
+    // In cost-only mode a successful search records just the solution cost: no child
+    // links are set up and all nodes are released in one go, so there is no solution
+    // to walk and FreeSolutionNodes does nothing
+    void SetCostOnly(bool costOnly) {
+        m_CostOnly = costOnly;
+    }
+
+    bool IsCostOnly() const {
+        return m_CostOnly;
+    }
+
+    // Stop the search and end the solution at the expanded node closest to the goal
+    // (lowest heuristic, then lowest cost) instead of the goal itself. The search is then
+    // SUCCEEDED with IsSolutionPartial() set and the solution is walked and freed as usual.
+    // Returns false, failing the search, if no node has been expanded yet.
+    bool StopAtBestNode() {
+        if (m_State != SEARCH_STATE_SEARCHING) {
+            return false;
+        }
+
+        if (!m_BestNode) {
+            FreeAllNodes();
+            m_State = SEARCH_STATE_FAILED;
+            return false;
+        }
+
+        EndSolutionAt(m_BestNode);
+        m_PartialSolution = true;
+        return true;
+    }
+
+    // Choose how the open list is ordered for the following searches. Buckets need
+    // a state with a cost quantum; returns false and keeps the heap otherwise.
+    bool SetOpenListPolicy(OpenListPolicy policy) {
+        if (policy == OpenListPolicy::Buckets && !(StateCostQuantum<UserState>::value > 0.0f)) {
+            policy = OpenListPolicy::Heap;
+        }
+        assert(m_OpenList.empty());
+        m_OpenList.setPolicy(policy, StateCostQuantum<UserState>::value);
+        return m_OpenList.getPolicy() == policy;
+    }
+
+    OpenListPolicy GetOpenListPolicy() const {
+        return m_OpenList.getPolicy();
+    }
+
+    // Weight w of the heuristic in f = g + w * h for the following searches. With an
+    // admissible heuristic the solution then costs at most w times the optimum.
+    void SetHeuristicWeight(float weight) {
+        m_HeuristicWeight = weight;
+    }
+
+    float GetHeuristicWeight() const {
+        return m_HeuristicWeight;
+    }
+
+    // Goal state of the current search (NULL before the first one), for states that
+    // prune successors by goal
+    UserState* GetGoalState() {
+        return m_Goal ? &m_Goal->m_UserState : NULL;
+    }
+
+    // Anytime repairing A* (ARA*). The search starts with the heuristic weight and, each
+    // time it has a solution, lowers the weight by weightStep and carries on from the
+    // current open and closed lists instead of starting over. Nodes improved after being
+    // closed in an iteration wait on an INCONS list for the next one. The search succeeds
+    // once an iteration with weight 1 finishes or the bound reaches 1; StopAtIncumbent()
+    // ends it early with the best solution so far.
+    void SetAnytime(bool anytime, float weightStep = 0.5f) {
+        m_Anytime = anytime;
+        m_WeightStep = weightStep;
+    }
+
+    bool IsAnytime() const {
+        return m_Anytime;
+    }
+
+    // Finish an anytime search with its current solution. Returns false, leaving the
+    // search running, if no solution has been found yet.
+    bool StopAtIncumbent() {
+        if (m_State != SEARCH_STATE_SEARCHING || !m_Incumbent) {
+            return false;
+        }
+
+        FinishAnytime();
+        return true;
+    }
+
+    // Bound on cost / optimal cost for the current solution (FLT_MAX before there is one)
+    float GetSuboptimalityBound() const {
+        return m_SolutionBound;
+    }
+
+    // Number of solutions found so far (anytime searches improve on earlier ones)
+    unsigned int GetSolutionCount() const {
+        return m_SolutionCount;
+    }
+
+    // When set, a search whose open list runs empty ends with StopAtBestNode() rather
+    // than failing, so an unreachable goal still yields a path towards it
+    void SetPartialOnFailure(bool partialOnFailure) {
+        m_PartialOnFailure = partialOnFailure;
+    }
+
+    // True if the last solution ends at the best node rather than the goal
+    bool IsSolutionPartial() const {
+        return m_PartialSolution;
+    }
+
     // Get the number of steps
 
     int GetStepCount() {
         return m_Steps;
     }
 
+    // Counters of the current or last search (all zero if compiled out)
+    SearchStats GetSearchStats() const {
+#if PATHFINDING_SEARCH_STATS
+        return m_Stats;
+#else
+        return SearchStats();
+#endif
+    }
+
     void EnsureMemoryFreed() {
 #if USE_FSA_MEMORY
         assert(m_AllocateNodeCount == 0);
@@ -569,20 +833,23 @@ class AStarSearch {
     }
 
    private:  // methods
+    void PushOpen(Node* node) {
+        m_OpenList.push(node);
+        m_OpenSet.insert(node);
+    }
+
+    void ClearOpen() {
+        m_OpenList.clear();
+        m_OpenSet.clear();
+    }
+
     // This is called when a search fails or is cancelled to free all used
     // memory
     void FreeAllNodes() {
         // iterate open list and delete all nodes
-        typename std::vector<Node*>::iterator iterOpen = m_OpenList.begin();
-
-        while (iterOpen != m_OpenList.end()) {
-            Node* n = (*iterOpen);
-            FreeNode(n);
+        m_OpenList.forEach([this](Node* n) { FreeNode(n); });
 
-            iterOpen++;
-        }
-
-        m_OpenList.clear();
+        ClearOpen();
 
         // iterate closed list and delete unused nodes
         typename std::unordered_set<Node*, NodeHash, NodeEqual>::iterator iterClosed;
@@ -593,32 +860,147 @@ class AStarSearch {
         }
 
         m_ClosedList.clear();
+        m_InconsList.clear();
+        m_Incumbent = NULL;
 
         // delete the goal
 
         FreeNode(m_Goal);
     }
 
+    // End the solution chain at the given node: the goal node takes its place, child links
+    // are set from the start and every node not on the chain is freed
+    void EndSolutionAt(Node* end) {
+        m_ClosedList.erase(end);
+
+        // it may have been reopened since it was expanded
+        if (m_OpenSet.count(end)) {
+            m_OpenSet.erase(end);
+            m_OpenList.erase(end);
+        }
+
+        m_Goal->m_UserState = end->m_UserState;
+        m_Goal->parent = end->parent;
+        m_Goal->g = end->g;
+        m_SolutionCost = end->g;
+
+        if (end != m_Start) {
+            FreeNode(end);
+
+            Node* nodeChild = m_Goal;
+            Node* nodeParent = m_Goal->parent;
+
+            do {
+                nodeParent->child = nodeChild;
+
+                nodeChild = nodeParent;
+                nodeParent = nodeParent->parent;
+
+            } while (nodeChild != m_Start);
+
+            // ancestors may have been improved since end was reached, so the chain can be
+            // cheaper than end->g: recompute the costs along it
+            for (Node* node = m_Start; node != m_Goal; node = node->child) {
+                node->child->g = node->g + node->m_UserState.GetCost(node->child->m_UserState);
+            }
+            m_SolutionCost = m_Goal->g;
+        }
+
+        // INCONS nodes are also on the closed list
+        m_InconsList.clear();
+        FreeUnusedNodes();
+
+        m_BestNode = NULL;
+        m_Incumbent = NULL;
+        m_State = SEARCH_STATE_SUCCEEDED;
+    }
+
+    // Record the solution of the anytime iteration that just ended, then either finish
+    // or start the next iteration with a lower weight
+    unsigned int EndAnytimeIteration() {
+        m_SolutionCost = m_Incumbent->g;
+        m_SolutionCount++;
+
+        // Every state that could still improve the solution is on open or INCONS, so the
+        // lowest unweighted f among them bounds the optimal cost from below
+        float lowest = FLT_MAX;
+        m_OpenList.forEach([&lowest](Node* node) { lowest = std::min(lowest, node->g + node->h); });
+        for (Node* node : m_InconsList) {
+            lowest = std::min(lowest, node->g + node->h);
+        }
+
+        float bound = std::max(m_Weight, 1.0f);
+        if (lowest == FLT_MAX || lowest >= m_SolutionCost) {
+            bound = 1.0f;
+        } else if (lowest > 0.0f) {
+            bound = std::min(bound, m_SolutionCost / lowest);
+        }
+        m_SolutionBound = std::min(m_SolutionBound, bound);
+
+        if (m_Weight <= 1.0f || m_SolutionBound <= 1.0f) {
+            m_SolutionBound = 1.0f;
+            FinishAnytime();
+            return m_State;
+        }
+
+        m_Weight = std::max(1.0f, m_Weight - m_WeightStep);
+        m_Iteration++;
+
+        // INCONS nodes go back on open; every f is recomputed with the new weight
+        for (Node* node : m_InconsList) {
+            node->incons = false;
+            m_ClosedList.erase(node);
+            PushOpen(node);
+        }
+        m_InconsList.clear();
+
+        float weight = m_Weight;
+        m_OpenList.forEach([weight](Node* node) { node->f = node->g + weight * node->h; });
+        m_OpenList.rebuild();
+        PF_SEARCH_STAT(m_Stats.heapRebuilds++);
+
+        return m_State;
+    }
+
+    void FinishAnytime() {
+        EndSolutionAt(m_Incumbent);
+    }
+
+    // Release every node of the search, including the popped node and start/goal,
+    // by resetting the allocator rather than freeing the nodes one by one
+    void ReleaseAllNodes(Node* popped) {
+#if USE_FSA_MEMORY
+        m_OpenList.forEach([](Node* node) { node->~Node(); });
+        for (Node* node : m_ClosedList) {
+            node->~Node();
+        }
+        popped->~Node();
+        m_Goal->~Node();
+
+        m_FixedSizeAllocator.FreeAll();
+        m_AllocateNodeCount = 0;
+
+        ClearOpen();
+        m_ClosedList.clear();
+        m_InconsList.clear();
+#else
+        FreeNode(popped);
+        FreeAllNodes();
+#endif
+    }
+
     // This call is made by the search class when the search ends. A lot of nodes may be
     // created that are still present when the search ends. They will be deleted by this
     // routine once the search ends
     void FreeUnusedNodes() {
         // iterate open list and delete unused nodes
-        typename std::vector<Node*>::iterator iterOpen = m_OpenList.begin();
-
-        while (iterOpen != m_OpenList.end()) {
-            Node* n = (*iterOpen);
-
+        m_OpenList.forEach([this](Node* n) {
             if (!n->child) {
                 FreeNode(n);
-
-                n = NULL;
             }
+        });
 
-            iterOpen++;
-        }
-
-        m_OpenList.clear();
+        ClearOpen();
 
         // iterate closed list and delete unused nodes
         typename std::unordered_set<Node*, NodeHash, NodeEqual>::iterator iterClosed;
@@ -639,6 +1021,7 @@ class AStarSearch {
     Node* AllocateNode() {
 #if !USE_FSA_MEMORY
         m_AllocateNodeCount++;
+        PF_SEARCH_STAT(m_Stats.peakAllocatedNodes = std::max<size_t>(m_Stats.peakAllocatedNodes, m_AllocateNodeCount));
         Node* p = new Node;
         return p;
 #else
@@ -648,6 +1031,7 @@ class AStarSearch {
             return NULL;
         }
         m_AllocateNodeCount++;
+        PF_SEARCH_STAT(m_Stats.peakAllocatedNodes = std::max<size_t>(m_Stats.peakAllocatedNodes, m_AllocateNodeCount));
         Node* p = new (address) Node;
         return p;
 #endif
@@ -666,7 +1050,8 @@ class AStarSearch {
 
    private:  // data
     // Heap (simple vector but used as a heap, cf. Steve Rabin's game gems article)
-    std::vector<Node*> m_OpenList;
+    // or bucket queue, see openlist.h
+    OpenList<Node, HeapCompare_f> m_OpenList;
 
     // Closed is an unordered_set
     struct NodeHash {
@@ -681,6 +1066,9 @@ class AStarSearch {
     };
     std::unordered_set<Node*, NodeHash, NodeEqual> m_ClosedList;
 
+    // the nodes on the open list, by state
+    std::unordered_set<Node*, NodeHash, NodeEqual> m_OpenSet;
+
     // Successors is a vector filled out by the user each type successors to a node
     // are generated
     std::vector<Node*> m_Successors;
@@ -704,6 +1092,7 @@ class AStarSearch {
 
     // Debug : need to keep these two iterators around
     //  for the user Dbg functions
+    std::vector<Node*> m_DbgOpenList;
     typename std::vector<Node*>::iterator iterDbgOpen;
     typename std::unordered_set<Node*, NodeHash, NodeEqual>::iterator iterDbgClosed;
 
@@ -711,6 +1100,31 @@ class AStarSearch {
     int m_AllocateNodeCount;
 
     bool m_CancelRequest;
+
+    // cost-only mode, see SetCostOnly
+    bool m_CostOnly;
+    bool m_SolutionReleased;
+    float m_SolutionCost;
+
+    // partial solutions, see StopAtBestNode
+    bool m_PartialOnFailure;
+    bool m_PartialSolution;
+    Node* m_BestNode;
+
+    // weighted and anytime search, see SetHeuristicWeight and SetAnytime
+    float m_HeuristicWeight;
+    float m_Weight;  // weight of the current search or anytime iteration
+    float m_SolutionBound;
+    bool m_Anytime;
+    float m_WeightStep;
+    unsigned int m_Iteration;
+    Node* m_Incumbent;  // node of the goal state in an anytime search
+    unsigned int m_SolutionCount;
+    std::vector<Node*> m_InconsList;
+
+#if PATHFINDING_SEARCH_STATS
+    SearchStats m_Stats;
+#endif
 };
 
 template <class T>
@@ -0,0 +1,130 @@
+#pragma once
+#include "grid.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Simple subgoal graph: subgoals sit on the convex corners of obstacles and are linked to
+// the subgoals directly h-reachable from them, i.e. reachable by a move-by-move path as
+// short as the octile distance with no other subgoal in the way. A query links start and
+// goal into the graph, runs A* over the subgoals only and then refines each edge back to
+// cells with a diagonal-first or straight-first walk.
+// The construction relies on octile distances being exact path lengths in free space, so
+// it only describes 8-connected grids that forbid corner cutting and have uniform costs;
+// isValidFor() is false on any other grid.
+class SubgoalGraph {
+public:
+    SubgoalGraph();
+
+    // Place the subgoals of grid and link them. Returns false and leaves the graph empty if
+    // the grid moves or costs in a way the graph cannot describe.
+    bool build(const Grid& grid);
+
+    // Bring the graph up to date with the batch (a grid subscriber entry point). Only the
+    // subgoals around the changed cells are replaced and only the subgoals that looked at
+    // them while linking are relinked; a batch that does not follow on from the graph's
+    // revision, or one that changes the rules, rebuilds everything.
+    // Returns the number of subgoals relinked.
+    size_t update(const Grid& grid, const GridChangeBatch& batch);
+
+    // True if the graph describes the grid as it is now
+    bool isValidFor(const Grid& grid) const;
+
+    // Shortest path start -> goal, both included. The grid must be the one the graph
+    // describes. Returns false if there is none.
+    bool findPath(const Grid& grid, const Position& start, const Position& goal, std::vector<Position>& path);
+
+    bool isSubgoal(const Position& pos) const { return subgoalAt(pos) >= 0; }
+
+    size_t getSubgoalCount() const { return subgoalCount_; }
+    size_t getEdgeCount() const { return edgeCount_; }
+    std::uint64_t getRevision() const { return revision_; }
+
+    // Statistics of the last findPath
+    float getLastPathCost() const { return lastPathCost_; }
+    size_t getLastExpansions() const { return lastExpansions_; }
+
+    // True if grid is 8-connected without corner cutting and has uniform costs
+    static bool supports(const Grid& grid);
+
+private:
+    struct Edge {
+        int target;
+        float cost;
+    };
+
+    // Cells read while linking a subgoal, to know which edits can change its edges
+    struct Box {
+        int minX, minY, maxX, maxY;
+    };
+
+    struct Subgoal {
+        Position pos;
+        Box scanned;
+        std::vector<Edge> edges;
+    };
+
+    int subgoalAt(const Position& pos) const {
+        return pos.x >= 0 && pos.y >= 0 && pos.x < width_ && pos.y < height_ ? subgoalAt_[pos.y * width_ + pos.x] : -1;
+    }
+
+    // True if pos is free and lies on the corner of an obstacle
+    static bool isCorner(const Grid& grid, const Position& pos);
+
+    // Subgoals (and extra, if given) directly h-reachable from from. Every cell read is
+    // added to box when one is given.
+    void scan(const Grid& grid, const Position& from, const Position* extra,
+              std::vector<Position>& found, Box* box) const;
+
+    // Free cells in a straight line from from, stopping before a wall or a subgoal, and
+    // after at most limit cells
+    int clearance(const Grid& grid, Position from, int dx, int dy, int limit,
+                  const Position* extra, Box* box) const;
+
+    bool stopsScan(const Position& pos, const Position* extra) const {
+        return subgoalAt(pos) >= 0 || (extra && pos == *extra);
+    }
+
+    // Add or drop the subgoal of a cell according to the grid; returns true on a change
+    bool refreshCell(const Grid& grid, const Position& pos);
+
+    // Replace the edges of a subgoal with the ones found by scanning from it
+    void link(const Grid& grid, int id);
+
+    // Octile distance at the graph's move cost
+    float distance(const Position& from, const Position& to) const;
+
+    // Append the cells after from on a straight/diagonal walk to to, diagonal moves first
+    // if diagonalFirst. Returns false (and leaves path as it was) if the walk is blocked.
+    static bool walk(const Grid& grid, const Position& from, const Position& to, bool diagonalFirst,
+                     std::vector<Position>& path);
+
+    void clear();
+
+    int width_, height_;
+    std::uint64_t revision_;
+    std::uint64_t cellHash_;  // Grid::getCellHash() of the grid described
+    float moveCost_;
+    std::vector<int> subgoalAt_;        // Subgoal id of every cell, -1 if none
+    std::vector<Subgoal> subgoals_;     // Indexed by id; dropped subgoals are left unused
+    std::vector<int> freeIds_;          // Ids of dropped subgoals, reused first
+    size_t subgoalCount_;
+    size_t edgeCount_;
+
+    // Query scratch, indexed by id; the start and goal take the two ids past the subgoals
+    struct Node {
+        std::uint32_t stamp;
+        bool closed;
+        float g;
+        int parent;
+    };
+    std::vector<Node> nodes_;
+    std::vector<std::pair<float, int>> open_;  // Binary heap on f
+    std::vector<Edge> startEdges_;
+    std::vector<float> goalLinks_;      // Cost to the goal from each id, infinite if unlinked
+    std::vector<int> linkedToGoal_;     // Ids with a finite goalLinks_ entry
+    std::vector<Position> found_;
+    std::uint32_t stamp_;
+    float lastPathCost_;
+    size_t lastExpansions_;
+};
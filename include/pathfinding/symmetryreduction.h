@@ -0,0 +1,112 @@
+#pragma once
+#include "grid.h"
+#include "stlastar.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SymmetryReduction;
+
+// Cell of the reduced graph searched by SymmetryReduction
+class SymmetryState : public AStarState<SymmetryState> {
+public:
+    Position position;
+    const SymmetryReduction* reduction;  // Graph the state belongs to (not owned)
+
+    // Macro edges cost a whole number of cells of one terrain, like grid moves
+    static constexpr float kCostQuantum = 0.5f;
+
+    SymmetryState() : position(0, 0), reduction(nullptr) {}
+    SymmetryState(const Position& pos, const SymmetryReduction* r) : position(pos), reduction(r) {}
+
+    // A* interface implementations
+    float GoalDistanceEstimate(SymmetryState& nodeGoal) override;
+    bool IsGoal(SymmetryState& nodeGoal) override;
+    bool GetSuccessors(AStarSearch<SymmetryState>* astarsearch, SymmetryState* parent_node) override;
+    float GetCost(SymmetryState& successor) override;
+    bool IsSameState(SymmetryState& rhs) override;
+    size_t Hash() override;
+};
+
+// Rectangular symmetry reduction for 4-connected grids. The walkable cells are split into
+// empty rectangles of one terrain each, as large as a greedy scan finds them. Any shortest
+// path crossing a rectangle can be swapped for one of the same cost that only walks along
+// its border and jumps straight across it, so the search keeps the border cells, their
+// moves along the border and into neighboring rectangles, and a macro edge from each border
+// cell to the one facing it on the opposite side. Open rooms then cost A* a few border
+// cells instead of every tie on the way through. A start or goal inside a rectangle is
+// linked to the border cells straight above, below, left and right of it for one query.
+// Diagonal moves have many more symmetric paths than straight jumps can stand in for, so
+// 8-connected grids are not reduced; isValidFor() is false on them.
+class SymmetryReduction {
+public:
+    SymmetryReduction();
+
+    // Split grid into rectangles. Returns false and leaves the reduction empty if the grid
+    // is not 4-connected.
+    bool build(const Grid& grid);
+
+    // True if the reduction was built from the grid as it is now
+    bool isValidFor(const Grid& grid) const;
+
+    // Shortest path start -> goal, both included, found by A* over the reduced graph. The
+    // grid must be the one the reduction was built from. Returns false if there is none.
+    bool findPath(const Grid& grid, const Position& start, const Position& goal, std::vector<Position>& path);
+
+    bool isBorder(const Position& pos) const;
+
+    size_t getRectangleCount() const { return rects_.size(); }
+    size_t getBorderCount() const { return borderCount_; }
+    double getBuildMicros() const { return buildMicros_; }
+
+    // Statistics of the last findPath
+    float getLastPathCost() const { return lastPathCost_; }
+    size_t getLastExpansions() const { return lastExpansions_; }
+
+    // True if grid is 4-connected
+    static bool supports(const Grid& grid);
+
+private:
+    friend class SymmetryState;
+
+    struct Rect {
+        int minX, minY, maxX, maxY;
+        float cost;  // Terrain cost of every cell in it
+    };
+
+    const Rect* rectAt(const Position& pos) const {
+        int id = rectAt_[pos.y * width_ + pos.x];
+        return id >= 0 ? &rects_[id] : nullptr;
+    }
+
+    // True if the grid moves and costs as it did when the reduction was built
+    bool sameRules(const Grid& grid) const;
+
+    // Largest rectangle of cells of type with top-left corner at from that no other
+    // rectangle covers yet
+    Rect grow(const Grid& grid, const Position& from, CellType type) const;
+
+    // Reduced graph moves out of state, for a search heading to goal
+    void addSuccessors(AStarSearch<SymmetryState>* astarsearch, const SymmetryState& state,
+                       const SymmetryState* parent, const Position& goal) const;
+
+    // Cost of a grid move, or of a straight or L-shaped walk inside one rectangle
+    float moveCost(const Position& from, const Position& to) const;
+
+    int width_, height_;
+    std::uint64_t revision_;
+    std::uint64_t cellHash_;  // Grid::getCellHash() of the grid described
+    Connectivity connectivity_;
+    CornerCutting cornerCutting_;
+    std::array<float, kCellTypeCount> terrainCosts_;
+    float minMoveCost_;
+    std::vector<int> rectAt_;          // Rectangle of every cell, -1 for walls
+    std::vector<Rect> rects_;
+    size_t borderCount_;
+    double buildMicros_;
+
+    std::unique_ptr<AStarSearch<SymmetryState>> search_;  // Sized for every border cell
+    float lastPathCost_;
+    size_t lastExpansions_;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Scoped timing events dumped as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Build with PATHFINDING_TRACING=0 to remove every trace point; otherwise a disabled
+// tracer costs one relaxed atomic load per scope.
+#ifndef PATHFINDING_TRACING
+#define PATHFINDING_TRACING 1
+#endif
+
+namespace trace_detail {
+    inline std::atomic<bool> enabled{false};
+
+    std::int64_t now();
+    void record(const char* name, std::int64_t startNs, std::int64_t endNs);
+}
+
+// Runtime switch, off by default
+void setTracingEnabled(bool enabled);
+inline bool isTracingEnabled() {
+    return trace_detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Label for the calling thread in the trace viewer
+void setTraceThreadName(const std::string& name);
+
+// Write every recorded event as Chrome trace JSON; events are kept until clearTrace
+void writeChromeTrace(std::ostream& out);
+bool writeChromeTrace(const std::string& path);
+void clearTrace();
+
+// Events recorded so far, and events lost because a thread buffer was full
+size_t getTraceEventCount();
+size_t getTraceDroppedCount();
+
+// Records the lifetime of the scope; name must be a string literal
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(isTracingEnabled() ? name : nullptr), start_(name_ ? trace_detail::now() : 0) {
+    }
+
+    ~TraceScope() {
+        if (name_) {
+            trace_detail::record(name_, start_, trace_detail::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    std::int64_t start_;
+};
+
+#define PF_TRACE_CONCAT_INNER(a, b) a##b
+#define PF_TRACE_CONCAT(a, b) PF_TRACE_CONCAT_INNER(a, b)
+
+#if PATHFINDING_TRACING
+#define PF_TRACE_SCOPE(name) TraceScope PF_TRACE_CONCAT(pfTraceScope, __LINE__)(name)
+#else
+#define PF_TRACE_SCOPE(name) do {} while (0)
+#endif
@@ -0,0 +1,172 @@
+#include "pathfinding/agentmanager.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+
+// Constructor
+AgentManager::AgentManager(size_t searchEngines)
+    : pathGarbage_(0), nextEngine_(0) {
+    size_t count = std::max<size_t>(searchEngines, 1);
+    engines_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        engines_.push_back(std::make_unique<Pathfinder>());
+    }
+}
+
+AgentId AgentManager::addAgent(const Position& pos, sf::Color color) {
+    AgentId id = static_cast<AgentId>(posX_.size());
+
+    posX_.push_back(pos.x);
+    posY_.push_back(pos.y);
+    color_.push_back(color.toInteger());
+    pathOffset_.push_back(0);
+    pathLength_.push_back(0);
+    pathCursor_.push_back(0);
+
+    return id;
+}
+
+void AgentManager::reserve(size_t agentCount) {
+    posX_.reserve(agentCount);
+    posY_.reserve(agentCount);
+    color_.reserve(agentCount);
+    pathOffset_.reserve(agentCount);
+    pathLength_.reserve(agentCount);
+    pathCursor_.reserve(agentCount);
+}
+
+void AgentManager::setPosition(AgentId id, const Position& pos) {
+    posX_[id] = pos.x;
+    posY_[id] = pos.y;
+}
+
+// A* Pathfinding implementation
+bool AgentManager::findPathTo(AgentId id, const Grid& grid, const Position& target) {
+    clearPath(id);
+
+    Pathfinder& pathfinder = acquireEngine();
+    if (!pathfinder.findPath(grid, getPosition(id), target, scratchPath_)) {
+        return false;
+    }
+
+    // Skip the first position (the agent's current cell) instead of erasing it
+    size_t skip = (!scratchPath_.empty() && scratchPath_.front() == getPosition(id)) ? 1 : 0;
+    assignPath(id, scratchPath_.data() + skip, scratchPath_.size() - skip);
+    return true;
+}
+
+void AgentManager::setPath(AgentId id, const std::vector<Position>& steps) {
+    assignPath(id, steps.data(), steps.size());
+}
+
+void AgentManager::clearPath(AgentId id) {
+    releasePath(id);
+    pathOffset_[id] = 0;
+    pathLength_[id] = 0;
+    pathCursor_[id] = 0;
+}
+
+Position AgentManager::getPathStep(AgentId id, size_t step) const {
+    size_t slot = pathOffset_[id] + pathCursor_[id] + step;
+    return Position(pathX_[slot], pathY_[slot]);
+}
+
+void AgentManager::followPaths() {
+    PF_TRACE_SCOPE("AgentManager::followPaths");
+    const size_t count = posX_.size();
+
+    // Branch-light loop over plain arrays so the compiler can vectorize it
+    for (size_t i = 0; i < count; ++i) {
+        const std::uint32_t cursor = pathCursor_[i];
+        if (cursor < pathLength_[i]) {
+            const std::uint32_t slot = pathOffset_[i] + cursor;
+            posX_[i] = pathX_[slot];
+            posY_[i] = pathY_[slot];
+            pathCursor_[i] = cursor + 1;
+        }
+    }
+}
+
+void AgentManager::render(sf::RenderWindow& window, float tileSize) const {
+    PF_TRACE_SCOPE("AgentManager::render");
+    sf::RectangleShape pathTile(sf::Vector2f(tileSize, tileSize));
+    pathTile.setFillColor(sf::Color(255, 255, 0, 100));
+    pathTile.setOutlineColor(sf::Color::Yellow);
+    pathTile.setOutlineThickness(1.0f);
+
+    sf::CircleShape agentShape(tileSize / 2.5f);
+    agentShape.setOutlineColor(sf::Color::Black);
+    agentShape.setOutlineThickness(2.0f);
+    float offset = (tileSize - agentShape.getRadius() * 2) / 2;
+
+    for (size_t i = 0; i < posX_.size(); ++i) {
+        // Draw the remaining path
+        for (std::uint32_t step = pathCursor_[i]; step < pathLength_[i]; ++step) {
+            std::uint32_t slot = pathOffset_[i] + step;
+            pathTile.setPosition(sf::Vector2f(pathX_[slot] * tileSize, pathY_[slot] * tileSize));
+            window.draw(pathTile);
+        }
+
+        // Draw the agent
+        agentShape.setFillColor(sf::Color(color_[i]));
+        agentShape.setPosition(sf::Vector2f(
+            posX_[i] * tileSize + offset,
+            posY_[i] * tileSize + offset
+        ));
+        window.draw(agentShape);
+    }
+}
+
+Pathfinder& AgentManager::acquireEngine() {
+    Pathfinder& engine = *engines_[nextEngine_];
+    nextEngine_ = (nextEngine_ + 1) % engines_.size();
+    return engine;
+}
+
+void AgentManager::assignPath(AgentId id, const Position* steps, size_t count) {
+    releasePath(id);
+
+    // Reclaim slots of finished paths once they make up half of the pool
+    if (pathGarbage_ > 0 && pathGarbage_ * 2 >= pathX_.size()) {
+        compactPathPool();
+    }
+
+    pathOffset_[id] = static_cast<std::uint32_t>(pathX_.size());
+    pathLength_[id] = static_cast<std::uint32_t>(count);
+    pathCursor_[id] = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        pathX_.push_back(steps[i].x);
+        pathY_.push_back(steps[i].y);
+    }
+}
+
+// Mark the agent's pool slots as reclaimable
+void AgentManager::releasePath(AgentId id) {
+    pathGarbage_ += pathLength_[id];
+    pathLength_[id] = 0;
+    pathCursor_[id] = 0;
+}
+
+// Rebuild the pool keeping only the steps agents still have to take
+void AgentManager::compactPathPool() {
+    std::vector<std::int32_t> newX;
+    std::vector<std::int32_t> newY;
+    newX.reserve(pathX_.size() - pathGarbage_);
+    newY.reserve(pathY_.size() - pathGarbage_);
+
+    for (size_t i = 0; i < posX_.size(); ++i) {
+        std::uint32_t begin = pathOffset_[i] + pathCursor_[i];
+        std::uint32_t end = pathOffset_[i] + pathLength_[i];
+
+        pathOffset_[i] = static_cast<std::uint32_t>(newX.size());
+        pathLength_[i] = end - begin;
+        pathCursor_[i] = 0;
+
+        newX.insert(newX.end(), pathX_.begin() + begin, pathX_.begin() + end);
+        newY.insert(newY.end(), pathY_.begin() + begin, pathY_.begin() + end);
+    }
+
+    pathX_.swap(newX);
+    pathY_.swap(newY);
+    pathGarbage_ = 0;
+}
@@ -1,8 +1,19 @@
 #include "pathfinding/character.h"
+#include "pathfinding/pathsmoothing.h"
+#include "pathfinding/trace.h"
 #include <SFML/Graphics.hpp>
 
 Character::Character(const Position& startPos, sf::Color color) 
-    : position_(startPos), color_(color), pathIndex_(0) {
+    : position_(startPos), color_(color), pendingRequest_(0), requestScheduler_(nullptr),
+      pathSmoothing_(false), lineConnectivity_(Connectivity::Eight), pathDatabase_(nullptr),
+      followDatabase_(false) {
+}
+
+// Destructor - a path nobody will take must not stay in the scheduler
+Character::~Character() {
+    if (pendingRequest_ != 0) {
+        requestScheduler_->cancel(pendingRequest_);
+    }
 }
 
 bool Character::moveUp(const Grid& grid) {
@@ -31,13 +42,32 @@ bool Character::tryMove(const Grid& grid, const Position& newPos) {
 }
 
 void Character::render(sf::RenderWindow& window, float tileSize) const {
-    // Draw the path if one exists
+    // Draw the path if one exists, walking the lines between waypoints
     if (hasPath()) {
-        for (size_t i = pathIndex_; i < currentPath_.size(); ++i) {
+        std::vector<Position> steps;
+        if (followDatabase_) {
+            pathDatabase_->getPath(position_, currentPath_.front(), steps);
+            if (!steps.empty()) {
+                steps.erase(steps.begin());
+            }
+        } else {
+            GridLine line = line_.done() ? GridLine(position_, currentPath_.front(), lineConnectivity_) : line_;
+            while (!line.done()) {
+                steps.push_back(line.next());
+            }
+            for (size_t i = 1; i < currentPath_.size(); ++i) {
+                line = GridLine(currentPath_[i - 1], currentPath_[i], lineConnectivity_);
+                while (!line.done()) {
+                    steps.push_back(line.next());
+                }
+            }
+        }
+        
+        for (const Position& step : steps) {
             sf::RectangleShape pathTile(sf::Vector2f(tileSize, tileSize));
             pathTile.setPosition(sf::Vector2f(
-                currentPath_[i].x * tileSize,
-                currentPath_[i].y * tileSize
+                step.x * tileSize,
+                step.y * tileSize
             ));
             pathTile.setFillColor(sf::Color(255, 255, 0, 100)); // if you want visible path
             pathTile.setOutlineColor(sf::Color::Yellow);
@@ -97,34 +127,111 @@ void Character::handleInput(const Grid& grid) {
 bool Character::findPathTo(const Grid& grid, const Position& target) {
     clearPath(); // Clear any existing path
     
-    if (pathfinder_.findPath(grid, position_, target, currentPath_)) {
-        pathIndex_ = 0; // Start at the beginning of the path
-        // Remove the first position (current position) from the path
-        if (!currentPath_.empty() && currentPath_[0] == position_) {
-            currentPath_.erase(currentPath_.begin());
+    // The database already knows every next step, so nothing needs searching or storing
+    if (pathDatabase_ && pathDatabase_->isValidFor(grid)) {
+        Position next;
+        if (target == position_) {
+            return grid.isWalkable(target);
         }
+        if (!pathDatabase_->nextStep(position_, target, next)) {
+            return false;
+        }
+        currentPath_.resetSteps().assign(1, target);
+        followDatabase_ = true;
         return true;
     }
-    return false;
+    
+    if (!pathfinder_.findPath(grid, position_, target, currentPath_)) {
+        return false;
+    }
+    
+    if (pathSmoothing_) {
+        smoothPath(grid, currentPath_.getSteps(), waypoints_);
+        currentPath_.resetSteps().assign(waypoints_.begin(), waypoints_.end());
+        lineConnectivity_ = grid.getConnectivity();
+    } else {
+        lineConnectivity_ = Connectivity::Eight;  // Steps between neighbors
+    }
+    
+    // Skip the first position (current position)
+    if (!currentPath_.empty() && currentPath_.front() == position_) {
+        currentPath_.advance();
+    }
+    return true;
+}
+
+void Character::requestPathTo(PathRequestScheduler& scheduler, const Position& target, int urgency) {
+    if (pendingRequest_ != 0) {
+        requestScheduler_->cancel(pendingRequest_);
+    }
+    pendingRequest_ = scheduler.submit(position_, target, urgency);
+    requestScheduler_ = &scheduler;
+}
+
+bool Character::receivePath(PathRequestScheduler& scheduler) {
+    if (pendingRequest_ == 0) {
+        return false;
+    }
+
+    PathRequestStatus status = scheduler.getStatus(pendingRequest_);
+    if (status == PathRequestStatus::Pending || status == PathRequestStatus::Searching) {
+        return false;
+    }
+
+    std::vector<Position> path;
+    bool found = scheduler.takeResult(pendingRequest_, path);
+    pendingRequest_ = 0;
+
+    // Ignore paths that no longer start where the character stands
+    if (!found || path.empty() || path[0] != position_) {
+        return false;
+    }
+
+    currentPath_ = PathResult(std::move(path));
+    currentPath_.advance();
+    followDatabase_ = false;
+    lineConnectivity_ = Connectivity::Eight;  // Steps between neighbors
+    return true;
 }
 
 void Character::followPath() {
+    PF_TRACE_SCOPE("Character::followPath");
     if (!hasPath()) {
         return;
     }
     
-    if (pathIndex_ < currentPath_.size()) {
-        position_ = currentPath_[pathIndex_];
-        pathIndex_++;
-        
-        // Clear path when we reach the end
-        if (pathIndex_ >= currentPath_.size()) {
+    if (followDatabase_) {
+        Position next;
+        if (!pathDatabase_->nextStep(position_, currentPath_.front(), next)) {
             clearPath();
+            return;
         }
+        position_ = next;
+        if (position_ == currentPath_.front()) {
+            clearPath();
+        }
+        return;
+    }
+    
+    // One cell along the line to the next waypoint; neighboring steps take one call
+    if (line_.done()) {
+        line_ = GridLine(position_, currentPath_.front(), lineConnectivity_);
+    }
+    if (!line_.done()) {
+        position_ = line_.next();
+    }
+    if (line_.done()) {
+        currentPath_.advance();
+    }
+    
+    // Clear path when we reach the end
+    if (currentPath_.empty()) {
+        clearPath();
     }
 }
 
 void Character::clearPath() {
     currentPath_.clear();
-    pathIndex_ = 0;
+    line_ = GridLine();
+    followDatabase_ = false;
 }
\ No newline at end of file
@@ -0,0 +1,535 @@
+#include "pathfinding/contractionhierarchy.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+
+    // Nodes handed to a thread at a time
+    const size_t kChunkSize = 32;
+
+    // A witness search gives up after settling this many nodes; a witness it misses only
+    // costs an unneeded shortcut. Importance estimates, redone for every neighbor of every
+    // contracted node, make do with much shorter searches.
+    const int kWitnessSettleLimit = 1000;
+    const int kEstimateSettleLimit = 16;
+
+    struct DynamicArc {
+        int node;
+        float cost;
+        int middle;
+    };
+
+    using ArcLists = std::vector<std::vector<DynamicArc>>;
+
+    struct Shortcut {
+        int from, to;
+        float cost;
+        int middle;
+    };
+
+    // Call work(worker, i) for every i below count, spread over threads in chunks
+    template <typename Work>
+    void parallelFor(size_t count, unsigned int threads, Work work) {
+        threads = static_cast<unsigned int>(std::min<size_t>(threads, (count + kChunkSize - 1) / kChunkSize));
+        std::atomic<size_t> nextChunk(0);
+        auto worker = [&](unsigned int index) {
+            for (size_t begin = nextChunk.fetch_add(kChunkSize); begin < count; begin = nextChunk.fetch_add(kChunkSize)) {
+                for (size_t i = begin; i < std::min(begin + kChunkSize, count); ++i) {
+                    work(index, i);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < threads; ++t) {
+            pool.emplace_back(worker, t);
+        }
+        worker(0);
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+    }
+
+    // Dijkstra over the nodes not contracted yet, looking for paths as cheap as a shortcut
+    class WitnessSearch {
+    public:
+        explicit WitnessSearch(size_t nodes) : labels_(nodes, Label{0, 0, kInfinity}), stamp_(0) {}
+
+        // Distances from source to the targets (the arcs of skip), up to limit, never
+        // passing through skip or a node flagged in busy (the nodes being contracted alongside)
+        void run(const ArcLists& out, int source, float limit, int skip, const std::vector<char>& busy,
+                 int settleLimit) {
+            if (++stamp_ == 0) {
+                for (Label& label : labels_) {
+                    label.stamp = 0;
+                    label.target = 0;
+                }
+                stamp_ = 1;
+            }
+            int targets = 0;
+            for (const DynamicArc& arc : out[skip]) {
+                if (arc.node != source) {
+                    labels_[arc.node].target = stamp_;
+                    ++targets;
+                }
+            }
+            open_.clear();
+            label(source) = 0.0f;
+            open_.emplace_back(0.0f, source);
+
+            for (int settled = 0; !open_.empty() && settled < settleLimit && targets > 0; ++settled) {
+                std::pop_heap(open_.begin(), open_.end(), std::greater<std::pair<float, int>>());
+                auto [distance, node] = open_.back();
+                open_.pop_back();
+                if (distance > limit) {
+                    break;
+                }
+                if (distance > label(node)) {
+                    continue;
+                }
+                if (labels_[node].target == stamp_) {
+                    labels_[node].target = 0;
+                    --targets;
+                }
+                for (const DynamicArc& arc : out[node]) {
+                    if (arc.node == skip || busy[arc.node]) {
+                        continue;
+                    }
+                    float next = distance + arc.cost;
+                    float& best = label(arc.node);
+                    if (next < best && next <= limit) {
+                        best = next;
+                        open_.emplace_back(next, arc.node);
+                        std::push_heap(open_.begin(), open_.end(), std::greater<std::pair<float, int>>());
+                    }
+                }
+            }
+        }
+
+        float distance(int node) const {
+            return labels_[node].stamp == stamp_ ? labels_[node].distance : kInfinity;
+        }
+
+    private:
+        struct Label {
+            std::uint32_t stamp;
+            std::uint32_t target;  // Stamp of the search looking for this node
+            float distance;
+        };
+
+        float& label(int node) {
+            Label& entry = labels_[node];
+            if (entry.stamp != stamp_) {
+                entry.stamp = stamp_;
+                entry.distance = kInfinity;
+            }
+            return entry.distance;
+        }
+
+        std::vector<Label> labels_;
+        std::vector<std::pair<float, int>> open_;
+        std::uint32_t stamp_;
+    };
+
+    // Shortcuts needed around node: for every in-neighbor, a witness search to the
+    // out-neighbors; each one reached more cheaply through node gets a shortcut
+    void findShortcuts(const ArcLists& out, const ArcLists& in, int node, const std::vector<char>& busy,
+                       int settleLimit, WitnessSearch& witness, std::vector<Shortcut>& shortcuts) {
+        for (const DynamicArc& first : in[node]) {
+            float limit = 0.0f;
+            for (const DynamicArc& second : out[node]) {
+                if (second.node != first.node) {
+                    limit = std::max(limit, first.cost + second.cost);
+                }
+            }
+            if (limit == 0.0f) {
+                continue;
+            }
+
+            witness.run(out, first.node, limit, node, busy, settleLimit);
+            for (const DynamicArc& second : out[node]) {
+                float cost = first.cost + second.cost;
+                if (second.node != first.node && witness.distance(second.node) > cost) {
+                    shortcuts.push_back({first.node, second.node, cost, node});
+                }
+            }
+        }
+    }
+
+    void removeArc(std::vector<DynamicArc>& arcs, int node) {
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            if (arcs[i].node == node) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+}
+
+// Constructor
+ContractionHierarchy::ContractionHierarchy()
+    : width_(0), height_(0), revision_(0), cellHash_(0), connectivity_(Connectivity::Four),
+      cornerCutting_(CornerCutting::Forbid), terrainCosts_{}, shortcutCount_(0),
+      stamp_(0), lastPathCost_(0.0f), lastExpansions_(0) {
+}
+
+void ContractionHierarchy::build(const Grid& grid, unsigned int threads) {
+    PF_TRACE_SCOPE("ContractionHierarchy::build");
+
+    width_ = grid.getWidth();
+    height_ = grid.getHeight();
+    revision_ = grid.getRevision();
+    cellHash_ = grid.getCellHash();
+    connectivity_ = grid.getConnectivity();
+    cornerCutting_ = grid.getCornerCutting();
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        terrainCosts_[type] = grid.getTerrainCost(static_cast<CellType>(type));
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // One node per walkable cell, one arc per move
+    nodeAt_.assign(static_cast<size_t>(width_) * height_, -1);
+    positions_.clear();
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            if (grid.isWalkable(x, y)) {
+                nodeAt_[y * width_ + x] = static_cast<int>(positions_.size());
+                positions_.emplace_back(x, y);
+            }
+        }
+    }
+    const size_t count = positions_.size();
+    ArcLists out(count);
+    ArcLists in(count);
+    Position neighbors[Grid::kMaxNeighbors];
+    for (size_t node = 0; node < count; ++node) {
+        int neighborCount = grid.getNeighbors(positions_[node], neighbors);
+        for (int i = 0; i < neighborCount; ++i) {
+            int next = nodeAt(neighbors[i]);
+            float cost = grid.getStepCost(positions_[node], neighbors[i]);
+            out[node].push_back({next, cost, -1});
+            in[next].push_back({static_cast<int>(node), cost, -1});
+        }
+    }
+
+    // Importance: shortcuts added minus arcs removed, plus neighbors already contracted and
+    // the number of levels below (which both spread contractions evenly over the map)
+    std::vector<int> priority(count, 0);
+    std::vector<int> contractedNeighbors(count, 0);
+    std::vector<int> depth(count, 0);
+    std::vector<char> busy(count, 0);
+    std::vector<WitnessSearch> witnesses(threads, WitnessSearch(count));
+    std::vector<std::vector<Shortcut>> found(threads);
+    auto updatePriority = [&](unsigned int worker, int node) {
+        std::vector<Shortcut>& shortcuts = found[worker];
+        shortcuts.clear();
+        findShortcuts(out, in, node, busy, kEstimateSettleLimit, witnesses[worker], shortcuts);
+        priority[node] = static_cast<int>(shortcuts.size()) - static_cast<int>(out[node].size() + in[node].size()) +
+                         contractedNeighbors[node] + depth[node];
+    };
+    parallelFor(count, threads, [&](unsigned int worker, size_t node) { updatePriority(worker, static_cast<int>(node)); });
+
+    std::vector<std::vector<Arc>> up(count);
+    std::vector<std::vector<Arc>> down(count);
+    std::vector<int> remaining(count);
+    for (size_t node = 0; node < count; ++node) {
+        remaining[node] = static_cast<int>(node);
+    }
+    std::vector<int> round;
+    std::vector<int> touched;
+    std::vector<char> isTouched(count, 0);
+    std::vector<char> contracted(count, 0);
+    size_t rounds = 0;
+
+    while (!remaining.empty()) {
+        // Contract the nodes less important than all of their neighbors together: none of
+        // them is next to another, so their shortcuts can be found independently
+        round.clear();
+        auto before = [&](int a, int b) { return priority[a] < priority[b] || (priority[a] == priority[b] && a < b); };
+        for (int node : remaining) {
+            bool least = true;
+            for (const DynamicArc& arc : out[node]) {
+                least = least && before(node, arc.node);
+            }
+            for (const DynamicArc& arc : in[node]) {
+                least = least && before(node, arc.node);
+            }
+            if (least) {
+                round.push_back(node);
+                busy[node] = 1;
+            }
+        }
+
+        for (std::vector<Shortcut>& shortcuts : found) {
+            shortcuts.clear();
+        }
+        parallelFor(round.size(), threads, [&](unsigned int worker, size_t i) {
+            findShortcuts(out, in, round[i], busy, kWitnessSettleLimit, witnesses[worker], found[worker]);
+        });
+
+        // Take the contracted nodes out of the graph; their remaining arcs lead up the order
+        touched.clear();
+        for (int node : round) {
+            for (const DynamicArc& arc : out[node]) {
+                up[node].push_back({arc.node, arc.cost, arc.middle});
+                depth[arc.node] = std::max(depth[arc.node], depth[node] + 1);
+                removeArc(in[arc.node], node);
+                touched.push_back(arc.node);
+            }
+            for (const DynamicArc& arc : in[node]) {
+                down[node].push_back({arc.node, arc.cost, arc.middle});
+                depth[arc.node] = std::max(depth[arc.node], depth[node] + 1);
+                removeArc(out[arc.node], node);
+                touched.push_back(arc.node);
+            }
+            std::vector<DynamicArc>().swap(out[node]);
+            std::vector<DynamicArc>().swap(in[node]);
+            contracted[node] = 1;
+        }
+        for (const std::vector<Shortcut>& shortcuts : found) {
+            for (const Shortcut& shortcut : shortcuts) {
+                std::vector<DynamicArc>& arcs = out[shortcut.from];
+                auto existing = std::find_if(arcs.begin(), arcs.end(),
+                                             [&](const DynamicArc& arc) { return arc.node == shortcut.to; });
+                if (existing == arcs.end()) {
+                    arcs.push_back({shortcut.to, shortcut.cost, shortcut.middle});
+                    in[shortcut.to].push_back({shortcut.from, shortcut.cost, shortcut.middle});
+                } else if (shortcut.cost < existing->cost) {
+                    *existing = {shortcut.to, shortcut.cost, shortcut.middle};
+                    for (DynamicArc& arc : in[shortcut.to]) {
+                        if (arc.node == shortcut.from) {
+                            arc = {shortcut.from, shortcut.cost, shortcut.middle};
+                        }
+                    }
+                }
+            }
+        }
+        for (int node : round) {
+            busy[node] = 0;
+        }
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                       [&](int node) { return contracted[node] != 0; }),
+                        remaining.end());
+
+        // Neighbors lost arcs and may have gained shortcuts
+        size_t unique = 0;
+        for (int node : touched) {
+            if (!isTouched[node]) {
+                isTouched[node] = 1;
+                touched[unique++] = node;
+                contractedNeighbors[node]++;
+            }
+        }
+        touched.resize(unique);
+        parallelFor(touched.size(), threads, [&](unsigned int worker, size_t i) { updatePriority(worker, touched[i]); });
+        for (int node : touched) {
+            isTouched[node] = 0;
+        }
+        ++rounds;
+    }
+
+    // Flatten into the query tables
+    shortcutCount_ = 0;
+    auto flatten = [&](std::vector<std::vector<Arc>>& lists, ArcTable& table) {
+        table.offsets.assign(count + 1, 0);
+        table.arcs.clear();
+        for (size_t node = 0; node < count; ++node) {
+            table.offsets[node] = static_cast<std::uint32_t>(table.arcs.size());
+            for (const Arc& arc : lists[node]) {
+                table.arcs.push_back(arc);
+                shortcutCount_ += arc.middle >= 0;
+            }
+            std::vector<Arc>().swap(lists[node]);
+        }
+        table.offsets[count] = static_cast<std::uint32_t>(table.arcs.size());
+    };
+    flatten(up, up_);
+    flatten(down, down_);
+
+    PF_LOG_DEBUG("Contraction hierarchy of {} nodes with {} shortcuts in {} rounds on {} threads",
+                 count, shortcutCount_, rounds, threads);
+}
+
+bool ContractionHierarchy::isValidFor(const Grid& grid) const {
+    return !nodeAt_.empty() && grid.getRevision() == revision_ && grid.getCellHash() == cellHash_ && sameRules(grid);
+}
+
+bool ContractionHierarchy::sameRules(const Grid& grid) const {
+    if (grid.getWidth() != width_ || grid.getHeight() != height_ ||
+        grid.getConnectivity() != connectivity_ || grid.getCornerCutting() != cornerCutting_) {
+        return false;
+    }
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (grid.getTerrainCost(static_cast<CellType>(type)) != terrainCosts_[type]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ContractionHierarchy::getMemoryBytes() const {
+    return nodeAt_.capacity() * sizeof(int) + positions_.capacity() * sizeof(Position) +
+           (up_.offsets.capacity() + down_.offsets.capacity()) * sizeof(std::uint32_t) +
+           (up_.arcs.capacity() + down_.arcs.capacity()) * sizeof(Arc);
+}
+
+// Dijkstra up the order from both ends at once: forward along up arcs from the start,
+// backward along down arcs from the goal. The best meeting node is final once neither
+// open list holds anything cheaper.
+bool ContractionHierarchy::findPath(const Grid& grid, const Position& start, const Position& goal,
+                                    std::vector<Position>& path) {
+    PF_TRACE_SCOPE("ContractionHierarchy::findPath");
+
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastExpansions_ = 0;
+    int source = nodeAt(start);
+    int target = nodeAt(goal);
+    if (source < 0 || target < 0) {
+        return false;
+    }
+
+    const size_t count = positions_.size();
+    if (++stamp_ == 0) {
+        for (Side& side : sides_) {
+            for (Label& label : side.labels) {
+                label.stamp = 0;
+            }
+        }
+        stamp_ = 1;
+    }
+    auto label = [&](Side& side, int node) -> Label& {
+        Label& entry = side.labels[node];
+        if (entry.stamp != stamp_) {
+            entry = Label{stamp_, kInfinity, -1, -1};
+        }
+        return entry;
+    };
+    const ArcTable* tables[2] = {&up_, &down_};
+    for (int direction = 0; direction < 2; ++direction) {
+        Side& side = sides_[direction];
+        side.labels.resize(count, Label{0, kInfinity, -1, -1});
+        side.open.clear();
+        int from = direction == 0 ? source : target;
+        label(side, from).distance = 0.0f;
+        side.open.emplace_back(0.0f, from);
+    }
+
+    float best = kInfinity;
+    int meeting = -1;
+    for (;;) {
+        float minimum[2];
+        for (int direction = 0; direction < 2; ++direction) {
+            minimum[direction] = sides_[direction].open.empty() ? kInfinity : sides_[direction].open.front().first;
+        }
+        int direction = minimum[0] <= minimum[1] ? 0 : 1;
+        if (minimum[direction] >= best) {
+            break;
+        }
+
+        Side& side = sides_[direction];
+        std::pop_heap(side.open.begin(), side.open.end(), std::greater<std::pair<float, int>>());
+        auto [distance, node] = side.open.back();
+        side.open.pop_back();
+        if (distance > label(side, node).distance) {
+            continue;
+        }
+        ++lastExpansions_;
+
+        // Stall nodes reached more cheaply from above: the search through them cannot
+        // be part of a shortest path
+        const ArcTable& reverse = *tables[1 - direction];
+        bool stalled = false;
+        for (const Arc* arc = reverse.begin(node); arc != reverse.end(node) && !stalled; ++arc) {
+            stalled = label(side, arc->node).distance + arc->cost < distance;
+        }
+        if (stalled) {
+            continue;
+        }
+
+        float through = distance + label(sides_[1 - direction], node).distance;
+        if (through < best) {
+            best = through;
+            meeting = node;
+        }
+
+        const ArcTable& table = *tables[direction];
+        for (const Arc* arc = table.begin(node); arc != table.end(node); ++arc) {
+            Label& next = label(side, arc->node);
+            if (distance + arc->cost < next.distance) {
+                next.distance = distance + arc->cost;
+                next.parent = node;
+                next.middle = arc->middle;
+                side.open.emplace_back(next.distance, arc->node);
+                std::push_heap(side.open.begin(), side.open.end(), std::greater<std::pair<float, int>>());
+            }
+        }
+    }
+
+    if (meeting < 0) {
+        return false;
+    }
+
+    // Arcs from the start up to the meeting node, then down to the goal
+    std::vector<int> forward;
+    for (int node = meeting; node != source; node = sides_[0].labels[node].parent) {
+        forward.push_back(node);
+    }
+    path.push_back(start);
+    int previous = source;
+    for (auto it = forward.rbegin(); it != forward.rend(); ++it) {
+        unpack(previous, *it, sides_[0].labels[*it].middle, path);
+        previous = *it;
+    }
+    for (int node = meeting; node != target; node = sides_[1].labels[node].parent) {
+        unpack(node, sides_[1].labels[node].parent, sides_[1].labels[node].middle, path);
+    }
+
+    // Summed move by move, as a search over the grid adds them up
+    for (size_t i = 1; i < path.size(); ++i) {
+        lastPathCost_ += grid.getStepCost(path[i - 1], path[i]);
+    }
+    return true;
+}
+
+void ContractionHierarchy::unpack(int from, int to, int middle, std::vector<Position>& path) const {
+    struct Piece {
+        int from, to, middle;
+    };
+    std::vector<Piece> pieces(1, Piece{from, to, middle});
+
+    // A shortcut from -> to skips a node contracted before both ends, so its two halves
+    // are among that node's down and up arcs
+    while (!pieces.empty()) {
+        Piece piece = pieces.back();
+        pieces.pop_back();
+        if (piece.middle < 0) {
+            path.push_back(positions_[piece.to]);
+            continue;
+        }
+        int skipped = piece.middle;
+        int firstMiddle = -1;
+        int secondMiddle = -1;
+        for (const Arc* arc = down_.begin(skipped); arc != down_.end(skipped); ++arc) {
+            if (arc->node == piece.from) {
+                firstMiddle = arc->middle;
+            }
+        }
+        for (const Arc* arc = up_.begin(skipped); arc != up_.end(skipped); ++arc) {
+            if (arc->node == piece.to) {
+                secondMiddle = arc->middle;
+            }
+        }
+        pieces.push_back({skipped, piece.to, secondMiddle});
+        pieces.push_back({piece.from, skipped, firstMiddle});
+    }
+}
@@ -0,0 +1,148 @@
+#include "pathfinding/fringesearch.h"
+#include "pathfinding/gridstate.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+}
+
+// Constructor
+FringeSearch::FringeSearch(size_t memoryBudget) : generation_(0), head_(-1) {
+    size_t tableSize = tableSizeFor(memoryBudget, sizeof(Slot));
+    slots_.assign(tableSize, Slot{0, 0, 0.0f, -1, -1, -1, false});
+    mask_ = tableSize - 1;
+    shift_ = hashShift(tableSize);
+    maxNodes_ = tableSize - tableSize / 4;
+}
+
+bool FringeSearch::findPath(const Grid& grid, const Position& start, const Position& goal,
+                            std::vector<Position>& path) {
+    PF_TRACE_SCOPE("FringeSearch::findPath");
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastExpansions_ = 0;
+    lastOutOfMemory_ = false;
+    
+    // On wrap-around old stamps could look current again, so clear them once
+    if (++generation_ == 0) {
+        for (Slot& slot : slots_) {
+            slot.generation = 0;
+        }
+        generation_ = 1;
+    }
+    
+    const int width = grid.getWidth();
+    const Connectivity connectivity = grid.getConnectivity();
+    const float minCost = grid.getMinMoveCost();
+    auto estimate = [&](const Position& pos) {
+        return GridState::estimate(pos, goal, connectivity) * minCost;
+    };
+    
+    int startSlot = findSlot(start.y * width + start.x);
+    slots_[startSlot] = Slot{generation_, start.y * width + start.x, 0.0f, -1, -1, -1, true};
+    head_ = startSlot;
+    size_t nodes = 1;
+    
+    Position neighbors[Grid::kMaxNeighbors];
+    float limit = estimate(start);
+    int goalSlot = -1;
+    
+    while (head_ != -1 && goalSlot == -1) {
+        float nextLimit = kInfinity;
+        
+        for (int current = head_; current != -1;) {
+            Slot& node = slots_[current];
+            Position pos(node.cell % width, node.cell / width);
+            
+            float f = node.g + estimate(pos);
+            if (f > limit) {
+                nextLimit = std::min(nextLimit, f);
+                current = node.next;
+                continue;
+            }
+            if (pos == goal) {
+                goalSlot = current;
+                break;
+            }
+            
+            // Children go right after their parent, so they are visited in this same sweep
+            lastExpansions_++;
+            int count = grid.getNeighbors(pos, neighbors);
+            for (int i = count - 1; i >= 0; --i) {
+                int cell = neighbors[i].y * width + neighbors[i].x;
+                float g = slots_[current].g + grid.getStepCost(pos, neighbors[i]);
+                
+                int child = findSlot(cell);
+                if (slots_[child].generation == generation_) {
+                    if (g >= slots_[child].g) {
+                        continue;
+                    }
+                    if (slots_[child].inFringe) {
+                        unlink(child);
+                    }
+                } else {
+                    if (nodes == maxNodes_) {
+                        lastOutOfMemory_ = true;
+                        return false;
+                    }
+                    nodes++;
+                }
+                
+                slots_[child] = Slot{generation_, cell, g, current, -1, -1, false};
+                linkAfter(child, current);
+            }
+            
+            int next = slots_[current].next;
+            unlink(current);
+            current = next;
+        }
+        
+        limit = nextLimit;
+    }
+    
+    if (goalSlot == -1) {
+        return false;
+    }
+    
+    lastPathCost_ = slots_[goalSlot].g;
+    for (int slot = goalSlot; slot != -1; slot = slots_[slot].parent) {
+        path.push_back(Position(slots_[slot].cell % width, slots_[slot].cell / width));
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+int FringeSearch::findSlot(int cell) const {
+    size_t index = hashCell(cell, shift_);
+    while (slots_[index].generation == generation_ && slots_[index].cell != cell) {
+        index = (index + 1) & mask_;
+    }
+    return static_cast<int>(index);
+}
+
+void FringeSearch::linkAfter(int slot, int after) {
+    Slot& node = slots_[slot];
+    node.prev = after;
+    node.next = slots_[after].next;
+    if (node.next != -1) {
+        slots_[node.next].prev = slot;
+    }
+    slots_[after].next = slot;
+    node.inFringe = true;
+}
+
+void FringeSearch::unlink(int slot) {
+    Slot& node = slots_[slot];
+    if (node.prev != -1) {
+        slots_[node.prev].next = node.next;
+    } else {
+        head_ = node.next;
+    }
+    if (node.next != -1) {
+        slots_[node.next].prev = node.prev;
+    }
+    node.prev = node.next = -1;
+    node.inFringe = false;
+}
@@ -0,0 +1,160 @@
+#include "pathfinding/goalbounds.h"
+#include "pathfinding/griddijkstra.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+    const GoalBounds::Box kEmptyBox = {0xffff, 0xffff, 0, 0};
+
+    // Cells handed to a thread at a time
+    const size_t kChunkSize = 16;
+
+    void extend(GoalBounds::Box& box, const Position& pos) {
+        box.minX = std::min<std::uint16_t>(box.minX, static_cast<std::uint16_t>(pos.x));
+        box.minY = std::min<std::uint16_t>(box.minY, static_cast<std::uint16_t>(pos.y));
+        box.maxX = std::max<std::uint16_t>(box.maxX, static_cast<std::uint16_t>(pos.x));
+        box.maxY = std::max<std::uint16_t>(box.maxY, static_cast<std::uint16_t>(pos.y));
+    }
+}
+
+// Constructor
+GoalBounds::GoalBounds()
+    : width_(0), height_(0), revision_(0), cellHash_(0), connectivity_(Connectivity::Four),
+      cornerCutting_(CornerCutting::Forbid), terrainCosts_{} {
+}
+
+bool GoalBounds::build(const Grid& grid, unsigned int threads) {
+    PF_TRACE_SCOPE("GoalBounds::build");
+
+    boxes_.clear();
+    width_ = 0;
+    height_ = 0;
+    if (grid.getWidth() > kMaxSide || grid.getHeight() > kMaxSide) {
+        PF_LOG_WARNING("Grid of {}x{} is too large for goal bounds", grid.getWidth(), grid.getHeight());
+        return false;
+    }
+
+    width_ = grid.getWidth();
+    height_ = grid.getHeight();
+    connectivity_ = grid.getConnectivity();
+    cornerCutting_ = grid.getCornerCutting();
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        terrainCosts_[type] = grid.getTerrainCost(static_cast<CellType>(type));
+    }
+    boxes_.assign(static_cast<size_t>(width_) * height_ * Grid::kMaxNeighbors, kEmptyBox);
+
+    compute(grid, nullptr, threads);
+    revision_ = grid.getRevision();
+    cellHash_ = grid.getCellHash();
+    return true;
+}
+
+size_t GoalBounds::rebuild(const Grid& grid, const Position& regionMin, const Position& regionMax,
+                           unsigned int threads) {
+    PF_TRACE_SCOPE("GoalBounds::rebuild");
+
+    if (boxes_.empty() || !sameRules(grid)) {
+        return build(grid, threads) ? static_cast<size_t>(width_) * height_ : 0;
+    }
+
+    // An edit only matters to sources that reach the edited cell, or a neighbor of it when
+    // it opens up or changes which corners can be cut: those whose reachable area, grown
+    // by one cell, touches the region
+    std::vector<int> cells;
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            Position pos(x, y);
+            Box reach = {static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y),
+                         static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y)};
+            const Box* moves = &boxes_[cellIndex(pos)];
+            for (int slot = 0; slot < Grid::kMaxNeighbors; ++slot) {
+                if (moves[slot].minX <= moves[slot].maxX) {
+                    extend(reach, Position(moves[slot].minX, moves[slot].minY));
+                    extend(reach, Position(moves[slot].maxX, moves[slot].maxY));
+                }
+            }
+
+            if (reach.minX - 1 <= regionMax.x && reach.maxX + 1 >= regionMin.x &&
+                reach.minY - 1 <= regionMax.y && reach.maxY + 1 >= regionMin.y) {
+                cells.push_back(y * width_ + x);
+            }
+        }
+    }
+
+    compute(grid, &cells, threads);
+    revision_ = grid.getRevision();
+    cellHash_ = grid.getCellHash();
+    PF_LOG_DEBUG("Goal bounds rebuilt for {} of {} cells", cells.size(), static_cast<size_t>(width_) * height_);
+    return cells.size();
+}
+
+bool GoalBounds::isValidFor(const Grid& grid) const {
+    return !boxes_.empty() && grid.getRevision() == revision_ && grid.getCellHash() == cellHash_ && sameRules(grid);
+}
+
+bool GoalBounds::sameRules(const Grid& grid) const {
+    if (grid.getWidth() != width_ || grid.getHeight() != height_ ||
+        grid.getConnectivity() != connectivity_ || grid.getCornerCutting() != cornerCutting_) {
+        return false;
+    }
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (grid.getTerrainCost(static_cast<CellType>(type)) != terrainCosts_[type]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One Dijkstra search per source, recording for every cell which first moves from the
+// source start a shortest path to it; the cell then extends the box of each of those moves
+void GoalBounds::compute(const Grid& grid, const std::vector<int>* cells, unsigned int threads) {
+    size_t count = cells ? cells->size() : static_cast<size_t>(width_) * height_;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(std::min<size_t>(threads, (count + kChunkSize - 1) / kChunkSize));
+
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        GridDijkstra dijkstra;
+        for (size_t begin = nextChunk.fetch_add(kChunkSize); begin < count; begin = nextChunk.fetch_add(kChunkSize)) {
+            for (size_t i = begin; i < std::min(begin + kChunkSize, count); ++i) {
+                int source = cells ? (*cells)[i] : static_cast<int>(i);
+                Position sourcePos(source % width_, source / width_);
+                Box* moves = &boxes_[cellIndex(sourcePos)];
+                std::fill(moves, moves + Grid::kMaxNeighbors, kEmptyBox);
+                if (!grid.isWalkable(sourcePos)) {
+                    continue;
+                }
+
+                dijkstra.firstMovesFrom(grid, sourcePos);
+                for (int y = 0; y < height_; ++y) {
+                    for (int x = 0; x < width_; ++x) {
+                        Position pos(x, y);
+                        std::uint8_t firstMoves = dijkstra.getFirstMoves(pos);
+                        for (int move = 0; firstMoves != 0; ++move, firstMoves >>= 1) {
+                            if (firstMoves & 1) {
+                                extend(moves[move], pos);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    // Each source writes only its own boxes, so threads share nothing else
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    PF_LOG_DEBUG("Goal bounds computed for {} cells on {} threads", count, std::max(threads, 1u));
+}
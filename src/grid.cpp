@@ -1,8 +1,132 @@
 #include "pathfinding/grid.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
 
-Grid::Grid(int width, int height) : width_(width), height_(height) {
-    // Initialize grid with all empty cells
-    cells_.resize(height_, std::vector<CellType>(width_, CellType::Empty));
+namespace {
+    // Default cost of entering each cell type, indexed by CellType
+    const float kDefaultTerrainCosts[kCellTypeCount] = {
+        1.0f,                                       // Empty
+        std::numeric_limits<float>::infinity(),     // Wall
+        0.5f,                                       // Road
+        2.0f,                                       // Mud
+        4.0f                                        // Water
+    };
+    
+    // Neighbor offsets: the four cardinal moves, then the four diagonal ones
+    const int kNeighborX[Grid::kMaxNeighbors] = {0, 1, 0, -1, 1, 1, -1, -1};
+    const int kNeighborY[Grid::kMaxNeighbors] = {-1, 0, 1, 0, -1, 1, 1, -1};
+    
+    // Contribution of one cell to the cell hash (zero for empty cells, so a new grid hashes
+    // to zero): a splitmix64 scramble of the cell and its type
+    std::uint64_t cellKey(int x, int y, CellType type) {
+        if (type == CellType::Empty) {
+            return 0;
+        }
+        std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(y)) << 35) ^
+                            (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 3) ^
+                            static_cast<std::uint8_t>(type);
+        key += 0x9e3779b97f4a7c15ull;
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+        return key ^ (key >> 31);
+    }
+    
+    // The two cardinal moves (indices above) each diagonal move passes between
+    const int kDiagonalSides[4][2] = {{0, 1}, {2, 1}, {2, 3}, {0, 3}};
+}
+
+// Constructor
+GridLine::GridLine(const Position& from, const Position& to, Connectivity connectivity)
+    : current_(from), to_(to), connectivity_(connectivity),
+      nx_(abs(to.x - from.x)), ny_(abs(to.y - from.y)),
+      sx_(to.x < from.x ? -1 : 1), sy_(to.y < from.y ? -1 : 1),
+      ix_(0), iy_(0), error_(nx_ - ny_) {
+}
+
+const Position& GridLine::next() {
+    if (connectivity_ == Connectivity::Eight) {
+        int doubled = 2 * error_;
+        if (doubled > -ny_) {
+            error_ -= ny_;
+            current_.x += sx_;
+        }
+        if (doubled < nx_) {
+            error_ += nx_;
+            current_.y += sy_;
+        }
+        return current_;
+    }
+    
+    // Step along whichever axis the segment crosses a cell border on first;
+    // through an exact corner, x goes first
+    if (iy_ == ny_ || (ix_ < nx_ && (1 + 2 * ix_) * ny_ <= (1 + 2 * iy_) * nx_)) {
+        current_.x += sx_;
+        ix_++;
+    } else {
+        current_.y += sy_;
+        iy_++;
+    }
+    return current_;
+}
+
+Grid::Grid(int width, int height)
+    : width_(width), height_(height), revision_(0), cellHash_(0),
+      connectivity_(Connectivity::Four), cornerCutting_(CornerCutting::Forbid), nextSubscriptionId_(1) {
+    blocksX_ = (std::max(width_, 0) + kBlockSize - 1) / kBlockSize;
+    blocksY_ = (std::max(height_, 0) + kBlockSize - 1) / kBlockSize;
+    
+    // Initialize grid with all empty cells - every block starts out sharing one tile
+    auto emptyTile = std::make_shared<Tile>();
+    emptyTile->cells.fill(CellType::Empty);
+    emptyTile->wallRows.fill(0);
+    tiles_.assign(blocksX_ * blocksY_, emptyTile);
+    
+    std::copy(kDefaultTerrainCosts, kDefaultTerrainCosts + kCellTypeCount, terrainCosts_.begin());
+    cellCounts_.fill(0);
+    cellCounts_[static_cast<int>(CellType::Empty)] = static_cast<size_t>(std::max(width_, 0)) * std::max(height_, 0);
+    updateCostSummary();
+    
+    dirtyBlocks_.assign(blocksX_ * blocksY_, 0);
+    pendingBlocks_.assign(blocksX_ * blocksY_, 0);
+    pending_.fromRevision = 0;
+    pending_.toRevision = 0;
+    pending_.cellHash = 0;
+}
+
+Grid::Grid(const Grid& other)
+    : width_(other.width_), height_(other.height_),
+      blocksX_(other.blocksX_), blocksY_(other.blocksY_),
+      tiles_(other.tiles_), revision_(other.revision_), cellHash_(other.cellHash_),
+      terrainCosts_(other.terrainCosts_), cellCounts_(other.cellCounts_),
+      minMoveCost_(other.minMoveCost_), uniformCosts_(other.uniformCosts_),
+      connectivity_(other.connectivity_), cornerCutting_(other.cornerCutting_),
+      dirtyBlocks_(other.dirtyBlocks_), nextSubscriptionId_(1) {
+    pendingBlocks_.assign(blocksX_ * blocksY_, 0);
+    pending_.fromRevision = revision_;
+    pending_.toRevision = revision_;
+    pending_.cellHash = cellHash_;
+}
+
+Grid& Grid::operator=(const Grid& other) {
+    if (this != &other) {
+        Grid copy(other);
+        copy.listeners_ = std::move(listeners_);
+        copy.nextSubscriptionId_ = nextSubscriptionId_;
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+bool Grid::sharesBlockWith(const Grid& other, int blockX, int blockY) const {
+    if (blockX < 0 || blockX >= blocksX_ || blockY < 0 || blockY >= blocksY_ ||
+        blocksX_ != other.blocksX_ || blocksY_ != other.blocksY_) {
+        return false;
+    }
+    int index = blockY * blocksX_ + blockX;
+    return tiles_[index] == other.tiles_[index];
 }
 
 bool Grid::isWalkable(const Position& pos) const {
@@ -13,7 +137,7 @@ bool Grid::isWalkable(int x, int y) const {
     if (!isInBounds(x, y)) {
         return false; // Out of bounds = not walkable
     }
-    return cells_[y][x] == CellType::Empty;
+    return !wallAt(x, y);
 }
 
 bool Grid::isInBounds(const Position& pos) const {
@@ -24,13 +148,84 @@ bool Grid::isInBounds(int x, int y) const {
     return x >= 0 && x < width_ && y >= 0 && y < height_;
 }
 
+bool Grid::canMove(const Position& from, const Position& to) const {
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    if (dx < -1 || dx > 1 || dy < -1 || dy > 1 || (dx == 0 && dy == 0) || !isWalkable(to)) {
+        return false;
+    }
+    if (dx == 0 || dy == 0) {
+        return true;
+    }
+    if (connectivity_ == Connectivity::Four) {
+        return false;
+    }
+    
+    bool first = isWalkable(to.x, from.y);
+    bool second = isWalkable(from.x, to.y);
+    switch (cornerCutting_) {
+        case CornerCutting::Allow:
+            return true;
+        case CornerCutting::NoSqueeze:
+            return first || second;
+        case CornerCutting::Forbid:
+            return first && second;
+    }
+    return false;
+}
+
+bool Grid::hasLineOfSight(const Position& from, const Position& to, float* cost) const {
+    if (!isWalkable(from)) {
+        return false;
+    }
+    
+    float total = 0.0f;
+    GridLine line(from, to, connectivity_);
+    while (!line.done()) {
+        Position previous = line.current();
+        const Position& next = line.next();
+        if (!canMove(previous, next)) {
+            return false;
+        }
+        if (cost) {
+            total += getStepCost(previous, next);
+        }
+    }
+    
+    if (cost) {
+        *cost = total;
+    }
+    return true;
+}
+
 void Grid::setCell(const Position& pos, CellType type) {
     setCell(pos.x, pos.y, type);
 }
 
 void Grid::setCell(int x, int y, CellType type) {
-    if (isInBounds(x, y)) {
-        cells_[y][x] = type;
+    if (isInBounds(x, y) && cellAt(x, y) != type) {
+        CellType oldType = cellAt(x, y);
+        Tile& tile = writableTile((y / kBlockSize) * blocksX_ + (x / kBlockSize));
+        tile.cells[(y % kBlockSize) * kBlockSize + (x % kBlockSize)] = type;
+        std::uint32_t bit = 1u << (x % kBlockSize);
+        if (type == CellType::Wall) {
+            tile.wallRows[y % kBlockSize] |= bit;
+        } else {
+            tile.wallRows[y % kBlockSize] &= ~bit;
+        }
+        revision_++;
+        cellHash_ ^= cellKey(x, y, oldType) ^ cellKey(x, y, type);
+        
+        // The cost summary only moves when a type appears or disappears
+        size_t& oldCount = cellCounts_[static_cast<int>(oldType)];
+        size_t& newCount = cellCounts_[static_cast<int>(type)];
+        --oldCount;
+        ++newCount;
+        if (oldCount == 0 || newCount == 1) {
+            updateCostSummary();
+        }
+        
+        recordChange(x, y, oldType, type);
     }
 }
 
@@ -42,31 +237,229 @@ CellType Grid::getCell(int x, int y) const {
     if (!isInBounds(x, y)) {
         return CellType::Wall; // Treat out of bounds as walls
     }
-    return cells_[y][x];
+    return cellAt(x, y);
+}
+
+bool Grid::setTerrainCost(CellType type, float cost) {
+    if (type == CellType::Wall || !(cost > 0.0f) || cost == std::numeric_limits<float>::infinity()) {
+        return false;
+    }
+    
+    float& current = terrainCosts_[static_cast<int>(type)];
+    if (current != cost) {
+        current = cost;
+        updateCostSummary();
+        movementChanged();
+    }
+    return true;
+}
+
+float Grid::getMinTerrainCost() const {
+    float best = std::numeric_limits<float>::infinity();
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (type != static_cast<int>(CellType::Wall)) {
+            best = std::min(best, terrainCosts_[type]);
+        }
+    }
+    return best;
+}
+
+void Grid::setMovement(Connectivity connectivity, CornerCutting cornerCutting) {
+    if (connectivity != connectivity_ || cornerCutting != cornerCutting_) {
+        connectivity_ = connectivity;
+        cornerCutting_ = cornerCutting;
+        movementChanged();
+    }
+}
+
+// Every path may have changed cost: deliver earlier edits first, then bump the
+// revision so subscribers see a gap and drop what they derived from the grid
+void Grid::movementChanged() {
+    flushChanges();
+    revision_++;
+    std::fill(dirtyBlocks_.begin(), dirtyBlocks_.end(), 1);
+}
+
+void Grid::updateCostSummary() {
+    minMoveCost_ = std::numeric_limits<float>::infinity();
+    float maxMoveCost = 0.0f;
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (type == static_cast<int>(CellType::Wall) || cellCounts_[type] == 0) {
+            continue;
+        }
+        minMoveCost_ = std::min(minMoveCost_, terrainCosts_[type]);
+        maxMoveCost = std::max(maxMoveCost, terrainCosts_[type]);
+    }
+    
+    // An all-wall grid has nothing to walk on; keep the heuristic finite
+    if (maxMoveCost == 0.0f) {
+        minMoveCost_ = terrainCosts_[static_cast<int>(CellType::Empty)];
+        maxMoveCost = minMoveCost_;
+    }
+    uniformCosts_ = minMoveCost_ == maxMoveCost;
+}
+
+// Copy-on-write: duplicate the block's tile if a snapshot still references it
+Grid::Tile& Grid::writableTile(int blockIndex) {
+    std::shared_ptr<const Tile>& tile = tiles_[blockIndex];
+    
+    if (tile.use_count() != 1) {
+        tile = std::make_shared<Tile>(*tile);
+    } else {
+        // Pairs with the release of the last snapshot reference so its reads
+        // of the tile happen before we overwrite it
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    
+    // Only this grid references the tile now
+    return const_cast<Tile&>(*tile);
+}
+
+bool Grid::isBlockDirty(int blockX, int blockY) const {
+    if (blockX < 0 || blockX >= blocksX_ || blockY < 0 || blockY >= blocksY_) {
+        return false;
+    }
+    return dirtyBlocks_[blockY * blocksX_ + blockX] != 0;
+}
+
+std::vector<Position> Grid::getDirtyBlocks() const {
+    std::vector<Position> blocks;
+    for (int by = 0; by < blocksY_; ++by) {
+        for (int bx = 0; bx < blocksX_; ++bx) {
+            if (dirtyBlocks_[by * blocksX_ + bx]) {
+                blocks.push_back(Position(bx, by));
+            }
+        }
+    }
+    return blocks;
+}
+
+void Grid::clearDirtyBlocks() {
+    std::fill(dirtyBlocks_.begin(), dirtyBlocks_.end(), 0);
+}
+
+GridSubscriptionId Grid::subscribe(GridChangeListener listener) {
+    GridSubscriptionId id = nextSubscriptionId_++;
+    listeners_.push_back({id, std::move(listener)});
+    return id;
+}
+
+void Grid::unsubscribe(GridSubscriptionId id) {
+    for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+        if (it->first == id) {
+            listeners_.erase(it);
+            return;
+        }
+    }
+}
+
+// Deliver the collected batch to every subscriber
+void Grid::flushChanges() {
+    PF_TRACE_SCOPE("Grid::flushChanges");
+    if (pending_.changes.empty()) {
+        return;
+    }
+    
+    GridChangeBatch batch;
+    batch.fromRevision = pending_.fromRevision;
+    batch.toRevision = revision_;
+    batch.cellHash = cellHash_;
+    
+    // Cells edited and restored within the batch did not change; the batch is still
+    // delivered so subscribers follow the revision
+    for (const CellChange& change : pending_.changes) {
+        if (change.oldType == change.newType) {
+            continue;
+        }
+        batch.changes.push_back(change);
+        int block = (change.position.y / kBlockSize) * blocksX_ + (change.position.x / kBlockSize);
+        if (!pendingBlocks_[block]) {
+            pendingBlocks_[block] = 1;
+            batch.blocks.push_back(Position(change.position.x / kBlockSize, change.position.y / kBlockSize));
+        }
+    }
+    
+    pending_.changes.clear();
+    pendingIndex_.clear();
+    for (const Position& block : batch.blocks) {
+        pendingBlocks_[block.y * blocksX_ + block.x] = 0;
+    }
+    
+    // Copy so listeners may subscribe or unsubscribe while being notified
+    auto listeners = listeners_;
+    for (const auto& listener : listeners) {
+        listener.second(batch);
+    }
+}
+
+void Grid::recordChange(int x, int y, CellType oldType, CellType newType) {
+    int block = (y / kBlockSize) * blocksX_ + (x / kBlockSize);
+    dirtyBlocks_[block] = 1;
+    
+    // Nobody listening - nothing to batch
+    if (listeners_.empty()) {
+        return;
+    }
+    
+    if (pending_.changes.empty()) {
+        pending_.fromRevision = revision_ - 1;
+    }
+    
+    // Repeated edits of a cell collapse into a single entry
+    int cellIndex = y * width_ + x;
+    auto existing = pendingIndex_.find(cellIndex);
+    if (existing != pendingIndex_.end()) {
+        pending_.changes[existing->second].newType = newType;
+    } else {
+        pendingIndex_[cellIndex] = pending_.changes.size();
+        pending_.changes.push_back({Position(x, y), oldType, newType});
+    }
+
 }
 
 std::vector<Position> Grid::getNeighbors(const Position& pos) const {
-    std::vector<Position> neighbors;
-    
-    // Check 4 cardinal directions (for A* pathfinding)
-    std::vector<Position> directions = {
-        {0, -1},  // North
-        {1, 0},   // East
-        {0, 1},   // South
-        {-1, 0}   // West
-    };
+    Position neighbors[kMaxNeighbors];
+    int count = getNeighbors(pos, neighbors);
+    return std::vector<Position>(neighbors, neighbors + count);
+}
+
+int Grid::getNeighbors(const Position& pos, Position* out) const {
+    int count = 0;
     
-    for (const auto& dir : directions) {
-        Position neighbor(pos.x + dir.x, pos.y + dir.y);
+    // Cardinal directions: north, east, south, west
+    bool open[4];
+    for (int d = 0; d < 4; ++d) {
+        Position neighbor(pos.x + kNeighborX[d], pos.y + kNeighborY[d]);
+        open[d] = isWalkable(neighbor);
+        if (open[d]) {
+            out[count++] = neighbor;
+        }
+    }
+    
+    if (connectivity_ == Connectivity::Four) {
+        return count;
+    }
+    
+    // Diagonals: northeast, southeast, southwest, northwest
+    for (int d = 0; d < 4; ++d) {
+        bool first = open[kDiagonalSides[d][0]];
+        bool second = open[kDiagonalSides[d][1]];
+        if ((cornerCutting_ == CornerCutting::Forbid && !(first && second)) ||
+            (cornerCutting_ == CornerCutting::NoSqueeze && !(first || second))) {
+            continue;
+        }
+        
+        Position neighbor(pos.x + kNeighborX[4 + d], pos.y + kNeighborY[4 + d]);
         if (isWalkable(neighbor)) {
-            neighbors.push_back(neighbor);
+            out[count++] = neighbor;
         }
     }
     
-    return neighbors;
+    return count;
 }
 
 void Grid::render(sf::RenderWindow& window, float tileSize) const {
+    PF_TRACE_SCOPE("Grid::render");
     sf::RectangleShape tile(sf::Vector2f(tileSize - 1, tileSize - 1));
     
     for (int y = 0; y < height_; ++y) {
@@ -74,13 +467,22 @@ void Grid::render(sf::RenderWindow& window, float tileSize) const {
             tile.setPosition({x * tileSize, y * tileSize});
             
             // Color based on cell type
-            switch (cells_[y][x]) {
+            switch (cellAt(x, y)) {
                 case CellType::Empty:
                     tile.setFillColor(sf::Color::White);
                     break;
                 case CellType::Wall:
                     tile.setFillColor(sf::Color::Red);
                     break;
+                case CellType::Road:
+                    tile.setFillColor(sf::Color(190, 190, 190));
+                    break;
+                case CellType::Mud:
+                    tile.setFillColor(sf::Color(140, 100, 50));
+                    break;
+                case CellType::Water:
+                    tile.setFillColor(sf::Color(80, 140, 230));
+                    break;
             }
             
             window.draw(tile);
@@ -0,0 +1,194 @@
+#include "pathfinding/griddijkstra.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+}
+
+// Constructor
+GridDijkstra::GridDijkstra() : width_(0), height_(0), generation_(0), firstMovesValid_(false), lastExpansions_(0) {
+}
+
+size_t GridDijkstra::distancesTo(const Grid& grid, const Position& source,
+                                 const std::vector<Position>& targets, std::vector<float>& distances) {
+    begin(grid);
+    distances.assign(targets.size(), kInfinity);
+    
+    if (!grid.isInBounds(source) || !grid.isWalkable(source)) {
+        return 0;
+    }
+    
+    // Count each distinct reachable-looking target once
+    size_t pending = 0;
+    for (const Position& target : targets) {
+        if (!grid.isInBounds(target) || !grid.isWalkable(target)) {
+            continue;
+        }
+        int cell = target.y * width_ + target.x;
+        if (target_[cell] != generation_) {
+            target_[cell] = generation_;
+            pending++;
+        }
+    }
+    
+    if (pending > 0) {
+        run(grid, source, kInfinity, pending);
+    }
+    
+    size_t reachable = 0;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        distances[i] = getDistance(targets[i]);
+        if (distances[i] != kInfinity) {
+            reachable++;
+        }
+    }
+    return reachable;
+}
+
+void GridDijkstra::expandFrom(const Grid& grid, const Position& source, float maxCost) {
+    begin(grid);
+    if (grid.isInBounds(source) && grid.isWalkable(source)) {
+        run(grid, source, maxCost, 0);
+    }
+}
+
+void GridDijkstra::firstMovesFrom(const Grid& grid, const Position& source) {
+    begin(grid);
+    if (grid.isInBounds(source) && grid.isWalkable(source)) {
+        run(grid, source, kInfinity, 0, true);
+        firstMovesValid_ = true;
+    }
+}
+
+float GridDijkstra::getDistance(const Position& pos) const {
+    if (pos.x < 0 || pos.y < 0 || pos.x >= width_ || pos.y >= height_) {
+        return kInfinity;
+    }
+    int cell = pos.y * width_ + pos.x;
+    return settled_[cell] == generation_ ? distance_[cell] : kInfinity;
+}
+
+std::uint8_t GridDijkstra::getFirstMoves(const Position& pos) const {
+    if (!firstMovesValid_ || pos.x < 0 || pos.y < 0 || pos.x >= width_ || pos.y >= height_) {
+        return 0;
+    }
+    int cell = pos.y * width_ + pos.x;
+    return settled_[cell] == generation_ ? firstMoves_[cell] : 0;
+}
+
+void GridDijkstra::begin(const Grid& grid) {
+    if (grid.getWidth() != width_ || grid.getHeight() != height_) {
+        width_ = grid.getWidth();
+        height_ = grid.getHeight();
+        size_t cells = static_cast<size_t>(width_) * height_;
+        distance_.assign(cells, kInfinity);
+        reached_.assign(cells, 0);
+        settled_.assign(cells, 0);
+        target_.assign(cells, 0);
+        firstMoves_.assign(cells, 0);
+        generation_ = 0;
+    }
+    
+    // On wrap-around old stamps could look current again, so clear them once
+    if (++generation_ == 0) {
+        std::fill(reached_.begin(), reached_.end(), 0);
+        std::fill(settled_.begin(), settled_.end(), 0);
+        std::fill(target_.begin(), target_.end(), 0);
+        generation_ = 1;
+    }
+    
+    heap_.clear();
+    firstMovesValid_ = false;
+    lastExpansions_ = 0;
+}
+
+void GridDijkstra::run(const Grid& grid, const Position& source, float maxCost, size_t pendingTargets,
+                       bool firstMoves) {
+    if (firstMoves) {
+        if (grid.hasUniformCosts()) {
+            runKernel<true, true>(grid, source, maxCost, pendingTargets);
+        } else {
+            runKernel<false, true>(grid, source, maxCost, pendingTargets);
+        }
+    } else if (grid.hasUniformCosts()) {
+        runKernel<true, false>(grid, source, maxCost, pendingTargets);
+    } else {
+        runKernel<false, false>(grid, source, maxCost, pendingTargets);
+    }
+}
+
+// Step costs match GridState::GetCost, so both searches agree on distances. First moves of
+// a cell are final once it is settled, since every predecessor on a shortest path costs
+// strictly less and was settled before it.
+template <bool UniformCosts, bool FirstMoves>
+void GridDijkstra::runKernel(const Grid& grid, const Position& source, float maxCost, size_t pendingTargets) {
+    const float uniformCost = grid.getMinMoveCost();
+    const float uniformDiagonalCost = uniformCost * Grid::kDiagonalCost;
+    Position neighbors[Grid::kMaxNeighbors];
+    
+    int sourceCell = source.y * width_ + source.x;
+    distance_[sourceCell] = 0.0f;
+    reached_[sourceCell] = generation_;
+    if (FirstMoves) {
+        firstMoves_[sourceCell] = 0;
+    }
+    heap_.push_back({0.0f, sourceCell});
+    
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<QueueEntry>());
+        QueueEntry entry = heap_.back();
+        heap_.pop_back();
+        
+        // Stale entry left behind by a later improvement
+        if (settled_[entry.cell] == generation_) {
+            continue;
+        }
+        if (entry.cost > maxCost) {
+            break;
+        }
+        
+        settled_[entry.cell] = generation_;
+        lastExpansions_++;
+        
+        if (pendingTargets > 0 && target_[entry.cell] == generation_ && --pendingTargets == 0) {
+            break;
+        }
+        
+        Position pos(entry.cell % width_, entry.cell / width_);
+        int count = grid.getNeighbors(pos, neighbors);
+        for (int i = 0; i < count; ++i) {
+            const Position& next = neighbors[i];
+            int nextCell = next.y * width_ + next.x;
+            if (settled_[nextCell] == generation_) {
+                continue;
+            }
+            
+            float step;
+            if (UniformCosts) {
+                step = next.x != pos.x && next.y != pos.y ? uniformDiagonalCost : uniformCost;
+            } else {
+                step = grid.getStepCost(pos, next);
+            }
+            float cost = entry.cost + step;
+            std::uint8_t through = 0;
+            if (FirstMoves) {
+                through = entry.cell == sourceCell ? static_cast<std::uint8_t>(1u << Grid::moveIndex(pos, next))
+                                                   : firstMoves_[entry.cell];
+            }
+            if (reached_[nextCell] != generation_ || cost < distance_[nextCell]) {
+                distance_[nextCell] = cost;
+                reached_[nextCell] = generation_;
+                if (FirstMoves) {
+                    firstMoves_[nextCell] = through;
+                }
+                heap_.push_back({cost, nextCell});
+                std::push_heap(heap_.begin(), heap_.end(), std::greater<QueueEntry>());
+            } else if (FirstMoves && cost == distance_[nextCell]) {
+                // Another shortest path: either first move may be taken
+                firstMoves_[nextCell] |= through;
+            }
+        }
+    }
+}
@@ -1,13 +1,68 @@
 #include "pathfinding/gridstate.h"
 
+#include <algorithm>
+
+// Constructor
+GoalSet::GoalSet(const std::vector<Position>& goals) : GoalSet() {
+    for (const Position& goal : goals) {
+        add(goal);
+    }
+}
+
+void GoalSet::add(const Position& goal) {
+    if (!keys_.insert(key(goal)).second) {
+        return;
+    }
+    
+    if (goals_.empty()) {
+        minX_ = maxX_ = goal.x;
+        minY_ = maxY_ = goal.y;
+    } else {
+        minX_ = std::min(minX_, goal.x);
+        minY_ = std::min(minY_, goal.y);
+        maxX_ = std::max(maxX_, goal.x);
+        maxY_ = std::max(maxY_, goal.y);
+    }
+    goals_.push_back(goal);
+}
+
+void GoalSet::clear() {
+    goals_.clear();
+    keys_.clear();
+    minX_ = minY_ = 0;
+    maxX_ = maxY_ = -1;
+}
+
+bool GoalSet::contains(const Position& pos) const {
+    return keys_.count(key(pos)) > 0;
+}
+
+float GoalSet::estimate(const Position& pos, Connectivity connectivity) const {
+    if (goals_.size() > kMaxExactGoals) {
+        Position nearest(std::clamp(pos.x, minX_, maxX_), std::clamp(pos.y, minY_, maxY_));
+        return GridState::estimate(pos, nearest, connectivity);
+    }
+    
+    float best = 0.0f;
+    for (size_t i = 0; i < goals_.size(); ++i) {
+        float distance = GridState::estimate(pos, goals_[i], connectivity);
+        if (i == 0 || distance < best) {
+            best = distance;
+        }
+    }
+    return best;
+}
+
 // Constructors
-GridState::GridState() : position(0, 0), grid(nullptr) {
+GridState::GridState() : position(0, 0), grid(nullptr), goals(nullptr), goalBounds(nullptr) {
 }
 
-GridState::GridState(const Position& pos, const Grid* g) : position(pos), grid(g) {
+GridState::GridState(const Position& pos, const Grid* g)
+    : position(pos), grid(g), goals(nullptr), goalBounds(nullptr) {
 }
 
-GridState::GridState(const GridState& other) : position(other.position), grid(other.grid) {
+GridState::GridState(const GridState& other)
+    : position(other.position), grid(other.grid), goals(other.goals), goalBounds(other.goalBounds) {
 }
 
 // Assignment operator
@@ -15,20 +70,39 @@ GridState& GridState::operator=(const GridState& other) {
     if (this != &other) {
         position = other.position;
         grid = other.grid;
+        goals = other.goals;
+        goalBounds = other.goalBounds;
     }
     return *this;
 }
 
 // A* interface implementations
 
-// Heuristic function - Manhattan distance to goal
+// Manhattan distance for 4-connected moves, octile distance for 8-connected ones
+float GridState::estimate(const Position& from, const Position& to, Connectivity connectivity) {
+    int dx = abs(from.x - to.x);
+    int dy = abs(from.y - to.y);
+    if (connectivity == Connectivity::Four) {
+        return static_cast<float>(dx + dy);
+    }
+    int diagonal = std::min(dx, dy);
+    return static_cast<float>(dx + dy - 2 * diagonal) + diagonal * Grid::kDiagonalCost;
+}
+
+// Heuristic function - distance to the goal, or to the nearest of several goals,
+// times the cheapest terrain on the grid so it never overestimates
 float GridState::GoalDistanceEstimate(GridState& nodeGoal) {
-    return static_cast<float>(abs(position.x - nodeGoal.position.x) + 
-                             abs(position.y - nodeGoal.position.y));
+    Connectivity connectivity = grid ? grid->getConnectivity() : Connectivity::Four;
+    float distance = nodeGoal.goals ? nodeGoal.goals->estimate(position, connectivity)
+                                    : estimate(position, nodeGoal.position, connectivity);
+    return grid ? distance * grid->getMinMoveCost() : distance;
 }
 
 // Check if this is the goal state
 bool GridState::IsGoal(GridState& nodeGoal) {
+    if (nodeGoal.goals) {
+        return nodeGoal.goals->contains(position);
+    }
     return position == nodeGoal.position;
 }
 
@@ -37,13 +111,22 @@ bool GridState::GetSuccessors(AStarSearch<GridState>* astarsearch, GridState* pa
     if (!grid) return false;
     
     // Get all valid neighbors from the grid
-    std::vector<Position> neighbors = grid->getNeighbors(position);
+    Position neighbors[Grid::kMaxNeighbors];
+    int count = grid->getNeighbors(position, neighbors);
     
-    for (const Position& neighborPos : neighbors) {
+    const GridState* goal = astarsearch->GetGoalState();
+    const GoalBounds* bounds = goal ? goal->goalBounds : nullptr;
+    
+    for (int i = 0; i < count; ++i) {
+        const Position& neighborPos = neighbors[i];
         // Skip the parent position to avoid going backwards
         if (parent_node && neighborPos == parent_node->position) {
             continue;
         }
+        // Skip moves that start no shortest path to the goal
+        if (bounds && !bounds->allows(position, neighborPos, goal->position)) {
+            continue;
+        }
         
         // Create a new state for this neighbor
         GridState NewNode(neighborPos, grid);
@@ -53,10 +136,17 @@ bool GridState::GetSuccessors(AStarSearch<GridState>* astarsearch, GridState* pa
     return true;
 }
 
-// Cost to move from this state to successor 
+// Cost to move from this state to successor - the terrain cost of the cell entered
 float GridState::GetCost(GridState& successor) {
-    // For now, all moves have cost 1.0
-    return 1.0f;
+    if (!grid) {
+        return 1.0f;
+    }
+    // Single terrain cost: skip the cell lookup
+    if (grid->hasUniformCosts()) {
+        bool diagonal = position.x != successor.position.x && position.y != successor.position.y;
+        return diagonal ? grid->getMinMoveCost() * Grid::kDiagonalCost : grid->getMinMoveCost();
+    }
+    return grid->getStepCost(position, successor.position);
 }
 
 // Check if two states are the same
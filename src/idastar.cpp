@@ -0,0 +1,117 @@
+#include "pathfinding/idastar.h"
+#include "pathfinding/gridstate.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+}
+
+// Constructor
+IDAStarSearch::IDAStarSearch(size_t memoryBudget)
+    : stamp_(0), maxExpansions_(0), lastIterations_(0) {
+    size_t tableSize = tableSizeFor(memoryBudget, sizeof(Entry));
+    table_.assign(tableSize, Entry{0, 0, 0.0f});
+    shift_ = hashShift(tableSize);
+}
+
+bool IDAStarSearch::findPath(const Grid& grid, const Position& start, const Position& goal,
+                             std::vector<Position>& path) {
+    PF_TRACE_SCOPE("IDAStarSearch::findPath");
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastExpansions_ = 0;
+    lastOutOfMemory_ = false;
+    lastIterations_ = 0;
+    
+    if (start == goal) {
+        path.push_back(start);
+        return true;
+    }
+    
+    const int width = grid.getWidth();
+    const Connectivity connectivity = grid.getConnectivity();
+    const float minCost = grid.getMinMoveCost();
+    auto estimate = [&](const Position& pos) {
+        return GridState::estimate(pos, goal, connectivity) * minCost;
+    };
+    
+    float threshold = estimate(start);
+    while (threshold != kInfinity) {
+        lastIterations_++;
+        float nextThreshold = kInfinity;
+        
+        // Each iteration gets a fresh stamp, so older table entries stop counting
+        if (++stamp_ == 0) {
+            for (Entry& entry : table_) {
+                entry.stamp = 0;
+            }
+            stamp_ = 1;
+        }
+        
+        stack_.clear();
+        seenCheaper(start.y * width + start.x, 0.0f);
+        pushFrame(grid, start, 0.0f);
+        
+        while (!stack_.empty()) {
+            Frame& top = stack_.back();
+            if (top.next == top.count) {
+                stack_.pop_back();
+                continue;
+            }
+            
+            Position child = top.neighbors[top.next++];
+            float g = top.g + grid.getStepCost(top.position, child);
+            float f = g + estimate(child);
+            if (f > threshold) {
+                nextThreshold = std::min(nextThreshold, f);
+                continue;
+            }
+            if (seenCheaper(child.y * width + child.x, g)) {
+                continue;
+            }
+            
+            if (child == goal) {
+                for (const Frame& frame : stack_) {
+                    path.push_back(frame.position);
+                }
+                path.push_back(child);
+                lastPathCost_ = g;
+                return true;
+            }
+            
+            if (maxExpansions_ > 0 && lastExpansions_ >= maxExpansions_) {
+                lastOutOfMemory_ = true;
+                return false;
+            }
+            lastExpansions_++;
+            pushFrame(grid, child, g);
+        }
+        
+        threshold = nextThreshold;
+    }
+    
+    // Nothing went over the last threshold: every reachable cell was searched
+    return false;
+}
+
+bool IDAStarSearch::seenCheaper(int cell, float g) {
+    Entry& entry = table_[hashCell(cell, shift_)];
+    if (entry.stamp == stamp_ && entry.cell == cell && entry.g <= g) {
+        return true;
+    }
+    
+    // Newest entry wins a collision
+    entry = Entry{stamp_, cell, g};
+    return false;
+}
+
+void IDAStarSearch::pushFrame(const Grid& grid, const Position& position, float g) {
+    stack_.emplace_back();
+    Frame& frame = stack_.back();
+    frame.position = position;
+    frame.g = g;
+    frame.next = 0;
+    frame.count = grid.getNeighbors(position, frame.neighbors);
+}
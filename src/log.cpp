@@ -0,0 +1,158 @@
+#include "pathfinding/log.h"
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    std::atomic<LogSink*> logSink{nullptr};
+    std::atomic<int> logLevel{static_cast<int>(LogLevel::Info)};
+
+    void appendNumber(std::string& text, double value) {
+        char buffer[32];
+        if (std::fabs(value) < 9.0e15 && value == std::floor(value)) {
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%g", value);
+        }
+        text += buffer;
+    }
+}
+
+void setLogSink(LogSink* sink) {
+    logSink.store(sink, std::memory_order_release);
+}
+
+LogSink* getLogSink() {
+    return logSink.load(std::memory_order_acquire);
+}
+
+void setLogLevel(LogLevel level) {
+    logLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return static_cast<LogLevel>(logLevel.load(std::memory_order_relaxed));
+}
+
+bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) >= logLevel.load(std::memory_order_relaxed) &&
+           level != LogLevel::Off &&
+           logSink.load(std::memory_order_relaxed) != nullptr;
+}
+
+void logWriteRecord(const LogRecord& record) {
+    if (LogSink* sink = getLogSink()) {
+        sink->write(record);
+    }
+}
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "trace";
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warning: return "warning";
+        case LogLevel::Error: return "error";
+        case LogLevel::Off: return "off";
+    }
+    return "unknown";
+}
+
+std::string formatLogRecord(const LogRecord& record) {
+    std::string text = "[";
+    text += logLevelName(record.level);
+    text += "] ";
+
+    size_t arg = 0;
+    for (const char* c = record.format; *c; ++c) {
+        if (c[0] == '{' && c[1] == '}' && arg < record.argCount) {
+            appendNumber(text, record.args[arg++]);
+            ++c;
+        } else {
+            text += *c;
+        }
+    }
+    return text;
+}
+
+// Constructor
+ConsoleLogSink::ConsoleLogSink(std::ostream& out) : out_(out) {
+}
+
+void ConsoleLogSink::write(const LogRecord& record) {
+    std::string text = formatLogRecord(record);
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ << text << '\n';
+}
+
+// Constructor
+RingBufferLogSink::RingBufferLogSink(size_t capacity)
+    : enqueuePos_(0), dequeuePos_(0), dropped_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    mask_ = size - 1;
+
+    slots_ = std::make_unique<Slot[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Bounded MPMC queue: each slot's sequence tells whether it is free for the
+// producer at position pos (sequence == pos) or holds data for the consumer
+// at position pos (sequence == pos + 1)
+void RingBufferLogSink::write(const LogRecord& record) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+
+    while (true) {
+        Slot& slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = record;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);  // Full
+            return;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool RingBufferLogSink::pop(LogRecord& record) {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+
+    while (true) {
+        Slot& slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+        if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                record = slot.record;
+                slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Empty
+        } else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t RingBufferLogSink::drain(std::ostream& out) {
+    size_t count = 0;
+    LogRecord record;
+    while (pop(record)) {
+        out << formatLogRecord(record) << '\n';
+        count++;
+    }
+    return count;
+}
@@ -2,8 +2,16 @@
 #include <iostream>
 #include "pathfinding/grid.h"
 #include "pathfinding/character.h"
+#include "pathfinding/pathcache.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
 
 int main() {
+    // The library is silent by default; show its messages in the console
+    ConsoleLogSink consoleLog(std::cout);
+    setLogSink(&consoleLog);
+    setLogLevel(LogLevel::Debug);
+    
     // Create a window
     sf::RenderWindow window(sf::VideoMode({800, 600}), "Grid Test - A* Game");
     window.setFramerateLimit(60);
@@ -16,18 +24,36 @@ int main() {
     
     Character player(Position(1, 1), sf::Color::Green);
     
+    // Remember paths between right-clicks; wall edits evict only affected paths
+    PathCache pathCache;
+    player.setPathCache(&pathCache);
+    player.setPathSmoothing(true);
+    grid.subscribe([&pathCache](const GridChangeBatch& batch) {
+        pathCache.onGridChanged(batch);
+    });
+    
+    // Cell type placed by left-clicks
+    CellType brush = CellType::Wall;
+    
     std::cout << "Grid created successfully!" << std::endl;
     std::cout << "Grid size: " << grid.getWidth() << "x" << grid.getHeight() << std::endl;
     std::cout << "Controls:" << std::endl;
     std::cout << "  WASD or Arrow Keys to move character manually" << std::endl;
     std::cout << "  1-5 keys to change character color" << std::endl;
     std::cout << "  ESC to close window" << std::endl;
-    std::cout << "  Left-click to add walls (disabled during pathfinding)" << std::endl;
+    std::cout << "  6-9 keys to pick what left-click places (wall, road, mud, water)" << std::endl;
+    std::cout << "  Left-click to add walls or terrain (disabled during pathfinding)" << std::endl;
     std::cout << "  Right-click to find path to target location (A*)" << std::endl;
-    std::cout << "  Middle-click to remove walls (disabled during pathfinding)" << std::endl;
+    std::cout << "  Middle-click to clear walls and terrain (disabled during pathfinding)" << std::endl;
+    std::cout << "  C to switch between 4 and 8-connected movement" << std::endl;
+    std::cout << "  T to start/stop tracing (written to trace.json)" << std::endl;
+    
+    setTraceThreadName("main");
 
     // Main loop
     while (window.isOpen()) {
+        PF_TRACE_SCOPE("Frame");
+        
         // Handle events
         while (auto event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) {
@@ -39,6 +65,33 @@ int main() {
                         window.close();
                 }
                 
+                // Toggle tracing; stopping writes everything recorded so far
+                if (keyPressed->code == sf::Keyboard::Key::T) {
+                    if (!isTracingEnabled()) {
+                        clearTrace();
+                        setTracingEnabled(true);
+                        std::cout << "Tracing started" << std::endl;
+                    } else {
+                        setTracingEnabled(false);
+                        if (writeChromeTrace("trace.json")) {
+                            std::cout << "Trace with " << getTraceEventCount() << " events written to trace.json" << std::endl;
+                        } else {
+                            std::cout << "Could not write trace.json" << std::endl;
+                        }
+                    }
+                }
+                
+                // Toggle diagonal moves; corners are never cut
+                if (keyPressed->code == sf::Keyboard::Key::C) {
+                    if (grid.getConnectivity() == Connectivity::Four) {
+                        grid.setMovement(Connectivity::Eight);
+                        std::cout << "8-connected movement" << std::endl;
+                    } else {
+                        grid.setMovement(Connectivity::Four);
+                        std::cout << "4-connected movement" << std::endl;
+                    }
+                }
+                
                 // Color changing with number keys
                 switch (keyPressed->code) {
                     case sf::Keyboard::Key::Num1:
@@ -61,6 +114,22 @@ int main() {
                         player.setColor(sf::Color::Magenta);
                         std::cout << "Character color changed to Magenta" << std::endl;
                         break;
+                    case sf::Keyboard::Key::Num6:
+                        brush = CellType::Wall;
+                        std::cout << "Left-click places walls" << std::endl;
+                        break;
+                    case sf::Keyboard::Key::Num7:
+                        brush = CellType::Road;
+                        std::cout << "Left-click places road" << std::endl;
+                        break;
+                    case sf::Keyboard::Key::Num8:
+                        brush = CellType::Mud;
+                        std::cout << "Left-click places mud" << std::endl;
+                        break;
+                    case sf::Keyboard::Key::Num9:
+                        brush = CellType::Water;
+                        std::cout << "Left-click places water" << std::endl;
+                        break;
                     default:
                         break;
                 }
@@ -73,10 +142,13 @@ int main() {
                 
                 if (grid.isInBounds(gridX, gridY)) {
                     if (mousePressed->button == sf::Mouse::Button::Left) {
-                        // Left click - add wall
+                        // Left click - add wall or terrain
                         if (!player.hasPath()) {
                             Position pos(gridX, gridY);
-                            if (pos != player.getPosition()) { // Don't place wall on player
+                            if (brush != CellType::Wall) {
+                                grid.setCell(gridX, gridY, brush);
+                                std::cout << "Added terrain at (" << gridX << ", " << gridY << ")" << std::endl;
+                            } else if (pos != player.getPosition()) { // Don't place wall on player
                                 grid.setCell(gridX, gridY, CellType::Wall);
                                 std::cout << "Added wall at (" << gridX << ", " << gridY << ")" << std::endl;
                             }
@@ -92,16 +164,19 @@ int main() {
                             std::cout << "No path found to target location." << std::endl;
                         }
                     } else if (mousePressed->button == sf::Mouse::Button::Middle) {
-                        // Middle click - remove wall
+                        // Middle click - clear the cell
                         if (!player.hasPath()) {
                             grid.setCell(gridX, gridY, CellType::Empty);
-                            std::cout << "Removed wall at (" << gridX << ", " << gridY << ")" << std::endl;
+                            std::cout << "Cleared cell at (" << gridX << ", " << gridY << ")" << std::endl;
                         }
                     }
                 }
             }
         }
         
+        // Notify grid subscribers of this frame's edits in one batch
+        grid.flushChanges();
+        
         // Handle character movement (manual input or follow path)
         if (player.hasPath()) {
             // Character is following a path, move automatically
@@ -118,6 +193,7 @@ int main() {
         }
         
         // Clear screen
+        PF_TRACE_SCOPE("Render");
         window.clear(sf::Color::Black);
         
         // Draw the grid
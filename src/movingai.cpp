@@ -0,0 +1,88 @@
+#include "pathfinding/movingai.h"
+#include <fstream>
+#include <sstream>
+
+bool loadMovingAIMap(std::istream& in, Grid& grid) {
+    std::string keyword;
+    int width = -1;
+    int height = -1;
+
+    // Header: "type <name>", "height <h>", "width <w>" then "map"
+    while (in >> keyword && keyword != "map") {
+        if (keyword == "type") {
+            std::string type;
+            in >> type;
+        } else if (keyword == "height") {
+            in >> height;
+        } else if (keyword == "width") {
+            in >> width;
+        } else {
+            return false;
+        }
+    }
+
+    if (keyword != "map" || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    Grid loaded(width, height);
+    std::string row;
+    std::getline(in, row);  // Rest of the "map" line
+
+    for (int y = 0; y < height; ++y) {
+        if (!std::getline(in, row)) {
+            return false;
+        }
+        if (!row.empty() && row.back() == '\r') {
+            row.pop_back();
+        }
+        if (static_cast<int>(row.size()) < width) {
+            return false;
+        }
+
+        for (int x = 0; x < width; ++x) {
+            char terrain = row[x];
+            if (terrain != '.' && terrain != 'G' && terrain != 'S') {
+                loaded.setCell(x, y, CellType::Wall);
+            }
+        }
+    }
+
+    grid = std::move(loaded);
+    return true;
+}
+
+bool loadMovingAIMap(const std::string& path, Grid& grid) {
+    std::ifstream file(path);
+    return file && loadMovingAIMap(file, grid);
+}
+
+bool loadMovingAIScenarios(std::istream& in, std::vector<MovingAIScenario>& scenarios) {
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line.compare(0, 7, "version") == 0) {
+            continue;
+        }
+
+        // bucket map width height startX startY goalX goalY optimalLength
+        std::istringstream fields(line);
+        MovingAIScenario scenario;
+        if (!(fields >> scenario.bucket >> scenario.mapName >> scenario.mapWidth >> scenario.mapHeight >>
+              scenario.start.x >> scenario.start.y >> scenario.goal.x >> scenario.goal.y >>
+              scenario.optimalLength)) {
+            return false;
+        }
+        scenarios.push_back(scenario);
+    }
+
+    return true;
+}
+
+bool loadMovingAIScenarios(const std::string& path, std::vector<MovingAIScenario>& scenarios) {
+    std::ifstream file(path);
+    return file && loadMovingAIScenarios(file, scenarios);
+}
@@ -0,0 +1,262 @@
+#include "pathfinding/pathcache.h"
+#include "pathfinding/gridstate.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Constructor
+PathCache::PathCache(size_t maxEntries, size_t maxCells)
+    : maxEntries_(maxEntries), maxCells_(maxCells), cachedCells_(0), revision_(0), cellHash_(0),
+      width_(0), height_(0), terrainCosts_{}, minTerrainCost_(1.0f),
+      connectivity_(Connectivity::Four), cornerCutting_(CornerCutting::Forbid) {
+}
+
+bool PathCache::lookup(const Grid& grid, const Position& start, const Position& goal,
+                       std::vector<Position>& path, float& cost) {
+    if (!syncRevision(grid)) {
+        stats_.misses++;
+        return false;
+    }
+
+    // Exact match
+    auto exact = index_.find({start, goal});
+    if (exact != index_.end()) {
+        entries_.splice(entries_.begin(), entries_, exact->second);
+        path = exact->second->path;
+        cost = exact->second->cost;
+        stats_.hits++;
+        return true;
+    }
+
+    // Tail of a cached path to the same goal that passes through start
+    auto sameGoal = byGoal_.find(goal);
+    if (sameGoal != byGoal_.end()) {
+        for (EntryList::iterator entry : sameGoal->second) {
+            if (!containsCell(*entry, start)) {
+                continue;
+            }
+
+            auto from = std::find(entry->path.begin(), entry->path.end(), start);
+            path.assign(from, entry->path.end());
+
+            cost = 0.0f;
+            for (size_t i = 1; i < path.size(); ++i) {
+                GridState current(path[i - 1], &grid);
+                GridState next(path[i], &grid);
+                cost += current.GetCost(next);
+            }
+
+            entries_.splice(entries_.begin(), entries_, entry);
+            stats_.suffixHits++;
+            return true;
+        }
+    }
+
+    stats_.misses++;
+    return false;
+}
+
+void PathCache::store(const Grid& grid, const Position& start, const Position& goal,
+                      const std::vector<Position>& path, float cost) {
+    // A path found past edits the cache has not been told about yet cannot be checked
+    // against them, so it is not kept
+    if (!syncRevision(grid) && grid.getRevision() != revision_) {
+        return;
+    }
+
+    if (path.empty() || path.size() > maxCells_) {
+        return;
+    }
+
+    auto existing = index_.find({start, goal});
+    if (existing != index_.end()) {
+        erase(existing->second);
+    }
+
+    Entry entry;
+    entry.start = start;
+    entry.goal = goal;
+    entry.path = path;
+    entry.cost = cost;
+    entry.boundsMin = path.front();
+    entry.boundsMax = path.front();
+    for (const Position& pos : path) {
+        entry.boundsMin.x = std::min(entry.boundsMin.x, pos.x);
+        entry.boundsMin.y = std::min(entry.boundsMin.y, pos.y);
+        entry.boundsMax.x = std::max(entry.boundsMax.x, pos.x);
+        entry.boundsMax.y = std::max(entry.boundsMax.y, pos.y);
+    }
+
+    entries_.push_front(std::move(entry));
+    index_[{start, goal}] = entries_.begin();
+    byGoal_[goal].push_back(entries_.begin());
+    cachedCells_ += path.size();
+
+    enforceCaps();
+}
+
+void PathCache::invalidateCell(const Grid& grid, const Position& pos, CellType newType) {
+    // Edits we were not told about may have touched anything
+    if (grid.getRevision() > revision_ + 1 || !sameRules(grid)) {
+        clear();
+        adopt(grid);
+        return;
+    }
+    revision_ = std::max(revision_, grid.getRevision());
+    cellHash_ = grid.getCellHash();
+
+    evictAffected(pos, newType);
+}
+
+void PathCache::onGridChanged(const GridChangeBatch& batch) {
+    // A gap between batches means some edits went unseen
+    if (batch.fromRevision != revision_) {
+        clear();
+        revision_ = batch.toRevision;
+        cellHash_ = batch.cellHash;
+        return;
+    }
+
+    for (const CellChange& change : batch.changes) {
+        evictAffected(change.position, change.newType);
+    }
+    revision_ = batch.toRevision;
+    cellHash_ = batch.cellHash;
+}
+
+void PathCache::clear() {
+    stats_.invalidations += entries_.size();
+    entries_.clear();
+    index_.clear();
+    byGoal_.clear();
+    cachedCells_ = 0;
+}
+
+// Drop the entries a change of pos to newType can invalidate
+void PathCache::evictAffected(const Position& pos, CellType newType) {
+    for (auto entry = entries_.begin(); entry != entries_.end();) {
+        bool affected;
+
+        if (containsCell(*entry, pos)) {
+            // A new wall breaks the path, other terrain changes its cost
+            affected = true;
+        } else if (newType == CellType::Wall) {
+            // Unless corners may be cut, a wall also blocks diagonal steps passing by it
+            affected = cornerCutting_ != CornerCutting::Allow && cutsCorner(*entry, pos);
+        } else {
+            // Cheaper terrain can only shorten paths that could detour through it for less
+            // than their current cost (the heuristic times the cheapest terrain is a lower bound)
+            float viaCell = GridState::estimate(entry->start, pos, connectivity_) +
+                            GridState::estimate(pos, entry->goal, connectivity_);
+            affected = viaCell * minTerrainCost_ < entry->cost;
+        }
+
+        if (affected) {
+            auto next = std::next(entry);
+            erase(entry);
+            stats_.invalidations++;
+            entry = next;
+        } else {
+            ++entry;
+        }
+    }
+}
+
+// Adopt the grid's revision; if it moved without invalidateCell calls, or the grid is
+// another one, nothing cached can be trusted. Returns true if existing entries are valid.
+bool PathCache::syncRevision(const Grid& grid) {
+    if (sameRules(grid)) {
+        if (grid.getRevision() == revision_ && grid.getCellHash() == cellHash_) {
+            return true;
+        }
+
+        // Edits still waiting for flushChanges: the batch will evict what they affect,
+        // until then nothing is served
+        if (grid.hasPendingChanges() && grid.getFlushedRevision() == revision_) {
+            return false;
+        }
+    }
+
+    clear();
+    adopt(grid);
+    return false;
+}
+
+bool PathCache::sameRules(const Grid& grid) const {
+    if (grid.getWidth() != width_ || grid.getHeight() != height_ ||
+        grid.getConnectivity() != connectivity_ || grid.getCornerCutting() != cornerCutting_) {
+        return false;
+    }
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (grid.getTerrainCost(static_cast<CellType>(type)) != terrainCosts_[type]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Describe grid as it is now
+void PathCache::adopt(const Grid& grid) {
+    revision_ = grid.getRevision();
+    cellHash_ = grid.getCellHash();
+    width_ = grid.getWidth();
+    height_ = grid.getHeight();
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        terrainCosts_[type] = grid.getTerrainCost(static_cast<CellType>(type));
+    }
+    minTerrainCost_ = grid.getMinTerrainCost();
+    connectivity_ = grid.getConnectivity();
+    cornerCutting_ = grid.getCornerCutting();
+}
+
+bool PathCache::containsCell(const Entry& entry, const Position& pos) const {
+    if (pos.x < entry.boundsMin.x || pos.x > entry.boundsMax.x ||
+        pos.y < entry.boundsMin.y || pos.y > entry.boundsMax.y) {
+        return false;
+    }
+    return std::find(entry.path.begin(), entry.path.end(), pos) != entry.path.end();
+}
+
+bool PathCache::cutsCorner(const Entry& entry, const Position& pos) const {
+    if (connectivity_ == Connectivity::Four ||
+        pos.x < entry.boundsMin.x || pos.x > entry.boundsMax.x ||
+        pos.y < entry.boundsMin.y || pos.y > entry.boundsMax.y) {
+        return false;
+    }
+    for (size_t i = 1; i < entry.path.size(); ++i) {
+        const Position& from = entry.path[i - 1];
+        const Position& to = entry.path[i];
+        if (from.x != to.x && from.y != to.y &&
+            (pos == Position(to.x, from.y) || pos == Position(from.x, to.y))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PathCache::erase(EntryList::iterator entry) {
+    index_.erase({entry->start, entry->goal});
+
+    auto sameGoal = byGoal_.find(entry->goal);
+    if (sameGoal != byGoal_.end()) {
+        std::vector<EntryList::iterator>& list = sameGoal->second;
+        auto it = std::find(list.begin(), list.end(), entry);
+        if (it != list.end()) {
+            *it = list.back();
+            list.pop_back();
+        }
+        if (list.empty()) {
+            byGoal_.erase(sameGoal);
+        }
+    }
+
+    cachedCells_ -= entry->path.size();
+    entries_.erase(entry);
+}
+
+// Drop least recently used paths until both caps hold
+void PathCache::enforceCaps() {
+    while (!entries_.empty() && (entries_.size() > maxEntries_ || cachedCells_ > maxCells_)) {
+        erase(std::prev(entries_.end()));
+        stats_.evictions++;
+    }
+}
@@ -0,0 +1,331 @@
+#include "pathfinding/pathdatabase.h"
+#include "pathfinding/griddijkstra.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace {
+    // Sources handed to a thread at a time
+    const size_t kChunkSize = 16;
+
+    int lowestMove(std::uint8_t moves) {
+        int move = 0;
+        while (!(moves & (1u << move))) {
+            move++;
+        }
+        return move;
+    }
+}
+
+// Constructor
+PathDatabase::PathDatabase()
+    : header_(), data_(nullptr), size_(0), order_(nullptr), component_(nullptr), offsets_(nullptr),
+      runs_(nullptr) {
+}
+
+bool PathDatabase::build(const Grid& grid, unsigned int threads) {
+    PF_TRACE_SCOPE("PathDatabase::build");
+    clear();
+
+    const int width = grid.getWidth();
+    const size_t cellCount = static_cast<size_t>(width) * grid.getHeight();
+
+    // Depth-first numbering: neighbors get close numbers, so a source's first move stays
+    // the same over long stretches of numbers. Each tree of the walk is one component.
+    std::vector<std::uint32_t> order(cellCount, kNoCell);
+    std::vector<int> cells;
+    std::vector<std::uint32_t> component;
+    std::vector<int> stack;
+    Position neighbors[Grid::kMaxNeighbors];
+    std::uint32_t components = 0;
+    for (size_t root = 0; root < cellCount; ++root) {
+        Position rootPos(static_cast<int>(root % width), static_cast<int>(root / width));
+        if (order[root] != kNoCell || !grid.isWalkable(rootPos)) {
+            continue;
+        }
+        if (cells.size() >= kMaxWalkable) {
+            PF_LOG_WARNING("Grid has too many walkable cells for a path database");
+            return false;
+        }
+
+        order[root] = static_cast<std::uint32_t>(cells.size());
+        cells.push_back(static_cast<int>(root));
+        component.push_back(components);
+        stack.push_back(static_cast<int>(root));
+        while (!stack.empty()) {
+            Position pos(stack.back() % width, stack.back() / width);
+            int count = grid.getNeighbors(pos, neighbors);
+            int i = 0;
+            while (i < count && order[neighbors[i].y * width + neighbors[i].x] != kNoCell) {
+                i++;
+            }
+            if (i == count) {
+                stack.pop_back();
+                continue;
+            }
+
+            int cell = neighbors[i].y * width + neighbors[i].x;
+            order[cell] = static_cast<std::uint32_t>(cells.size());
+            cells.push_back(cell);
+            component.push_back(components);
+            stack.push_back(cell);
+        }
+        components++;
+    }
+
+    // One row of runs per source. Each target allows every first move of a shortest path
+    // to it (and any move if it is the source or unreachable); a run grows while some move
+    // suits all of its targets, so ties are spent on making runs longer.
+    const size_t walkable = cells.size();
+    std::vector<std::vector<std::uint32_t>> rows(walkable);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(std::min<size_t>(threads, (walkable + kChunkSize - 1) / kChunkSize));
+
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        GridDijkstra dijkstra;
+        for (size_t begin = nextChunk.fetch_add(kChunkSize); begin < walkable; begin = nextChunk.fetch_add(kChunkSize)) {
+            for (size_t source = begin; source < std::min(begin + kChunkSize, walkable); ++source) {
+                dijkstra.firstMovesFrom(grid, Position(cells[source] % width, cells[source] / width));
+
+                std::vector<std::uint32_t>& row = rows[source];
+                std::uint8_t candidates = 0xff;
+                std::uint32_t runStart = 0;
+                for (size_t target = 0; target < walkable; ++target) {
+                    std::uint8_t moves = 0xff;
+                    if (target != source && component[target] == component[source]) {
+                        moves = dijkstra.getFirstMoves(Position(cells[target] % width, cells[target] / width));
+                    }
+                    if ((candidates & moves) == 0) {
+                        row.push_back(runStart << 3 | static_cast<std::uint32_t>(lowestMove(candidates)));
+                        runStart = static_cast<std::uint32_t>(target);
+                        candidates = moves;
+                    } else {
+                        candidates &= moves;
+                    }
+                }
+                row.push_back(runStart << 3 | static_cast<std::uint32_t>(lowestMove(candidates)));
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    size_t runCount = 0;
+    for (const std::vector<std::uint32_t>& row : rows) {
+        runCount += row.size();
+    }
+
+    Header header = {};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.width = static_cast<std::uint32_t>(width);
+    header.height = static_cast<std::uint32_t>(grid.getHeight());
+    header.connectivity = static_cast<std::uint32_t>(grid.getConnectivity());
+    header.cornerCutting = static_cast<std::uint32_t>(grid.getCornerCutting());
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        header.terrainCosts[type] = grid.getTerrainCost(static_cast<CellType>(type));
+    }
+    std::uint64_t hash = grid.getCellHash();
+    header.cellHashLow = static_cast<std::uint32_t>(hash);
+    header.cellHashHigh = static_cast<std::uint32_t>(hash >> 32);
+    header.walkableCount = static_cast<std::uint32_t>(walkable);
+    header.runCount = static_cast<std::uint32_t>(runCount);
+
+    storage_.resize(kHeaderWords + cellCount + 2 * walkable + 1 + runCount);
+    std::memcpy(storage_.data(), &header, sizeof(Header));
+    std::uint32_t* out = storage_.data() + kHeaderWords;
+    out = std::copy(order.begin(), order.end(), out);
+    out = std::copy(component.begin(), component.end(), out);
+    std::uint32_t offset = 0;
+    for (const std::vector<std::uint32_t>& row : rows) {
+        *out++ = offset;
+        offset += static_cast<std::uint32_t>(row.size());
+    }
+    *out++ = offset;
+    for (const std::vector<std::uint32_t>& row : rows) {
+        out = std::copy(row.begin(), row.end(), out);
+    }
+
+    data_ = storage_.data();
+    size_ = storage_.size();
+    bind();
+    PF_LOG_DEBUG("Path database of {} cells: {} runs, {} bytes", walkable, runCount, getMemoryBytes());
+    return true;
+}
+
+bool PathDatabase::save(std::ostream& out) const {
+    if (empty()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(data_), static_cast<std::streamsize>(getMemoryBytes()));
+    return static_cast<bool>(out);
+}
+
+bool PathDatabase::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        PF_LOG_WARNING("Cannot open the path database file for writing");
+        return false;
+    }
+    return save(file);
+}
+
+bool PathDatabase::load(std::istream& in) {
+    clear();
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (bytes.size() % sizeof(std::uint32_t) != 0) {
+        return false;
+    }
+
+    storage_.resize(bytes.size() / sizeof(std::uint32_t));
+    std::memcpy(storage_.data(), bytes.data(), bytes.size());
+    data_ = storage_.data();
+    size_ = storage_.size();
+    if (!bind()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool PathDatabase::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        PF_LOG_WARNING("Cannot open the path database file");
+        return false;
+    }
+    return load(file);
+}
+
+bool PathDatabase::attach(const void* data, size_t bytes) {
+    clear();
+    if (!data || bytes % sizeof(std::uint32_t) != 0 ||
+        reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint32_t) != 0) {
+        return false;
+    }
+
+    data_ = static_cast<const std::uint32_t*>(data);
+    size_ = bytes / sizeof(std::uint32_t);
+    if (!bind()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool PathDatabase::isValidFor(const Grid& grid) const {
+    if (empty() ||
+        header_.width != static_cast<std::uint32_t>(grid.getWidth()) ||
+        header_.height != static_cast<std::uint32_t>(grid.getHeight()) ||
+        header_.connectivity != static_cast<std::uint32_t>(grid.getConnectivity()) ||
+        header_.cornerCutting != static_cast<std::uint32_t>(grid.getCornerCutting())) {
+        return false;
+    }
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (header_.terrainCosts[type] != grid.getTerrainCost(static_cast<CellType>(type))) {
+            return false;
+        }
+    }
+    std::uint64_t hash = grid.getCellHash();
+    return header_.cellHashLow == static_cast<std::uint32_t>(hash) &&
+           header_.cellHashHigh == static_cast<std::uint32_t>(hash >> 32);
+}
+
+bool PathDatabase::nextStep(const Position& from, const Position& to, Position& next) const {
+    std::uint32_t source = numberOf(from);
+    std::uint32_t target = numberOf(to);
+    if (source == kNoCell || target == kNoCell || source == target || component_[source] != component_[target]) {
+        return false;
+    }
+
+    // Last run starting at or before the target
+    const std::uint32_t* run = std::upper_bound(runs_ + offsets_[source], runs_ + offsets_[source + 1],
+                                                target << 3 | 7) - 1;
+    next = Grid::moveTarget(from, static_cast<int>(*run & 7));
+    return true;
+}
+
+bool PathDatabase::getPath(const Position& from, const Position& to, std::vector<Position>& path) const {
+    path.clear();
+    if (numberOf(from) == kNoCell) {
+        return false;
+    }
+
+    path.push_back(from);
+    Position pos = from;
+    while (pos != to) {
+        if (path.size() > header_.walkableCount || !nextStep(pos, to, pos)) {
+            path.clear();
+            return false;
+        }
+        path.push_back(pos);
+    }
+    return true;
+}
+
+std::uint32_t PathDatabase::numberOf(const Position& pos) const {
+    if (empty() || pos.x < 0 || pos.y < 0 || pos.x >= static_cast<int>(header_.width) ||
+        pos.y >= static_cast<int>(header_.height)) {
+        return kNoCell;
+    }
+    return order_[static_cast<size_t>(pos.y) * header_.width + pos.x];
+}
+
+bool PathDatabase::bind() {
+    if (size_ < kHeaderWords) {
+        return false;
+    }
+    std::memcpy(&header_, data_, sizeof(Header));
+    if (header_.magic != kMagic || header_.version != kVersion || header_.width == 0 || header_.height == 0 ||
+        header_.walkableCount > kMaxWalkable) {
+        return false;
+    }
+
+    const size_t cellCount = static_cast<size_t>(header_.width) * header_.height;
+    const size_t walkable = header_.walkableCount;
+    if (size_ != kHeaderWords + cellCount + 2 * walkable + 1 + header_.runCount) {
+        return false;
+    }
+
+    order_ = data_ + kHeaderWords;
+    component_ = order_ + cellCount;
+    offsets_ = component_ + walkable;
+    runs_ = offsets_ + walkable + 1;
+
+    // Reject anything a query could read out of bounds with
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        if (order_[cell] != kNoCell && order_[cell] >= walkable) {
+            return false;
+        }
+    }
+    for (size_t source = 0; source < walkable; ++source) {
+        if (offsets_[source] >= offsets_[source + 1] || (runs_[offsets_[source]] >> 3) != 0) {
+            return false;
+        }
+    }
+    return offsets_[walkable] == header_.runCount;
+}
+
+void PathDatabase::clear() {
+    storage_.clear();
+    storage_.shrink_to_fit();
+    header_ = Header();
+    data_ = nullptr;
+    size_ = 0;
+    order_ = component_ = offsets_ = runs_ = nullptr;
+}
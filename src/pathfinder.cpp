@@ -1,8 +1,37 @@
 #include "pathfinding/pathfinder.h"
-#include <iostream>
+#include "pathfinding/fringesearch.h"
+#include "pathfinding/idastar.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#if PATHFINDING_SEARCH_STATS
+namespace {
+    // Microseconds since phaseStart; restarts the clock for the next phase
+    double lapMicros(std::chrono::steady_clock::time_point& phaseStart) {
+        auto now = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(now - phaseStart).count();
+        phaseStart = now;
+        return micros;
+    }
+}
+#endif
 
 // Constructor
-Pathfinder::Pathfinder() : lastPathCost_(0.0f), lastSearchSteps_(0) {
+Pathfinder::Pathfinder()
+    : algorithm_(SearchAlgorithm::AStar), lastPathCost_(0.0f), lastSearchSteps_(0), lastPathPartial_(false),
+      lastSuboptimalityBound_(1.0f), pathCache_(nullptr), goalBounds_(nullptr),
+      pathDatabase_(nullptr), hierarchy_(nullptr), subgoalGraph_(nullptr),
+      symmetryReduction_(nullptr) {
+}
+
+Pathfinder::Pathfinder(int maxNodes)
+    : astarsearch_(maxNodes), algorithm_(SearchAlgorithm::AStar), lastPathCost_(0.0f), lastSearchSteps_(0), lastPathPartial_(false),
+      lastSuboptimalityBound_(1.0f), pathCache_(nullptr), goalBounds_(nullptr),
+      pathDatabase_(nullptr), hierarchy_(nullptr), subgoalGraph_(nullptr),
+      symmetryReduction_(nullptr) {
 }
 
 // Destructor
@@ -11,77 +40,414 @@ Pathfinder::~Pathfinder() {
 }
 
 bool Pathfinder::findPath(const Grid& grid, const Position& start, const Position& goal, std::vector<Position>& path) {
+    PF_TRACE_SCOPE("Pathfinder::findPath");
 
     path.clear();
     lastPathCost_ = 0.0f;
     lastSearchSteps_ = 0;
+    lastPathPartial_ = false;
+    lastSuboptimalityBound_ = 1.0f;
+    lastSearchStats_ = SearchStats();
     
-    // Validate start and goal positions
+    if (!validateEndpoints(grid, start, goal)) {
+        return false;
+    }
+    
+    // Static maps: follow the precomputed first moves
+    if (pathDatabase_ && pathDatabase_->isValidFor(grid)) {
+        if (!pathDatabase_->getPath(start, goal, path)) {
+            PF_LOG_DEBUG("No path in the path database");
+            return false;
+        }
+        for (size_t i = 1; i < path.size(); ++i) {
+            lastPathCost_ += grid.getStepCost(path[i - 1], path[i]);
+        }
+        return true;
+    }
+    
+    // Serve repeated queries from the cache
+    if (pathCache_ && pathCache_->lookup(grid, start, goal, path, lastPathCost_)) {
+        return true;
+    }
+    
+    if (hierarchy_ && hierarchy_->isValidFor(grid)) {
+        if (!hierarchy_->findPath(grid, start, goal, path)) {
+            lastSearchSteps_ = static_cast<int>(hierarchy_->getLastExpansions());
+            return false;
+        }
+        lastPathCost_ = hierarchy_->getLastPathCost();
+        lastSearchSteps_ = static_cast<int>(hierarchy_->getLastExpansions());
+    } else if (subgoalGraph_ && subgoalGraph_->isValidFor(grid)) {
+        if (!subgoalGraph_->findPath(grid, start, goal, path)) {
+            lastSearchSteps_ = static_cast<int>(subgoalGraph_->getLastExpansions());
+            return false;
+        }
+        lastPathCost_ = subgoalGraph_->getLastPathCost();
+        lastSearchSteps_ = static_cast<int>(subgoalGraph_->getLastExpansions());
+    } else if (symmetryReduction_ && symmetryReduction_->isValidFor(grid)) {
+        if (!symmetryReduction_->findPath(grid, start, goal, path)) {
+            lastSearchSteps_ = static_cast<int>(symmetryReduction_->getLastExpansions());
+            return false;
+        }
+        lastPathCost_ = symmetryReduction_->getLastPathCost();
+        lastSearchSteps_ = static_cast<int>(symmetryReduction_->getLastExpansions());
+    } else if (engine_) {
+        if (!engine_->findPath(grid, start, goal, path)) {
+            lastSearchSteps_ = static_cast<int>(engine_->getLastExpansions());
+            if (engine_->isLastOutOfMemory()) {
+                PF_LOG_WARNING("Search ran out of its {} byte budget after {} expansions",
+                               engine_->getMemoryBytes(), engine_->getLastExpansions());
+            }
+            return false;
+        }
+        lastPathCost_ = engine_->getLastPathCost();
+        lastSearchSteps_ = static_cast<int>(engine_->getLastExpansions());
+    } else {
+        // Create start and goal states
+        GridState nodeStart(start, &grid);
+        GridState nodeEnd(goal, &grid);
+        attachGoalBounds(grid, nodeEnd);
+        
+        if (!searchPath(grid, nodeStart, nodeEnd, path)) {
+            return false;
+        }
+    }
+    
+    // Only optimal paths are worth serving to later queries
+    if (pathCache_ && lastSuboptimalityBound_ <= 1.0f) {
+        pathCache_->store(grid, start, goal, path, lastPathCost_);
+    }
+    
+    return true;
+}
+
+void Pathfinder::setSearchAlgorithm(SearchAlgorithm algorithm, size_t memoryBudget) {
+    algorithm_ = algorithm;
+    switch (algorithm) {
+        case SearchAlgorithm::AStar:
+            engine_.reset();
+            break;
+        case SearchAlgorithm::Fringe:
+            engine_ = std::make_unique<FringeSearch>(memoryBudget);
+            break;
+        case SearchAlgorithm::IDAStar:
+            engine_ = std::make_unique<IDAStarSearch>(memoryBudget);
+            break;
+    }
+}
+
+bool Pathfinder::findPath(const Grid& grid, const Position& start, const Position& goal, PathResult& result) {
+    return findPath(grid, start, goal, result.resetSteps());
+}
+
+bool Pathfinder::findPathBounded(const Grid& grid, const Position& start, const Position& goal,
+                                 const SearchBudget& budget, std::vector<Position>& path) {
+    PF_TRACE_SCOPE("Pathfinder::findPathBounded");
+
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastSearchSteps_ = 0;
+    lastPathPartial_ = false;
+    lastSuboptimalityBound_ = 1.0f;
+    lastSearchStats_ = SearchStats();
+    
+    // An unwalkable goal is just unreachable here: the path still heads towards it
     if (!grid.isInBounds(start) || !grid.isWalkable(start)) {
-        std::cerr << "Start position is not valid or walkable!" << std::endl;
+        PF_LOG_WARNING("Start position ({}, {}) is not valid or walkable", start.x, start.y);
         return false;
     }
     
-    if (!grid.isInBounds(goal) || !grid.isWalkable(goal)) {
-        std::cerr << "Goal position is not valid or walkable!" << std::endl;
+    if (!grid.isInBounds(goal)) {
+        PF_LOG_WARNING("Goal position ({}, {}) is not valid", goal.x, goal.y);
+        return false;
+    }
+    
+    if (pathCache_ && pathCache_->lookup(grid, start, goal, path, lastPathCost_)) {
+        return true;
+    }
+    
+    GridState nodeStart(start, &grid);
+    GridState nodeEnd(goal, &grid);
+    
+    astarsearch_.SetPartialOnFailure(true);
+    bool found = searchPath(grid, nodeStart, nodeEnd, path, budget);
+    astarsearch_.SetPartialOnFailure(false);
+    
+    if (found && pathCache_ && !lastPathPartial_ && lastSuboptimalityBound_ <= 1.0f) {
+        pathCache_->store(grid, start, goal, path, lastPathCost_);
+    }
+    
+    return found;
+}
+
+bool Pathfinder::findPathAnytime(const Grid& grid, const Position& start, const Position& goal,
+                                 const AnytimeOptions& options, std::vector<Position>& path) {
+    PF_TRACE_SCOPE("Pathfinder::findPathAnytime");
+
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastSearchSteps_ = 0;
+    lastPathPartial_ = false;
+    lastSuboptimalityBound_ = 1.0f;
+    lastSearchStats_ = SearchStats();
+    
+    if (!validateEndpoints(grid, start, goal)) {
         return false;
     }
     
-    // Create start and goal states
+    if (pathCache_ && pathCache_->lookup(grid, start, goal, path, lastPathCost_)) {
+        return true;
+    }
+    
     GridState nodeStart(start, &grid);
     GridState nodeEnd(goal, &grid);
+    attachGoalBounds(grid, nodeEnd);
     
-    // Set A* start and goal states
-    astarsearch_.SetStartAndGoalStates(nodeStart, nodeEnd);
+    SearchBudget budget;
+    budget.maxMicros = options.maxMicros;
     
-    unsigned int SearchState;
-    unsigned int SearchSteps = 0;
+    float weight = astarsearch_.GetHeuristicWeight();
+    astarsearch_.SetHeuristicWeight(options.initialWeight);
+    astarsearch_.SetAnytime(true, options.weightStep);
+    bool found = searchPath(grid, nodeStart, nodeEnd, path, budget);
+    astarsearch_.SetAnytime(false);
+    astarsearch_.SetHeuristicWeight(weight);
     
-    // Perform the search step by step until complete
-    do {
-        SearchState = astarsearch_.SearchStep();
-        SearchSteps++;
+    if (found) {
+        PF_LOG_DEBUG("Anytime search found {} solutions, bound {}",
+                     astarsearch_.GetSolutionCount(), lastSuboptimalityBound_);
+        if (pathCache_ && lastSuboptimalityBound_ <= 1.0f) {
+            pathCache_->store(grid, start, goal, path, lastPathCost_);
+        }
+    }
+    
+    return found;
+}
+
+bool Pathfinder::findPathToNearest(const Grid& grid, const Position& start,
+                                   const std::vector<Position>& targets, std::vector<Position>& path) {
+    PF_TRACE_SCOPE("Pathfinder::findPathToNearest");
+
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastSearchSteps_ = 0;
+    lastPathPartial_ = false;
+    lastSuboptimalityBound_ = 1.0f;
+    lastSearchStats_ = SearchStats();
+    
+    if (!grid.isInBounds(start) || !grid.isWalkable(start)) {
+        PF_LOG_WARNING("Start position ({}, {}) is not valid or walkable", start.x, start.y);
+        return false;
+    }
+    
+    // Targets that cannot be stood on are never reached, so leave them out
+    goalSet_.clear();
+    for (const Position& target : targets) {
+        if (grid.isInBounds(target) && grid.isWalkable(target)) {
+            goalSet_.add(target);
+        }
+    }
+    if (goalSet_.empty()) {
+        PF_LOG_WARNING("None of the {} targets is valid or walkable", targets.size());
+        return false;
+    }
+    
+    // One search with every target as a goal; the goal state only carries the set
+    GridState nodeStart(start, &grid);
+    GridState nodeEnd(goalSet_.getGoals().front(), &grid);
+    nodeEnd.goals = &goalSet_;
+    
+    return searchPath(grid, nodeStart, nodeEnd, path);
+}
+
+bool Pathfinder::findDistance(const Grid& grid, const Position& start, const Position& goal, float& distance) {
+    PF_TRACE_SCOPE("Pathfinder::findDistance");
+
+    distance = std::numeric_limits<float>::infinity();
+    lastPathCost_ = 0.0f;
+    lastSearchSteps_ = 0;
+    lastPathPartial_ = false;
+    lastSuboptimalityBound_ = 1.0f;
+    lastSearchStats_ = SearchStats();
+    
+    if (!validateEndpoints(grid, start, goal)) {
+        return false;
+    }
+    
+    PF_SEARCH_STAT(auto phaseStart = std::chrono::steady_clock::now());
+    
+    GridState nodeStart(start, &grid);
+    GridState nodeEnd(goal, &grid);
+    attachGoalBounds(grid, nodeEnd);
+    
+    // Cost-only: on success the search frees all of its nodes itself
+    astarsearch_.SetCostOnly(true);
+    astarsearch_.SetStartAndGoalStates(nodeStart, nodeEnd);
+    unsigned int SearchState = runSearch();
+    astarsearch_.SetCostOnly(false);
+    PF_SEARCH_STAT(lastSearchStats_.searchMicros = lapMicros(phaseStart));
+    
+    if (SearchState == AStarSearch<GridState>::SEARCH_STATE_SUCCEEDED) {
+        lastPathCost_ = astarsearch_.GetSolutionCost();
+        distance = lastPathCost_;
+        PF_LOG_DEBUG("Distance found in {} steps, cost {}", lastSearchSteps_, lastPathCost_);
+        return true;
         
-    } while (SearchState == AStarSearch<GridState>::SEARCH_STATE_SEARCHING);
+    } else if (SearchState == AStarSearch<GridState>::SEARCH_STATE_OUT_OF_MEMORY) {
+        PF_LOG_WARNING("Search terminated after {} steps. Out of memory.", lastSearchSteps_);
+        return false;
+    }
     
-    lastSearchSteps_ = SearchSteps;
+    PF_LOG_DEBUG("Search terminated after {} steps. No solution found.", lastSearchSteps_);
+    return false;
+}
+
+size_t Pathfinder::findDistances(const Grid& grid, const Position& start,
+                                 const std::vector<Position>& targets, std::vector<float>& distances) {
+    PF_TRACE_SCOPE("Pathfinder::findDistances");
+
+    lastPathCost_ = 0.0f;
+    lastSearchSteps_ = 0;
+    lastPathPartial_ = false;
+    lastSuboptimalityBound_ = 1.0f;
+    lastSearchStats_ = SearchStats();
+    
+    if (!grid.isInBounds(start) || !grid.isWalkable(start)) {
+        PF_LOG_WARNING("Start position ({}, {}) is not valid or walkable", start.x, start.y);
+        distances.assign(targets.size(), std::numeric_limits<float>::infinity());
+        return 0;
+    }
+    
+    // One Dijkstra search settles the targets in cost order, where A* would need one search each
+    size_t reachable = dijkstra_.distancesTo(grid, start, targets, distances);
+    lastSearchSteps_ = static_cast<int>(dijkstra_.getLastExpansions());
+    PF_LOG_DEBUG("Distances to {} of {} targets found in {} steps", reachable, targets.size(), lastSearchSteps_);
+    return reachable;
+}
+
+void Pathfinder::attachGoalBounds(const Grid& grid, GridState& nodeEnd) const {
+    if (!goalBounds_) {
+        return;
+    }
+    if (goalBounds_->isValidFor(grid)) {
+        nodeEnd.goalBounds = goalBounds_;
+    } else {
+        PF_LOG_DEBUG("Goal bounds are stale (revision {}, grid {}), not pruning",
+                     goalBounds_->getRevision(), grid.getRevision());
+    }
+}
+
+bool Pathfinder::searchPath(const Grid& grid, GridState& nodeStart, GridState& nodeEnd, std::vector<Position>& path,
+                            const SearchBudget& budget) {
+    PF_SEARCH_STAT(auto phaseStart = std::chrono::steady_clock::now());
+    
+    // Set A* start and goal states
+    astarsearch_.SetStartAndGoalStates(nodeStart, nodeEnd);
+    
+    unsigned int SearchState = runSearch(budget);
+    unsigned int SearchSteps = lastSearchSteps_;
+    PF_SEARCH_STAT(lastSearchStats_.searchMicros = lapMicros(phaseStart));
     
     if (SearchState == AStarSearch<GridState>::SEARCH_STATE_SUCCEEDED) {
         // Found a path! Extract it
-        std::cout << "Path found in " << SearchSteps << " steps!" << std::endl;
+        PF_TRACE_SCOPE("Pathfinder::extractPath");
+        lastPathCost_ = astarsearch_.GetSolutionCost();
+        lastPathPartial_ = astarsearch_.IsSolutionPartial();
+        lastSuboptimalityBound_ = astarsearch_.GetSuboptimalityBound();
         
-        GridState* node = astarsearch_.GetSolutionStart();
+        // No step costs less than the cheapest terrain present, which bounds the number of
+        // positions (exact with uniform costs): size the buffer once and fill it in place
+        size_t expected = static_cast<size_t>(lastPathCost_ / grid.getMinMoveCost() + 0.5f) + 1;
+        path.resize(std::min(expected, static_cast<size_t>(grid.getWidth()) * grid.getHeight()));
         
-        // Build the path
-        while (true) {
-            path.push_back(node->position);
-            
-            node = astarsearch_.GetSolutionNext();
-            
-            if (!node) {
-                break;
+        size_t length = 0;
+        for (GridState* node = astarsearch_.GetSolutionStart(); node; node = astarsearch_.GetSolutionNext()) {
+            if (length < path.size()) {
+                path[length] = node->position;
+            } else {
+                path.push_back(node->position);
             }
+            length++;
         }
-        
-        // Get path cost
-        lastPathCost_ = astarsearch_.GetSolutionCost();
+        path.resize(length);
+        PF_SEARCH_STAT(lastSearchStats_.extractionMicros = lapMicros(phaseStart));
         
         // Clean up memory
         astarsearch_.FreeSolutionNodes();
+        PF_SEARCH_STAT(lastSearchStats_.teardownMicros = lapMicros(phaseStart));
         
-        std::cout << "Path cost: " << lastPathCost_ << std::endl;
-        std::cout << "Path length: " << path.size() << " steps" << std::endl;
+        if (lastPathPartial_) {
+            PF_LOG_DEBUG("Partial path after {} steps, cost {}, length {}", SearchSteps, lastPathCost_, path.size());
+        } else {
+            PF_LOG_DEBUG("Path found in {} steps, cost {}, length {}", SearchSteps, lastPathCost_, path.size());
+        }
         
         return true;
         
     } else if (SearchState == AStarSearch<GridState>::SEARCH_STATE_FAILED) {
-        std::cout << "Search terminated. No solution found." << std::endl;
+        PF_LOG_DEBUG("Search terminated after {} steps. No solution found.", SearchSteps);
         return false;
         
     } else if (SearchState == AStarSearch<GridState>::SEARCH_STATE_OUT_OF_MEMORY) {
-        std::cout << "Search terminated. Out of memory." << std::endl;
+        PF_LOG_WARNING("Search terminated after {} steps. Out of memory.", SearchSteps);
         return false;
     }
     
     return false;
+}
+
+bool Pathfinder::validateEndpoints(const Grid& grid, const Position& start, const Position& goal) const {
+    if (!grid.isInBounds(start) || !grid.isWalkable(start)) {
+        PF_LOG_WARNING("Start position ({}, {}) is not valid or walkable", start.x, start.y);
+        return false;
+    }
+    
+    if (!grid.isInBounds(goal) || !grid.isWalkable(goal)) {
+        PF_LOG_WARNING("Goal position ({}, {}) is not valid or walkable", goal.x, goal.y);
+        return false;
+    }
+    
+    return true;
+}
+
+unsigned int Pathfinder::runSearch(const SearchBudget& budget) {
+    // Reading the clock every step would cost more than the steps themselves
+    const unsigned int kClockInterval = 64;
+    
+    unsigned int SearchState;
+    unsigned int SearchSteps = 0;
+    auto searchStart = std::chrono::steady_clock::now();
+    
+    // Perform the search step by step until complete
+    {
+        PF_TRACE_SCOPE("AStarSearch::SearchStep loop");
+        do {
+            SearchState = astarsearch_.SearchStep();
+            SearchSteps++;
+            
+            if (SearchState != AStarSearch<GridState>::SEARCH_STATE_SEARCHING) {
+                break;
+            }
+            
+            bool outOfBudget = budget.maxExpansions > 0 && SearchSteps >= budget.maxExpansions;
+            if (!outOfBudget && budget.maxMicros > 0.0 && SearchSteps % kClockInterval == 0) {
+                auto elapsed = std::chrono::steady_clock::now() - searchStart;
+                outOfBudget = std::chrono::duration<double, std::micro>(elapsed).count() >= budget.maxMicros;
+            }
+            // Anytime searches keep going until they have a first solution to stop at
+            if (outOfBudget && astarsearch_.IsAnytime()) {
+                if (astarsearch_.StopAtIncumbent()) {
+                    SearchState = AStarSearch<GridState>::SEARCH_STATE_SUCCEEDED;
+                }
+            } else if (outOfBudget) {
+                SearchState = astarsearch_.StopAtBestNode() ? AStarSearch<GridState>::SEARCH_STATE_SUCCEEDED
+                                                            : AStarSearch<GridState>::SEARCH_STATE_FAILED;
+            }
+            
+        } while (SearchState == AStarSearch<GridState>::SEARCH_STATE_SEARCHING);
+    }
+    
+    lastSearchSteps_ = SearchSteps;
+    PF_SEARCH_STAT(lastSearchStats_ = astarsearch_.GetSearchStats());
+    return SearchState;
 }
\ No newline at end of file
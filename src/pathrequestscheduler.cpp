@@ -0,0 +1,242 @@
+#include "pathfinding/pathrequestscheduler.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    // Number of latency samples kept for the percentile report
+    const size_t kLatencySampleCount = 1024;
+}
+
+// Higher urgency first, then shorter requests, then submission order
+bool PathRequestScheduler::QueueKey::operator<(const QueueKey& other) const {
+    if (urgency != other.urgency) {
+        return urgency > other.urgency;
+    }
+    if (distance != other.distance) {
+        return distance < other.distance;
+    }
+    return sequence < other.sequence;
+}
+
+size_t PathRequestScheduler::EndpointsHash::operator()(const std::pair<Position, Position>& endpoints) const {
+    size_t hash = static_cast<size_t>(endpoints.first.x);
+    hash = hash * 31 + static_cast<size_t>(endpoints.first.y);
+    hash = hash * 31 + static_cast<size_t>(endpoints.second.x);
+    hash = hash * 31 + static_cast<size_t>(endpoints.second.y);
+    return hash;
+}
+
+// Constructor
+PathRequestScheduler::PathRequestScheduler(int expansionsPerTick)
+    : expansionsPerTick_(expansionsPerTick), lastTickExpansions_(0),
+      nextId_(1), nextSequence_(0), searching_(false), activeId_(0),
+      completedCount_(0), mergedCount_(0), latencyNext_(0) {
+}
+
+// Destructor
+PathRequestScheduler::~PathRequestScheduler() {
+    if (searching_) {
+        // Cancelling makes the next step release every node of the search
+        astarsearch_.CancelSearch();
+        astarsearch_.SearchStep();
+    }
+    astarsearch_.EnsureMemoryFreed();
+}
+
+PathRequestId PathRequestScheduler::submit(const Position& start, const Position& goal, int urgency) {
+    // Merge with an identical request that has not completed yet
+    auto open = openRequests_.find({start, goal});
+    if (open != openRequests_.end()) {
+        Request& request = requests_[open->second];
+        request.waiters++;
+        mergedCount_++;
+
+        if (urgency > request.urgency && request.status == PathRequestStatus::Pending) {
+            queue_.erase({request.urgency, request.distance, request.sequence, open->second});
+            request.urgency = urgency;
+            queue_.insert({request.urgency, request.distance, request.sequence, open->second});
+        }
+        return open->second;
+    }
+
+    PathRequestId id = nextId_++;
+
+    Request request;
+    request.start = start;
+    request.goal = goal;
+    request.urgency = urgency;
+    request.distance = abs(start.x - goal.x) + abs(start.y - goal.y);
+    request.sequence = nextSequence_++;
+    request.waiters = 1;
+    request.status = PathRequestStatus::Pending;
+    request.submitTime = std::chrono::steady_clock::now();
+
+    queue_.insert({request.urgency, request.distance, request.sequence, id});
+    openRequests_[{start, goal}] = id;
+    requests_[id] = std::move(request);
+
+    return id;
+}
+
+void PathRequestScheduler::tick(const Grid& grid) {
+    PF_TRACE_SCOPE("PathRequestScheduler::tick");
+    int expansions = 0;
+
+    while (expansions < expansionsPerTick_) {
+        if (!searching_ && !startNextSearch(grid)) {
+            break;  // Nothing left to do
+        }
+        if (!searching_) {
+            continue;  // Request was resolved without searching
+        }
+
+        unsigned int searchState;
+        do {
+            searchState = astarsearch_.SearchStep();
+            expansions++;
+        } while (searchState == AStarSearch<GridState>::SEARCH_STATE_SEARCHING &&
+                 expansions < expansionsPerTick_);
+
+        if (searchState != AStarSearch<GridState>::SEARCH_STATE_SEARCHING) {
+            finishActiveSearch(searchState);
+        }
+    }
+
+    lastTickExpansions_ = expansions;
+}
+
+PathRequestStatus PathRequestScheduler::getStatus(PathRequestId id) const {
+    auto it = requests_.find(id);
+    if (it == requests_.end()) {
+        return PathRequestStatus::Unknown;
+    }
+    return it->second.status;
+}
+
+bool PathRequestScheduler::takeResult(PathRequestId id, std::vector<Position>& path) {
+    path.clear();
+
+    auto it = requests_.find(id);
+    if (it == requests_.end()) {
+        return false;
+    }
+
+    Request& request = it->second;
+    if (request.status != PathRequestStatus::Succeeded && request.status != PathRequestStatus::Failed) {
+        return false;
+    }
+
+    bool succeeded = request.status == PathRequestStatus::Succeeded;
+
+    // The last merged caller gets to move the path out
+    if (--request.waiters > 0) {
+        path = request.path;
+    } else {
+        path = std::move(request.path);
+        requests_.erase(it);
+    }
+    return succeeded;
+}
+
+bool PathRequestScheduler::cancel(PathRequestId id) {
+    auto it = requests_.find(id);
+    if (it == requests_.end()) {
+        return false;
+    }
+
+    Request& request = it->second;
+    if (--request.waiters > 0) {
+        return true;
+    }
+
+    if (request.status == PathRequestStatus::Pending) {
+        queue_.erase({request.urgency, request.distance, request.sequence, id});
+        openRequests_.erase({request.start, request.goal});
+    } else if (request.status == PathRequestStatus::Searching) {
+        // Cancelling makes the next step release every node of the search
+        astarsearch_.CancelSearch();
+        astarsearch_.SearchStep();
+        searching_ = false;
+        openRequests_.erase({request.start, request.goal});
+    }
+    requests_.erase(it);
+    return true;
+}
+
+float PathRequestScheduler::getLatencyPercentile(float percentile) const {
+    if (latencySamples_.empty()) {
+        return 0.0f;
+    }
+
+    std::vector<float> samples(latencySamples_);
+    float clamped = std::min(std::max(percentile, 0.0f), 100.0f);
+    size_t rank = static_cast<size_t>(clamped / 100.0f * (samples.size() - 1) + 0.5f);
+
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+// Pop the most important request and set up its search
+// Returns false if the queue is empty
+bool PathRequestScheduler::startNextSearch(const Grid& grid) {
+    if (queue_.empty()) {
+        return false;
+    }
+
+    PathRequestId id = queue_.begin()->id;
+    queue_.erase(queue_.begin());
+
+    Request& request = requests_[id];
+
+    // Invalid endpoints fail straight away without spending budget
+    if (!grid.isWalkable(request.start) || !grid.isWalkable(request.goal)) {
+        completeRequest(id, false);
+        return true;
+    }
+
+    GridState nodeStart(request.start, &grid);
+    GridState nodeEnd(request.goal, &grid);
+    astarsearch_.SetStartAndGoalStates(nodeStart, nodeEnd);
+
+    request.status = PathRequestStatus::Searching;
+    searching_ = true;
+    activeId_ = id;
+    return true;
+}
+
+void PathRequestScheduler::finishActiveSearch(unsigned int searchState) {
+    searching_ = false;
+
+    if (searchState != AStarSearch<GridState>::SEARCH_STATE_SUCCEEDED) {
+        completeRequest(activeId_, false);
+        return;
+    }
+
+    Request& request = requests_[activeId_];
+    request.path.clear();
+
+    for (GridState* node = astarsearch_.GetSolutionStart(); node; node = astarsearch_.GetSolutionNext()) {
+        request.path.push_back(node->position);
+    }
+
+    astarsearch_.FreeSolutionNodes();
+    completeRequest(activeId_, true);
+}
+
+void PathRequestScheduler::completeRequest(PathRequestId id, bool succeeded) {
+    Request& request = requests_[id];
+    request.status = succeeded ? PathRequestStatus::Succeeded : PathRequestStatus::Failed;
+    openRequests_.erase({request.start, request.goal});
+    completedCount_++;
+
+    float latency = std::chrono::duration<float, std::micro>(
+        std::chrono::steady_clock::now() - request.submitTime).count();
+
+    if (latencySamples_.size() < kLatencySampleCount) {
+        latencySamples_.push_back(latency);
+    } else {
+        latencySamples_[latencyNext_] = latency;
+        latencyNext_ = (latencyNext_ + 1) % kLatencySampleCount;
+    }
+}
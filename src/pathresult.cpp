@@ -0,0 +1,87 @@
+#include "pathfinding/pathresult.h"
+#include <algorithm>
+
+namespace {
+    // Direction codes used by CompressedPath runs
+    const int kDirectionX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    const int kDirectionY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    int directionCode(const Position& from, const Position& to) {
+        int dx = to.x - from.x;
+        int dy = to.y - from.y;
+        for (int d = 0; d < 8; ++d) {
+            if (kDirectionX[d] == dx && kDirectionY[d] == dy) {
+                return d;
+            }
+        }
+        return -1;
+    }
+}
+
+void PathResult::advance(size_t count) {
+    cursor_ = std::min(cursor_ + count, steps_.size());
+}
+
+void PathResult::clear() {
+    steps_.clear();
+    cursor_ = 0;
+}
+
+std::vector<Position>& PathResult::resetSteps() {
+    cursor_ = 0;
+    return steps_;
+}
+
+bool CompressedPath::assign(const Position* begin, const Position* end) {
+    runs_.clear();
+    length_ = 0;
+    start_ = Position(0, 0);
+
+    if (begin == end) {
+        return true;
+    }
+
+    start_ = *begin;
+    for (const Position* pos = begin + 1; pos < end; ++pos) {
+        int direction = directionCode(pos[-1], pos[0]);
+        if (direction < 0) {
+            runs_.clear();
+            start_ = Position(0, 0);
+            return false;
+        }
+
+        // Extend the last run if it goes the same way and has room
+        if (!runs_.empty() && (runs_.back() >> 5) == direction &&
+            (runs_.back() & 0x1f) < kMaxRunLength - 1) {
+            runs_.back()++;
+        } else {
+            runs_.push_back(static_cast<std::uint8_t>(direction << 5));
+        }
+    }
+
+    length_ = end - begin;
+    return true;
+}
+
+PathResult CompressedPath::decompress() const {
+    std::vector<Position> steps;
+    if (length_ == 0) {
+        return PathResult(std::move(steps));
+    }
+
+    steps.reserve(length_);
+    steps.push_back(start_);
+
+    Position pos = start_;
+    for (std::uint8_t run : runs_) {
+        int direction = run >> 5;
+        int count = (run & 0x1f) + 1;
+        for (int i = 0; i < count; ++i) {
+            pos.x += kDirectionX[direction];
+            pos.y += kDirectionY[direction];
+            steps.push_back(pos);
+        }
+    }
+
+    return PathResult(std::move(steps));
+}
@@ -0,0 +1,48 @@
+#include "pathfinding/pathsmoothing.h"
+#include "pathfinding/trace.h"
+
+size_t smoothPath(const Grid& grid, const std::vector<Position>& path, std::vector<Position>& waypoints) {
+    PF_TRACE_SCOPE("smoothPath");
+    waypoints.clear();
+    if (path.size() <= 2) {
+        waypoints = path;
+        return waypoints.size();
+    }
+    
+    // Cost of the path up to each cell
+    std::vector<float> costs(path.size(), 0.0f);
+    for (size_t i = 1; i < path.size(); ++i) {
+        costs[i] = costs[i - 1] + grid.getStepCost(path[i - 1], path[i]);
+    }
+    
+    // Greedily stretch each segment from its anchor as far along the path as it stays clear
+    size_t anchor = 0;
+    waypoints.push_back(path[0]);
+    for (size_t i = 2; i < path.size(); ++i) {
+        float lineCost = 0.0f;
+        if (!grid.hasLineOfSight(path[anchor], path[i], &lineCost) ||
+            lineCost > costs[i] - costs[anchor]) {
+            anchor = i - 1;
+            waypoints.push_back(path[anchor]);
+        }
+    }
+    waypoints.push_back(path.back());
+    
+    return waypoints.size();
+}
+
+void expandWaypoints(const std::vector<Position>& waypoints, Connectivity connectivity,
+                     std::vector<Position>& path) {
+    path.clear();
+    if (waypoints.empty()) {
+        return;
+    }
+    
+    path.push_back(waypoints[0]);
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        GridLine line(waypoints[i - 1], waypoints[i], connectivity);
+        while (!line.done()) {
+            path.push_back(line.next());
+        }
+    }
+}
@@ -0,0 +1,439 @@
+#include "pathfinding/subgoalgraph.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace {
+    const float kInfinity = std::numeric_limits<float>::infinity();
+
+    const int kCardinals[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    const int kDiagonals[4][2] = {{1, 1}, {-1, 1}, {-1, -1}, {1, -1}};
+
+    int sign(int value) {
+        return (value > 0) - (value < 0);
+    }
+}
+
+// Constructor
+SubgoalGraph::SubgoalGraph()
+    : width_(0), height_(0), revision_(0), cellHash_(0), moveCost_(1.0f), subgoalCount_(0), edgeCount_(0),
+      stamp_(0), lastPathCost_(0.0f), lastExpansions_(0) {
+}
+
+bool SubgoalGraph::supports(const Grid& grid) {
+    return grid.getConnectivity() == Connectivity::Eight && grid.getCornerCutting() == CornerCutting::Forbid &&
+           grid.hasUniformCosts();
+}
+
+bool SubgoalGraph::build(const Grid& grid) {
+    PF_TRACE_SCOPE("SubgoalGraph::build");
+
+    clear();
+    if (!supports(grid)) {
+        PF_LOG_DEBUG("Subgoal graphs need 8-connected moves without corner cutting and uniform costs");
+        return false;
+    }
+
+    width_ = grid.getWidth();
+    height_ = grid.getHeight();
+    moveCost_ = grid.getMinMoveCost();
+    subgoalAt_.assign(static_cast<size_t>(width_) * height_, -1);
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            refreshCell(grid, Position(x, y));
+        }
+    }
+    for (size_t id = 0; id < subgoals_.size(); ++id) {
+        link(grid, static_cast<int>(id));
+    }
+    revision_ = grid.getRevision();
+    cellHash_ = grid.getCellHash();
+
+    PF_LOG_DEBUG("Subgoal graph with {} subgoals and {} edges", subgoalCount_, edgeCount_);
+    return true;
+}
+
+size_t SubgoalGraph::update(const Grid& grid, const GridChangeBatch& batch) {
+    PF_TRACE_SCOPE("SubgoalGraph::update");
+
+    if (subgoalAt_.empty() || batch.fromRevision != revision_ || !supports(grid) ||
+        grid.getWidth() != width_ || grid.getHeight() != height_ || grid.getMinMoveCost() != moveCost_) {
+        return build(grid) ? subgoalCount_ : 0;
+    }
+
+    // Cells that opened or closed, and cells whose subgoal came or went: a corner depends
+    // on the 3x3 block around it
+    std::vector<Position> touched;
+    for (const CellChange& change : batch.changes) {
+        if ((change.oldType == CellType::Wall) == (change.newType == CellType::Wall)) {
+            continue;
+        }
+        touched.push_back(change.position);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                Position pos(change.position.x + dx, change.position.y + dy);
+                if (refreshCell(grid, pos)) {
+                    touched.push_back(pos);
+                }
+            }
+        }
+    }
+
+    // Edges only change for subgoals that read a touched cell while linking, and for
+    // the new subgoals (whose box is still empty)
+    size_t relinked = 0;
+    if (!touched.empty()) {
+        for (size_t id = 0; id < subgoals_.size(); ++id) {
+            const Subgoal& subgoal = subgoals_[id];
+            if (subgoalAt(subgoal.pos) != static_cast<int>(id)) {
+                continue;
+            }
+            const Box& box = subgoal.scanned;
+            bool dirty = box.minX > box.maxX;
+            for (size_t i = 0; i < touched.size() && !dirty; ++i) {
+                dirty = touched[i].x >= box.minX && touched[i].x <= box.maxX &&
+                        touched[i].y >= box.minY && touched[i].y <= box.maxY;
+            }
+            if (dirty) {
+                link(grid, static_cast<int>(id));
+                ++relinked;
+            }
+        }
+    }
+    revision_ = batch.toRevision;
+    cellHash_ = grid.getCellHash();
+
+    PF_LOG_DEBUG("Subgoal graph relinked {} of {} subgoals", relinked, subgoalCount_);
+    return relinked;
+}
+
+bool SubgoalGraph::isValidFor(const Grid& grid) const {
+    return !subgoalAt_.empty() && grid.getRevision() == revision_ && grid.getCellHash() == cellHash_ &&
+           grid.getWidth() == width_ && grid.getHeight() == height_ && supports(grid) &&
+           grid.getMinMoveCost() == moveCost_;
+}
+
+bool SubgoalGraph::findPath(const Grid& grid, const Position& start, const Position& goal, std::vector<Position>& path) {
+    PF_TRACE_SCOPE("SubgoalGraph::findPath");
+
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastExpansions_ = 0;
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) {
+        return false;
+    }
+    // A goal in plain view needs no graph: a walk as short as the octile distance is optimal
+    // (this also keeps queries in open areas, which have no subgoals to stop the scans, short)
+    path.push_back(start);
+    if (walk(grid, start, goal, true, path) || walk(grid, start, goal, false, path)) {
+        lastPathCost_ = distance(start, goal);
+        return true;
+    }
+    path.clear();
+
+    // Start and goal that are not subgoals take the two ids past the subgoals
+    const int count = static_cast<int>(subgoals_.size());
+    const int startNode = isSubgoal(start) ? subgoalAt(start) : count;
+    const int goalNode = isSubgoal(goal) ? subgoalAt(goal) : count + 1;
+    nodes_.resize(count + 2, Node{0, false, kInfinity, -1});
+    goalLinks_.resize(count + 2, kInfinity);
+    if (++stamp_ == 0) {
+        for (Node& node : nodes_) {
+            node.stamp = 0;
+        }
+        stamp_ = 1;
+    }
+
+    // Link the start to the subgoals (and the goal) directly h-reachable from it
+    startEdges_.clear();
+    if (startNode == count) {
+        scan(grid, start, &goal, found_, nullptr);
+        for (const Position& pos : found_) {
+            startEdges_.push_back({pos == goal ? goalNode : subgoalAt(pos), distance(start, pos)});
+        }
+    }
+
+    // and the goal to the subgoals it is directly h-reachable from (moves are symmetric)
+    for (int id : linkedToGoal_) {
+        goalLinks_[id] = kInfinity;
+    }
+    linkedToGoal_.clear();
+    if (goalNode == count + 1) {
+        scan(grid, goal, nullptr, found_, nullptr);
+        for (const Position& pos : found_) {
+            int id = subgoalAt(pos);
+            goalLinks_[id] = distance(pos, goal);
+            linkedToGoal_.push_back(id);
+        }
+    }
+
+    auto positionOf = [&](int id) -> const Position& {
+        return id < count ? subgoals_[id].pos : (id == count ? start : goal);
+    };
+    auto node = [&](int id) -> Node& {
+        Node& entry = nodes_[id];
+        if (entry.stamp != stamp_) {
+            entry = Node{stamp_, false, kInfinity, -1};
+        }
+        return entry;
+    };
+
+    // A* over the subgoals, ordered on f; stale heap entries are skipped once closed
+    std::vector<std::pair<float, int>>& open = open_;
+    open.clear();
+    auto relax = [&](int from, int to, float g) {
+        Node& target = node(to);
+        if (!target.closed && g < target.g) {
+            target.g = g;
+            target.parent = from;
+            open.emplace_back(g + distance(positionOf(to), goal), to);
+            std::push_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+        }
+    };
+    relax(-1, startNode, 0.0f);
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+        int id = open.back().second;
+        open.pop_back();
+        Node& current = node(id);
+        if (current.closed) {
+            continue;
+        }
+        current.closed = true;
+        ++lastExpansions_;
+        if (id == goalNode) {
+            found = true;
+            break;
+        }
+
+        const std::vector<Edge>& edges = id == count ? startEdges_ : subgoals_[id].edges;
+        float g = current.g;
+        for (const Edge& edge : edges) {
+            relax(id, edge.target, g + edge.cost);
+        }
+        if (goalLinks_[id] < kInfinity) {
+            relax(id, goalNode, g + goalLinks_[id]);
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    // Refine every edge back to cells. Edges found scanning from their first end walk
+    // diagonally first, those found from their second end straight first.
+    std::vector<int> ids;
+    for (int id = goalNode; id >= 0; id = nodes_[id].parent) {
+        ids.push_back(id);
+    }
+    path.push_back(start);
+    for (size_t i = ids.size() - 1; i > 0; --i) {
+        const Position& from = positionOf(ids[i]);
+        const Position& to = positionOf(ids[i - 1]);
+        if (!walk(grid, from, to, true, path) && !walk(grid, from, to, false, path)) {
+            PF_LOG_WARNING("Subgoal graph edge from ({}, {}) is blocked; is the graph up to date?", from.x, from.y);
+            path.clear();
+            return false;
+        }
+    }
+    lastPathCost_ = nodes_[goalNode].g;
+    return true;
+}
+
+bool SubgoalGraph::isCorner(const Grid& grid, const Position& pos) {
+    if (!grid.isWalkable(pos)) {
+        return false;
+    }
+    for (const auto& diagonal : kDiagonals) {
+        if (!grid.isWalkable(pos.x + diagonal[0], pos.y + diagonal[1]) &&
+            grid.isWalkable(pos.x + diagonal[0], pos.y) && grid.isWalkable(pos.x, pos.y + diagonal[1])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SubgoalGraph::clearance(const Grid& grid, Position from, int dx, int dy, int limit,
+                            const Position* extra, Box* box) const {
+    int cells = 0;
+    while (cells < limit) {
+        from.x += dx;
+        from.y += dy;
+        if (box) {
+            box->minX = std::min(box->minX, from.x);
+            box->minY = std::min(box->minY, from.y);
+            box->maxX = std::max(box->maxX, from.x);
+            box->maxY = std::max(box->maxY, from.y);
+        }
+        if (!grid.isWalkable(from) || stopsScan(from, extra)) {
+            break;
+        }
+        ++cells;
+    }
+    return cells;
+}
+
+// Sweep each quadrant diagonally; from every cell of the diagonal, look straight along the
+// two sides of the quadrant. A subgoal seen at some distance hides the cells behind it on
+// the next sweep line (paths there pass through it), and a wall shortens the next line
+// the same way, so the lines only shrink.
+void SubgoalGraph::scan(const Grid& grid, const Position& from, const Position* extra,
+                        std::vector<Position>& found, Box* box) const {
+    found.clear();
+    const int unlimited = width_ + height_;
+
+    // Straight lines first; their lengths bound the first diagonal sweep line
+    int straight[4];
+    for (int c = 0; c < 4; ++c) {
+        int dx = kCardinals[c][0];
+        int dy = kCardinals[c][1];
+        straight[c] = clearance(grid, from, dx, dy, unlimited, extra, box);
+        Position end(from.x + (straight[c] + 1) * dx, from.y + (straight[c] + 1) * dy);
+        if (stopsScan(end, extra)) {
+            found.push_back(end);
+            --straight[c];
+        }
+    }
+
+    for (int d = 0; d < 4; ++d) {
+        int dx = kDiagonals[d][0];
+        int dy = kDiagonals[d][1];
+        // Straight directions on the two sides of the quadrant, and how far to look along them
+        int sides[2][2] = {{dx, 0}, {0, dy}};
+        int limits[2] = {straight[dx > 0 ? 0 : 2], straight[dy > 0 ? 1 : 3]};
+
+        Position pos = from;
+        for (;;) {
+            Position next(pos.x + dx, pos.y + dy);
+            if (box) {
+                box->minX = std::min(box->minX, std::min(pos.x, next.x));
+                box->minY = std::min(box->minY, std::min(pos.y, next.y));
+                box->maxX = std::max(box->maxX, std::max(pos.x, next.x));
+                box->maxY = std::max(box->maxY, std::max(pos.y, next.y));
+            }
+            if (!grid.canMove(pos, next)) {
+                break;
+            }
+            pos = next;
+            if (stopsScan(pos, extra)) {
+                found.push_back(pos);
+                break;
+            }
+
+            for (int side = 0; side < 2; ++side) {
+                int sx = sides[side][0];
+                int sy = sides[side][1];
+                int cells = clearance(grid, pos, sx, sy, limits[side] + 1, extra, box);
+                if (cells <= limits[side]) {
+                    Position end(pos.x + (cells + 1) * sx, pos.y + (cells + 1) * sy);
+                    if (stopsScan(end, extra)) {
+                        found.push_back(end);
+                        --cells;
+                    }
+                    limits[side] = cells;
+                }
+            }
+        }
+    }
+}
+
+bool SubgoalGraph::refreshCell(const Grid& grid, const Position& pos) {
+    if (!grid.isInBounds(pos)) {
+        return false;
+    }
+    int& slot = subgoalAt_[pos.y * width_ + pos.x];
+    bool corner = isCorner(grid, pos);
+    if (corner == (slot >= 0)) {
+        return false;
+    }
+
+    if (corner) {
+        if (freeIds_.empty()) {
+            slot = static_cast<int>(subgoals_.size());
+            subgoals_.emplace_back();
+        } else {
+            slot = freeIds_.back();
+            freeIds_.pop_back();
+        }
+        Subgoal& subgoal = subgoals_[slot];
+        subgoal.pos = pos;
+        subgoal.scanned = Box{1, 1, 0, 0};
+        ++subgoalCount_;
+    } else {
+        Subgoal& subgoal = subgoals_[slot];
+        edgeCount_ -= subgoal.edges.size();
+        subgoal.edges.clear();
+        freeIds_.push_back(slot);
+        slot = -1;
+        --subgoalCount_;
+    }
+    return true;
+}
+
+void SubgoalGraph::link(const Grid& grid, int id) {
+    Subgoal& subgoal = subgoals_[id];
+    subgoal.scanned = Box{subgoal.pos.x, subgoal.pos.y, subgoal.pos.x, subgoal.pos.y};
+    std::vector<Position> found;
+    scan(grid, subgoal.pos, nullptr, found, &subgoal.scanned);
+
+    edgeCount_ -= subgoal.edges.size();
+    subgoal.edges.clear();
+    for (const Position& pos : found) {
+        subgoal.edges.push_back({subgoalAt(pos), distance(subgoal.pos, pos)});
+    }
+    edgeCount_ += subgoal.edges.size();
+}
+
+float SubgoalGraph::distance(const Position& from, const Position& to) const {
+    int dx = std::abs(to.x - from.x);
+    int dy = std::abs(to.y - from.y);
+    return (std::min(dx, dy) * Grid::kDiagonalCost + std::abs(dx - dy)) * moveCost_;
+}
+
+bool SubgoalGraph::walk(const Grid& grid, const Position& from, const Position& to, bool diagonalFirst,
+                        std::vector<Position>& path) {
+    int dx = std::abs(to.x - from.x);
+    int dy = std::abs(to.y - from.y);
+    int diagonal[2] = {sign(to.x - from.x), sign(to.y - from.y)};
+    int straight[2] = {dx > dy ? diagonal[0] : 0, dx > dy ? 0 : diagonal[1]};
+    int phases[2] = {std::min(dx, dy), std::abs(dx - dy)};
+    const int* moves[2] = {diagonal, straight};
+    if (!diagonalFirst) {
+        std::swap(phases[0], phases[1]);
+        std::swap(moves[0], moves[1]);
+    }
+
+    size_t size = path.size();
+    Position pos = from;
+    for (int phase = 0; phase < 2; ++phase) {
+        for (int step = 0; step < phases[phase]; ++step) {
+            Position next(pos.x + moves[phase][0], pos.y + moves[phase][1]);
+            if (!grid.canMove(pos, next)) {
+                path.resize(size);
+                return false;
+            }
+            path.push_back(next);
+            pos = next;
+        }
+    }
+    return true;
+}
+
+void SubgoalGraph::clear() {
+    width_ = 0;
+    height_ = 0;
+    subgoalAt_.clear();
+    subgoals_.clear();
+    freeIds_.clear();
+    subgoalCount_ = 0;
+    edgeCount_ = 0;
+    nodes_.clear();
+    goalLinks_.clear();
+    linkedToGoal_.clear();
+}
@@ -0,0 +1,270 @@
+#include "pathfinding/symmetryreduction.h"
+#include "pathfinding/log.h"
+#include "pathfinding/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+    // Search nodes beyond one per border cell: start, goal and one expansion's successors
+    const int kSearchSlack = 8;
+
+    int manhattan(const Position& from, const Position& to) {
+        return std::abs(from.x - to.x) + std::abs(from.y - to.y);
+    }
+}
+
+// Heuristic function - Manhattan distance at the cheapest terrain
+float SymmetryState::GoalDistanceEstimate(SymmetryState& nodeGoal) {
+    return static_cast<float>(manhattan(position, nodeGoal.position)) * reduction->minMoveCost_;
+}
+
+bool SymmetryState::IsGoal(SymmetryState& nodeGoal) {
+    return position == nodeGoal.position;
+}
+
+bool SymmetryState::GetSuccessors(AStarSearch<SymmetryState>* astarsearch, SymmetryState* parent_node) {
+    reduction->addSuccessors(astarsearch, *this, parent_node, astarsearch->GetGoalState()->position);
+    return true;
+}
+
+float SymmetryState::GetCost(SymmetryState& successor) {
+    return reduction->moveCost(position, successor.position);
+}
+
+bool SymmetryState::IsSameState(SymmetryState& rhs) {
+    return position == rhs.position;
+}
+
+size_t SymmetryState::Hash() {
+    return static_cast<size_t>(position.y) * reduction->width_ + static_cast<size_t>(position.x);
+}
+
+// Constructor
+SymmetryReduction::SymmetryReduction()
+    : width_(0), height_(0), revision_(0), cellHash_(0), connectivity_(Connectivity::Four),
+      cornerCutting_(CornerCutting::Forbid), terrainCosts_{}, minMoveCost_(1.0f), borderCount_(0),
+      buildMicros_(0.0), lastPathCost_(0.0f), lastExpansions_(0) {
+}
+
+bool SymmetryReduction::supports(const Grid& grid) {
+    return grid.getConnectivity() == Connectivity::Four;
+}
+
+bool SymmetryReduction::build(const Grid& grid) {
+    PF_TRACE_SCOPE("SymmetryReduction::build");
+    auto buildStart = std::chrono::steady_clock::now();
+
+    search_.reset();
+    rects_.clear();
+    rectAt_.clear();
+    borderCount_ = 0;
+    buildMicros_ = 0.0;
+    if (!supports(grid)) {
+        PF_LOG_DEBUG("Grid is not 4-connected, no symmetry reduction");
+        return false;
+    }
+
+    width_ = grid.getWidth();
+    height_ = grid.getHeight();
+    connectivity_ = grid.getConnectivity();
+    cornerCutting_ = grid.getCornerCutting();
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        terrainCosts_[type] = grid.getTerrainCost(static_cast<CellType>(type));
+    }
+    minMoveCost_ = grid.getMinMoveCost();
+    rectAt_.assign(static_cast<size_t>(width_) * height_, -1);
+
+    // Greedy decomposition: the first uncovered cell in scan order is the top-left corner
+    // of the largest rectangle of its terrain that fits among the uncovered cells
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            Position pos(x, y);
+            if (rectAt_[y * width_ + x] >= 0 || !grid.isWalkable(pos)) {
+                continue;
+            }
+            Rect rect = grow(grid, pos, grid.getCell(pos));
+            int id = static_cast<int>(rects_.size());
+            for (int ry = rect.minY; ry <= rect.maxY; ++ry) {
+                std::fill(rectAt_.begin() + ry * width_ + rect.minX, rectAt_.begin() + ry * width_ + rect.maxX + 1, id);
+            }
+            rects_.push_back(rect);
+
+            int innerWidth = std::max(0, rect.maxX - rect.minX - 1);
+            int innerHeight = std::max(0, rect.maxY - rect.minY - 1);
+            borderCount_ += static_cast<size_t>(rect.maxX - rect.minX + 1) * (rect.maxY - rect.minY + 1) -
+                            static_cast<size_t>(innerWidth) * innerHeight;
+        }
+    }
+
+    search_ = std::make_unique<AStarSearch<SymmetryState>>(static_cast<int>(borderCount_) + kSearchSlack);
+    revision_ = grid.getRevision();
+    cellHash_ = grid.getCellHash();
+    buildMicros_ = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - buildStart).count();
+    PF_LOG_DEBUG("Symmetry reduction kept {} of {} cells in {} rectangles ({} us)", borderCount_,
+                 static_cast<size_t>(width_) * height_, rects_.size(), buildMicros_);
+    return true;
+}
+
+bool SymmetryReduction::isValidFor(const Grid& grid) const {
+    return search_ && grid.getRevision() == revision_ && grid.getCellHash() == cellHash_ && sameRules(grid);
+}
+
+bool SymmetryReduction::sameRules(const Grid& grid) const {
+    if (grid.getWidth() != width_ || grid.getHeight() != height_ ||
+        grid.getConnectivity() != connectivity_ || grid.getCornerCutting() != cornerCutting_) {
+        return false;
+    }
+    for (int type = 0; type < kCellTypeCount; ++type) {
+        if (grid.getTerrainCost(static_cast<CellType>(type)) != terrainCosts_[type]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Narrow the run of matching cells row by row and keep the largest area seen
+SymmetryReduction::Rect SymmetryReduction::grow(const Grid& grid, const Position& from, CellType type) const {
+    Rect best = {from.x, from.y, from.x, from.y, grid.getTerrainCost(type)};
+    int bestArea = 0;
+    int run = width_ - from.x;
+    for (int y = from.y; y < height_; ++y) {
+        int length = 0;
+        while (length < run && rectAt_[y * width_ + from.x + length] < 0 &&
+               grid.getCell(from.x + length, y) == type) {
+            length++;
+        }
+        if (length == 0) {
+            break;
+        }
+        run = length;
+        int area = run * (y - from.y + 1);
+        if (area > bestArea) {
+            bestArea = area;
+            best.maxX = from.x + run - 1;
+            best.maxY = y;
+        }
+    }
+    return best;
+}
+
+bool SymmetryReduction::isBorder(const Position& pos) const {
+    if (pos.x < 0 || pos.y < 0 || pos.x >= width_ || pos.y >= height_ || rectAt_.empty()) {
+        return false;
+    }
+    const Rect* rect = rectAt(pos);
+    return rect && (pos.x == rect->minX || pos.x == rect->maxX || pos.y == rect->minY || pos.y == rect->maxY);
+}
+
+void SymmetryReduction::addSuccessors(AStarSearch<SymmetryState>* astarsearch, const SymmetryState& state,
+                                      const SymmetryState* parent, const Position& goal) const {
+    const Position& pos = state.position;
+    const Rect* rect = rectAt(pos);
+    auto add = [&](const Position& next) {
+        if (parent && next == parent->position) {
+            return;
+        }
+        SymmetryState successor(next, this);
+        astarsearch->AddSuccessor(successor);
+    };
+
+    // Only the start can lie inside a rectangle: it steps straight out to the border on
+    // all four sides, or to the goal when that is in the same rectangle
+    if (!isBorder(pos)) {
+        Position exits[4] = {Position(pos.x, rect->minY), Position(pos.x, rect->maxY),
+                             Position(rect->minX, pos.y), Position(rect->maxX, pos.y)};
+        for (const Position& exit : exits) {
+            add(exit);
+        }
+        if (rectAt(goal) == rect && std::find(exits, exits + 4, goal) == exits + 4) {
+            add(goal);
+        }
+        return;
+    }
+
+    // Moves into other rectangles and along the border; interior cells are skipped
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    for (int dir = 0; dir < 4; ++dir) {
+        Position next(pos.x + dx[dir], pos.y + dy[dir]);
+        if (next.x < 0 || next.y < 0 || next.x >= width_ || next.y >= height_) {
+            continue;
+        }
+        const Rect* nextRect = rectAt(next);
+        if (nextRect && (nextRect != rect || isBorder(next) || next == goal)) {
+            add(next);
+        }
+    }
+
+    // Macro edges straight across to the facing side
+    if ((pos.y == rect->minY || pos.y == rect->maxY) && pos.x > rect->minX && pos.x < rect->maxX &&
+        rect->maxY - rect->minY > 1) {
+        add(Position(pos.x, pos.y == rect->minY ? rect->maxY : rect->minY));
+    }
+    if ((pos.x == rect->minX || pos.x == rect->maxX) && pos.y > rect->minY && pos.y < rect->maxY &&
+        rect->maxX - rect->minX > 1) {
+        add(Position(pos.x == rect->minX ? rect->maxX : rect->minX, pos.y));
+    }
+
+    // A goal inside the rectangle is reached from the border cells in line with it
+    if (rectAt(goal) == rect && !isBorder(goal) && (goal.x == pos.x || goal.y == pos.y) &&
+        manhattan(pos, goal) > 1) {
+        add(goal);
+    }
+}
+
+// Every cell walked into lies in the rectangle of to, so each costs the same
+float SymmetryReduction::moveCost(const Position& from, const Position& to) const {
+    return static_cast<float>(manhattan(from, to)) * rectAt(to)->cost;
+}
+
+bool SymmetryReduction::findPath(const Grid& grid, const Position& start, const Position& goal,
+                                 std::vector<Position>& path) {
+    PF_TRACE_SCOPE("SymmetryReduction::findPath");
+
+    path.clear();
+    lastPathCost_ = 0.0f;
+    lastExpansions_ = 0;
+    if (!search_ || !grid.isInBounds(start) || !grid.isInBounds(goal) || !rectAt(start) || !rectAt(goal)) {
+        return false;
+    }
+    if (start == goal) {
+        path.push_back(start);
+        return true;
+    }
+
+    SymmetryState nodeStart(start, this);
+    SymmetryState nodeEnd(goal, this);
+    search_->SetStartAndGoalStates(nodeStart, nodeEnd);
+    unsigned int searchState;
+    do {
+        searchState = search_->SearchStep();
+        lastExpansions_++;
+    } while (searchState == AStarSearch<SymmetryState>::SEARCH_STATE_SEARCHING);
+
+    if (searchState != AStarSearch<SymmetryState>::SEARCH_STATE_SUCCEEDED) {
+        if (searchState == AStarSearch<SymmetryState>::SEARCH_STATE_OUT_OF_MEMORY) {
+            PF_LOG_WARNING("Symmetry reduction search ran out of nodes after {} steps", lastExpansions_);
+        }
+        return false;
+    }
+
+    // Walk each edge back into cells: x first, then y, which stays inside the rectangle
+    // of an L-shaped edge
+    lastPathCost_ = search_->GetSolutionCost();
+    Position cell = search_->GetSolutionStart()->position;
+    path.push_back(cell);
+    for (SymmetryState* node = search_->GetSolutionNext(); node; node = search_->GetSolutionNext()) {
+        const Position& to = node->position;
+        while (cell.x != to.x) {
+            cell.x += to.x > cell.x ? 1 : -1;
+            path.push_back(cell);
+        }
+        while (cell.y != to.y) {
+            cell.y += to.y > cell.y ? 1 : -1;
+            path.push_back(cell);
+        }
+    }
+    search_->FreeSolutionNodes();
+    return true;
+}
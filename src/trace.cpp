@@ -0,0 +1,176 @@
+#include "pathfinding/trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // Events a single thread keeps before dropping new ones
+    const size_t kMaxEventsPerThread = 1 << 20;
+
+    struct TraceEvent {
+        const char* name;
+        std::int64_t startNs;
+        std::int64_t durationNs;
+    };
+
+    // Only its own thread writes to a buffer; the mutex is contended only while dumping
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        std::uint32_t threadId = 0;
+        std::string threadName;
+        size_t dropped = 0;
+    };
+
+    // Buffers outlive their threads so events of finished threads can still be dumped
+    struct TraceRegistry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::uint32_t nextThreadId = 1;
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    TraceRegistry& registry() {
+        static TraceRegistry instance;
+        return instance;
+    }
+
+    ThreadBuffer& threadBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+            auto created = std::make_shared<ThreadBuffer>();
+            TraceRegistry& traces = registry();
+            std::lock_guard<std::mutex> lock(traces.mutex);
+            created->threadId = traces.nextThreadId++;
+            traces.buffers.push_back(created);
+            return created;
+        }();
+        return *buffer;
+    }
+
+    // Quotes, backslashes and control characters are escaped
+    void writeJsonString(std::ostream& out, const std::string& text) {
+        out << '"';
+        for (char c : text) {
+            switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+            }
+        }
+        out << '"';
+    }
+}
+
+namespace trace_detail {
+    std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - registry().epoch).count();
+    }
+
+    void record(const char* name, std::int64_t startNs, std::int64_t endNs) {
+        ThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        if (buffer.events.size() >= kMaxEventsPerThread) {
+            buffer.dropped++;
+            return;
+        }
+        buffer.events.push_back({name, startNs, endNs - startNs});
+    }
+}
+
+void setTracingEnabled(bool enabled) {
+    trace_detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void setTraceThreadName(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+void writeChromeTrace(std::ostream& out) {
+    TraceRegistry& traces = registry();
+    std::lock_guard<std::mutex> registryLock(traces.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    for (const auto& buffer : traces.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        if (!buffer->threadName.empty()) {
+            out << (first ? "\n" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"args\":{\"name\":";
+            writeJsonString(out, buffer->threadName);
+            out << "}}";
+            first = false;
+        }
+
+        // Complete events, timestamps in microseconds
+        for (const TraceEvent& event : buffer->events) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.startNs / 1000 << '.' << (event.startNs % 1000) / 100
+                << ",\"dur\":" << event.durationNs / 1000 << '.' << (event.durationNs % 1000) / 100 << "}";
+            first = false;
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+bool writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    writeChromeTrace(file);
+    return static_cast<bool>(file);
+}
+
+void clearTrace() {
+    TraceRegistry& traces = registry();
+    std::lock_guard<std::mutex> registryLock(traces.mutex);
+    for (const auto& buffer : traces.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+}
+
+size_t getTraceEventCount() {
+    TraceRegistry& traces = registry();
+    std::lock_guard<std::mutex> registryLock(traces.mutex);
+    size_t count = 0;
+    for (const auto& buffer : traces.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+size_t getTraceDroppedCount() {
+    TraceRegistry& traces = registry();
+    std::lock_guard<std::mutex> registryLock(traces.mutex);
+    size_t count = 0;
+    for (const auto& buffer : traces.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        count += buffer->dropped;
+    }
+    return count;
+}
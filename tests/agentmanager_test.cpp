@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "pathfinding/agentmanager.h"
+#include "pathfinding/grid.h"
+#include <SFML/Graphics.hpp>
+
+namespace pathfinding::test {
+
+class AgentManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 5x5 grid for testing
+        grid = std::make_unique<Grid>(5, 5);
+        agents = std::make_unique<AgentManager>(2);
+    }
+
+    std::unique_ptr<Grid> grid;
+    std::unique_ptr<AgentManager> agents;
+};
+
+// Test adding agents stores position and color
+TEST_F(AgentManagerTest, AddAgentStoresState) {
+    AgentId first = agents->addAgent(Position{1, 1}, sf::Color::Red);
+    AgentId second = agents->addAgent(Position{3, 2}, sf::Color::Blue);
+
+    EXPECT_EQ(agents->size(), 2);
+    EXPECT_EQ(agents->getPosition(first), Position(1, 1));
+    EXPECT_EQ(agents->getPosition(second), Position(3, 2));
+    EXPECT_EQ(agents->getColor(first), sf::Color::Red);
+    EXPECT_EQ(agents->getColor(second), sf::Color::Blue);
+    EXPECT_FALSE(agents->hasPath(first));
+    EXPECT_EQ(agents->getSearchEngineCount(), 2);
+}
+
+// Test setters
+TEST_F(AgentManagerTest, PositionAndColorSetters) {
+    AgentId id = agents->addAgent(Position{0, 0});
+
+    agents->setPosition(id, Position{4, 3});
+    agents->setColor(id, sf::Color::Magenta);
+
+    EXPECT_EQ(agents->getPosition(id), Position(4, 3));
+    EXPECT_EQ(agents->getColor(id), sf::Color::Magenta);
+}
+
+// Test pathfinding excludes the current cell and agents reach their targets
+TEST_F(AgentManagerTest, FindPathAndFollow) {
+    AgentId a = agents->addAgent(Position{0, 0});
+    AgentId b = agents->addAgent(Position{4, 4});
+
+    ASSERT_TRUE(agents->findPathTo(a, *grid, Position{2, 0}));
+    ASSERT_TRUE(agents->findPathTo(b, *grid, Position{4, 1}));
+
+    EXPECT_EQ(agents->getRemainingPathLength(a), 2);
+    EXPECT_EQ(agents->getRemainingPathLength(b), 3);
+    EXPECT_EQ(agents->getPathStep(a, 0), Position(1, 0));
+
+    while (agents->hasPath(a) || agents->hasPath(b)) {
+        agents->followPaths();
+    }
+
+    EXPECT_EQ(agents->getPosition(a), Position(2, 0));
+    EXPECT_EQ(agents->getPosition(b), Position(4, 1));
+}
+
+// Test unreachable target leaves agent without a path
+TEST_F(AgentManagerTest, UnreachableTarget) {
+    AgentId id = agents->addAgent(Position{0, 0});
+    for (int x = 0; x < 5; ++x) {
+        grid->setCell(Position{x, 2}, CellType::Wall);
+    }
+
+    EXPECT_FALSE(agents->findPathTo(id, *grid, Position{4, 4}));
+    EXPECT_FALSE(agents->hasPath(id));
+    EXPECT_EQ(agents->getPosition(id), Position(0, 0));
+}
+
+// Test clearing a path stops the agent
+TEST_F(AgentManagerTest, ClearPath) {
+    AgentId id = agents->addAgent(Position{0, 0});
+    ASSERT_TRUE(agents->findPathTo(id, *grid, Position{3, 3}));
+
+    agents->followPaths();
+    agents->clearPath(id);
+    agents->followPaths();
+
+    EXPECT_FALSE(agents->hasPath(id));
+    EXPECT_EQ(agents->getRemainingPathLength(id), 0);
+}
+
+// Test the pooled path buffer is compacted instead of growing forever
+TEST_F(AgentManagerTest, PathPoolIsReclaimed) {
+    AgentId id = agents->addAgent(Position{0, 0});
+    std::vector<Position> steps = {{1, 0}, {2, 0}, {3, 0}};
+
+    for (int i = 0; i < 100; ++i) {
+        agents->setPath(id, steps);
+    }
+
+    EXPECT_LE(agents->getPathPoolSize(), steps.size() * 2);
+    EXPECT_EQ(agents->getRemainingPathLength(id), steps.size());
+    EXPECT_EQ(agents->getPathStep(id, 2), Position(3, 0));
+}
+
+// Test compaction keeps the untaken part of other agents' paths
+TEST_F(AgentManagerTest, CompactionPreservesLivePaths) {
+    AgentId walker = agents->addAgent(Position{0, 0});
+    AgentId other = agents->addAgent(Position{0, 4});
+
+    agents->setPath(walker, {{1, 0}, {2, 0}, {3, 0}, {4, 0}});
+    agents->followPaths();
+
+    // Repeatedly replacing the other agent's path triggers compaction
+    for (int i = 0; i < 10; ++i) {
+        agents->setPath(other, {{1, 4}, {2, 4}});
+    }
+
+    ASSERT_EQ(agents->getRemainingPathLength(walker), 3);
+    EXPECT_EQ(agents->getPathStep(walker, 0), Position(2, 0));
+    EXPECT_EQ(agents->getPathStep(walker, 2), Position(4, 0));
+}
+}
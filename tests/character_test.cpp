@@ -154,4 +154,68 @@ TEST_F(CharacterTest, PathFollowingBehavior) {
     EXPECT_EQ(character->getPosition(), target);
     EXPECT_FALSE(character->hasPath());
 }
+
+// Test deferred pathfinding through a scheduler
+TEST_F(CharacterTest, ScheduledPathRequest) {
+    PathRequestScheduler scheduler(100);
+    Position target{3, 3};
+
+    character->requestPathTo(scheduler, target);
+    EXPECT_TRUE(character->hasPendingRequest());
+    EXPECT_FALSE(character->receivePath(scheduler)); // Not served yet
+
+    scheduler.tick(*grid);
+    EXPECT_TRUE(character->receivePath(scheduler));
+    EXPECT_FALSE(character->hasPendingRequest());
+    EXPECT_EQ(character->getCurrentPath().size(), 4);
+
+    while (character->hasPath()) {
+        character->followPath();
+    }
+    EXPECT_EQ(character->getPosition(), target);
+}
+
+// Test a new request or the character's destruction cancels the pending one
+TEST_F(CharacterTest, ScheduledRequestReplaced) {
+    PathRequestScheduler scheduler(100);
+
+    character->requestPathTo(scheduler, Position{3, 3});
+    character->requestPathTo(scheduler, Position{4, 1});
+    EXPECT_EQ(scheduler.getRequestCount(), 1);
+    EXPECT_EQ(scheduler.getQueuedCount(), 1);
+
+    scheduler.tick(*grid);
+    EXPECT_TRUE(character->receivePath(scheduler));
+    EXPECT_EQ(character->getCurrentPath().size(), 3);
+
+    // Results nobody takes are dropped with the character
+    character->requestPathTo(scheduler, Position{3, 3});
+    scheduler.tick(*grid);
+    EXPECT_EQ(scheduler.getRequestCount(), 1);
+    character.reset();
+    EXPECT_EQ(scheduler.getRequestCount(), 0);
+}
+
+// Test smoothed paths keep only waypoints and are walked cell by cell
+TEST_F(CharacterTest, SmoothedPathFollowing) {
+    Grid open(20, 20);
+    open.setMovement(Connectivity::Eight);
+    character->setPosition(Position{0, 0});
+    character->setPathSmoothing(true);
+    
+    Position target{15, 6};
+    ASSERT_TRUE(character->findPathTo(open, target));
+    EXPECT_EQ(character->getCurrentPath().size(), 1);
+    
+    int steps = 0;
+    Position previous = character->getPosition();
+    while (character->hasPath()) {
+        character->followPath();
+        EXPECT_TRUE(open.canMove(previous, character->getPosition()));
+        previous = character->getPosition();
+        steps++;
+    }
+    EXPECT_EQ(character->getPosition(), target);
+    EXPECT_EQ(steps, 15);
+}
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "pathfinding/contractionhierarchy.h"
+#include "pathfinding/pathfinder.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class ContractionHierarchyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 20x20 grid with scattered walls and terrain
+        grid = makeScatteredGrid(20, 20, 3);
+    }
+
+    // Every sampled pair of walkable cells gets a valid path of the A* cost
+    void expectOptimal(ContractionHierarchy& hierarchy) {
+        Pathfinder plain(1000);
+        expectMatchesAStar(*grid, plain, 7, 3, [&](const Position& start, const Position& goal,
+                                                   std::vector<Position>& path, float& cost) {
+            bool found = hierarchy.findPath(*grid, start, goal, path);
+            cost = hierarchy.getLastPathCost();
+            return found;
+        });
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test queries cost the same as A* with 4-connected moves
+TEST_F(ContractionHierarchyTest, MatchesAStar) {
+    ContractionHierarchy hierarchy;
+    hierarchy.build(*grid, 1);
+    EXPECT_TRUE(hierarchy.isValidFor(*grid));
+    EXPECT_GT(hierarchy.getNodeCount(), 0u);
+    expectOptimal(hierarchy);
+}
+
+// Test queries cost the same as A* with 8-connected moves, contracted on several threads
+TEST_F(ContractionHierarchyTest, MatchesAStarEightConnected) {
+    grid->setMovement(Connectivity::Eight, CornerCutting::NoSqueeze);
+    ContractionHierarchy hierarchy;
+    hierarchy.build(*grid, 4);
+    EXPECT_GT(hierarchy.getShortcutCount(), 0u);
+    expectOptimal(hierarchy);
+}
+
+// Test long queries settle far fewer nodes than A*
+TEST_F(ContractionHierarchyTest, SettlesFewNodes) {
+    Position start(1, 0);
+    Position goal(18, 19);
+    grid->setCell(start, CellType::Empty);
+    grid->setCell(goal, CellType::Empty);
+    ContractionHierarchy hierarchy;
+    hierarchy.build(*grid);
+    Pathfinder plain(1000);
+    std::vector<Position> path;
+
+    ASSERT_TRUE(plain.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(hierarchy.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(hierarchy.getLastPathCost(), plain.getLastPathCost());
+    EXPECT_LT(hierarchy.getLastExpansions() * 2, static_cast<size_t>(plain.getLastSearchSteps()));
+}
+
+// Test unreachable goals, walls and start equal to goal
+TEST_F(ContractionHierarchyTest, TrivialAndUnreachable) {
+    Grid walled(8, 8);
+    for (int y = 0; y < 8; ++y) {
+        walled.setCell(Position{4, y}, CellType::Wall);
+    }
+
+    ContractionHierarchy hierarchy;
+    hierarchy.build(walled);
+    std::vector<Position> path;
+    ASSERT_TRUE(hierarchy.findPath(walled, Position(1, 1), Position(1, 1), path));
+    EXPECT_EQ(path.size(), 1u);
+    EXPECT_FALSE(hierarchy.findPath(walled, Position(1, 1), Position(6, 6), path));
+    EXPECT_TRUE(path.empty());
+    EXPECT_FALSE(hierarchy.findPath(walled, Position(1, 1), Position(4, 4), path));
+}
+
+// Test the pathfinder queries the hierarchy while it matches the grid
+TEST_F(ContractionHierarchyTest, PathfinderUsesHierarchy) {
+    Position start(1, 0);
+    Position goal(18, 19);
+    grid->setCell(start, CellType::Empty);
+    grid->setCell(goal, CellType::Empty);
+    ContractionHierarchy hierarchy;
+    hierarchy.build(*grid);
+    Pathfinder plain(1000);
+    Pathfinder pathfinder(1000);
+    pathfinder.setContractionHierarchy(&hierarchy);
+    std::vector<Position> path;
+
+    ASSERT_TRUE(plain.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), plain.getLastPathCost());
+    EXPECT_EQ(static_cast<size_t>(pathfinder.getLastSearchSteps()), hierarchy.getLastExpansions());
+
+    // Edits and new terrain costs make it stale
+    grid->setTerrainCost(CellType::Mud, 7.0f);
+    EXPECT_FALSE(hierarchy.isValidFor(*grid));
+    ASSERT_TRUE(plain.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), plain.getLastPathCost());
+}
+
+// Test a hierarchy built for another grid with the same revision is not used
+TEST_F(ContractionHierarchyTest, OtherGridIgnored) {
+    EqualRevisionGrids grids = makeEqualRevisionGrids(10);
+    ContractionHierarchy hierarchy;
+    hierarchy.build(grids.column);
+    EXPECT_FALSE(hierarchy.isValidFor(grids.row));
+
+    Pathfinder pathfinder(1000);
+    pathfinder.setContractionHierarchy(&hierarchy);
+    expectPlainCost(pathfinder, grids.row, Position(0, 0), Position(0, 9));
+}
+
+} // namespace pathfinding::test
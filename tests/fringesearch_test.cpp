@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "pathfinding/fringesearch.h"
+#include "pathfinding/pathfinder.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class FringeSearchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 30x30 grid with scattered walls and terrain
+        grid = makeScatteredGrid(30, 30, 7);
+        grid->setCell(start, CellType::Empty);
+        grid->setCell(goal, CellType::Empty);
+    }
+
+    std::unique_ptr<Grid> grid;
+    Position start{0, 0};
+    Position goal{29, 29};
+};
+
+// Test paths are optimal with both movement rules
+TEST_F(FringeSearchTest, MatchesAStar) {
+    Pathfinder pathfinder(2000);
+    FringeSearch fringe;
+    std::vector<Position> expected, path;
+    
+    for (Connectivity connectivity : {Connectivity::Four, Connectivity::Eight}) {
+        grid->setMovement(connectivity);
+        ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, expected));
+        ASSERT_TRUE(fringe.findPath(*grid, start, goal, path));
+        EXPECT_FLOAT_EQ(fringe.getLastPathCost(), pathfinder.getLastPathCost());
+        EXPECT_FLOAT_EQ(walkCost(*grid, path), fringe.getLastPathCost());
+        EXPECT_EQ(path.front(), start);
+        EXPECT_EQ(path.back(), goal);
+        EXPECT_FALSE(fringe.isLastOutOfMemory());
+    }
+}
+
+// Test memory follows the budget, not the map
+TEST_F(FringeSearchTest, MemoryBudget) {
+    FringeSearch fringe(64 * 1024);
+    size_t before = fringe.getMemoryBytes();
+    EXPECT_LE(before, 64u * 1024u);
+    
+    std::vector<Position> path;
+    ASSERT_TRUE(fringe.findPath(*grid, start, goal, path));
+    EXPECT_EQ(fringe.getMemoryBytes(), before);
+}
+
+// Test a full table fails the search as out of memory
+TEST_F(FringeSearchTest, OutOfMemory) {
+    FringeSearch fringe(1024);
+    std::vector<Position> path;
+    
+    EXPECT_FALSE(fringe.findPath(*grid, start, goal, path));
+    EXPECT_TRUE(fringe.isLastOutOfMemory());
+    EXPECT_TRUE(path.empty());
+    
+    // Short searches still fit
+    ASSERT_TRUE(fringe.findPath(*grid, start, start, path));
+    EXPECT_EQ(path.size(), 1);
+}
+
+// Test walled off goals fail without running out of memory
+TEST_F(FringeSearchTest, Unreachable) {
+    grid->setCell(Position{28, 29}, CellType::Wall);
+    grid->setCell(Position{29, 28}, CellType::Wall);
+    grid->setCell(Position{28, 28}, CellType::Wall);
+    
+    FringeSearch fringe;
+    std::vector<Position> path;
+    EXPECT_FALSE(fringe.findPath(*grid, start, goal, path));
+    EXPECT_FALSE(fringe.isLastOutOfMemory());
+}
+
+// Test Pathfinder can be switched to Fringe Search
+TEST_F(FringeSearchTest, PathfinderEngine) {
+    Pathfinder astar(2000);
+    Pathfinder pathfinder(2000);
+    pathfinder.setSearchAlgorithm(SearchAlgorithm::Fringe, 256 * 1024);
+    EXPECT_EQ(pathfinder.getSearchAlgorithm(), SearchAlgorithm::Fringe);
+    
+    std::vector<Position> expected, path;
+    ASSERT_TRUE(astar.findPath(*grid, start, goal, expected));
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), astar.getLastPathCost());
+    EXPECT_GT(pathfinder.getLastSearchSteps(), 0);
+    
+    pathfinder.setSearchAlgorithm(SearchAlgorithm::AStar);
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), astar.getLastPathCost());
+}
+}
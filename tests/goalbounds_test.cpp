@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "pathfinding/goalbounds.h"
+#include "pathfinding/pathfinder.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class GoalBoundsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 16x16 grid with scattered walls and terrain
+        grid = makeScatteredGrid(16, 16, 3);
+    }
+
+    // Sampled pairs of walkable cells get the same cost with and without pruning, and pruning
+    // never expands more nodes
+    void expectOptimal(const GoalBounds& bounds) {
+        Pathfinder plain(1000);
+        Pathfinder pruned(1000);
+        pruned.setGoalBounds(&bounds);
+        expectMatchesAStar(*grid, plain, 7, 5, [&](const Position& start, const Position& goal,
+                                                   std::vector<Position>& path, float& cost) {
+            bool found = pruned.findPath(*grid, start, goal, path);
+            cost = pruned.getLastPathCost();
+            EXPECT_LE(pruned.getLastSearchSteps(), plain.getLastSearchSteps());
+            return found;
+        });
+    }
+
+    // Both tables answer every query alike
+    void expectSameTables(const GoalBounds& a, const GoalBounds& b) {
+        Position neighbors[Grid::kMaxNeighbors];
+        for (int y = 0; y < 16; ++y) {
+            for (int x = 0; x < 16; ++x) {
+                Position pos(x, y);
+                int count = grid->getNeighbors(pos, neighbors);
+                for (int i = 0; i < count; ++i) {
+                    const GoalBounds::Box& boxA = a.getBox(pos, neighbors[i]);
+                    const GoalBounds::Box& boxB = b.getBox(pos, neighbors[i]);
+                    EXPECT_EQ(boxA.minX, boxB.minX);
+                    EXPECT_EQ(boxA.minY, boxB.minY);
+                    EXPECT_EQ(boxA.maxX, boxB.maxX);
+                    EXPECT_EQ(boxA.maxY, boxB.maxY);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test boxes cover what lies beyond each move
+TEST_F(GoalBoundsTest, CorridorBoxes) {
+    Grid corridor(10, 3);
+    for (int x = 0; x < 10; ++x) {
+        corridor.setCell(Position{x, 0}, CellType::Wall);
+        corridor.setCell(Position{x, 2}, CellType::Wall);
+    }
+    
+    GoalBounds bounds;
+    ASSERT_TRUE(bounds.build(corridor, 1));
+    EXPECT_TRUE(bounds.isValidFor(corridor));
+    EXPECT_TRUE(bounds.allows(Position{5, 1}, Position{6, 1}, Position{9, 1}));
+    EXPECT_FALSE(bounds.allows(Position{5, 1}, Position{6, 1}, Position{2, 1}));
+    EXPECT_TRUE(bounds.allows(Position{5, 1}, Position{4, 1}, Position{0, 1}));
+    
+    const GoalBounds::Box& east = bounds.getBox(Position{5, 1}, Position{6, 1});
+    EXPECT_EQ(east.minX, 6);
+    EXPECT_EQ(east.maxX, 9);
+    EXPECT_EQ(east.minY, 1);
+    EXPECT_EQ(east.maxY, 1);
+}
+
+// Test pruned searches stay optimal with both movement rules
+TEST_F(GoalBoundsTest, PrunedSearchOptimal) {
+    GoalBounds bounds;
+    ASSERT_TRUE(bounds.build(*grid));
+    expectOptimal(bounds);
+    
+    grid->setMovement(Connectivity::Eight);
+    EXPECT_FALSE(bounds.isValidFor(*grid));
+    ASSERT_TRUE(bounds.build(*grid));
+    expectOptimal(bounds);
+}
+
+// Test the thread count does not change the tables
+TEST_F(GoalBoundsTest, ThreadsAgree) {
+    GoalBounds single, multi;
+    ASSERT_TRUE(single.build(*grid, 1));
+    ASSERT_TRUE(multi.build(*grid, 4));
+    expectSameTables(single, multi);
+    EXPECT_EQ(single.getMemoryBytes(), 16u * 16u * Grid::kMaxNeighbors * sizeof(GoalBounds::Box));
+}
+
+// Test rebuilding a region matches building from scratch
+TEST_F(GoalBoundsTest, RebuildRegion) {
+    // Split the map with a wall so the left part is unaffected by edits on the right
+    for (int y = 0; y < 16; ++y) {
+        grid->setCell(Position{7, y}, CellType::Wall);
+    }
+    GoalBounds bounds;
+    ASSERT_TRUE(bounds.build(*grid));
+    
+    grid->setCell(Position{12, 5}, CellType::Wall);
+    grid->setCell(Position{13, 6}, CellType::Empty);
+    EXPECT_FALSE(bounds.isValidFor(*grid));
+    
+    size_t rebuilt = bounds.rebuild(*grid, Position{12, 5}, Position{13, 6});
+    EXPECT_TRUE(bounds.isValidFor(*grid));
+    EXPECT_GT(rebuilt, 0u);
+    EXPECT_LT(rebuilt, 16u * 16u / 2);
+    
+    GoalBounds fresh;
+    ASSERT_TRUE(fresh.build(*grid));
+    expectSameTables(bounds, fresh);
+}
+
+// Test stale tables are not used for pruning
+TEST_F(GoalBoundsTest, StaleTablesIgnored) {
+    GoalBounds bounds;
+    ASSERT_TRUE(bounds.build(*grid));
+    
+    // Open a shortcut the tables know nothing about
+    for (int x = 0; x < 16; ++x) {
+        grid->setCell(Position{x, 8}, CellType::Road);
+    }
+    
+    Pathfinder plain(1000);
+    Pathfinder pruned(1000);
+    pruned.setGoalBounds(&bounds);
+    std::vector<Position> path;
+    ASSERT_TRUE(plain.findPath(*grid, Position{0, 8}, Position{15, 8}, path));
+    ASSERT_TRUE(pruned.findPath(*grid, Position{0, 8}, Position{15, 8}, path));
+    EXPECT_FLOAT_EQ(pruned.getLastPathCost(), 7.5f);
+    EXPECT_EQ(pruned.getLastSearchSteps(), plain.getLastSearchSteps());
+}
+
+// Test tables built for another grid with the same revision are not used
+TEST_F(GoalBoundsTest, OtherGridIgnored) {
+    EqualRevisionGrids grids = makeEqualRevisionGrids(16);
+    GoalBounds bounds;
+    ASSERT_TRUE(bounds.build(grids.column));
+    EXPECT_FALSE(bounds.isValidFor(grids.row));
+    
+    Pathfinder pruned(1000);
+    pruned.setGoalBounds(&bounds);
+    expectPlainCost(pruned, grids.row, Position{0, 0}, Position{0, 15});
+}
+}
@@ -226,4 +226,262 @@ TEST_F(GridTest, IsInBoundsWorksCorrectly) {
         << "Far out of bounds should be out of bounds";
 }
 
+// Test revision only moves when a cell actually changes
+TEST_F(GridTest, RevisionTracksChanges) {
+    std::uint64_t initial = grid->getRevision();
+    
+    grid->setCell({1, 1}, CellType::Wall);
+    EXPECT_EQ(grid->getRevision(), initial + 1);
+    
+    // Same value again - no change
+    grid->setCell({1, 1}, CellType::Wall);
+    EXPECT_EQ(grid->getRevision(), initial + 1);
+    
+    // Out of bounds - no change
+    grid->setCell({-1, 1}, CellType::Wall);
+    EXPECT_EQ(grid->getRevision(), initial + 1);
+    
+    grid->setCell({1, 1}, CellType::Empty);
+    EXPECT_EQ(grid->getRevision(), initial + 2);
+}
+
+// Test the cell hash tells apart grids with equal revisions and follows reverted edits
+TEST_F(GridTest, CellHashTracksCells) {
+    Grid other(5, 5);
+    EXPECT_EQ(grid->getCellHash(), other.getCellHash());
+    
+    grid->setCell({1, 2}, CellType::Wall);
+    other.setCell({2, 1}, CellType::Wall);
+    EXPECT_EQ(grid->getRevision(), other.getRevision());
+    EXPECT_NE(grid->getCellHash(), other.getCellHash());
+    
+    Grid snapshot = *grid;
+    EXPECT_EQ(snapshot.getCellHash(), grid->getCellHash());
+    
+    grid->setCell({1, 2}, CellType::Mud);
+    EXPECT_NE(grid->getCellHash(), snapshot.getCellHash());
+    grid->setCell({1, 2}, CellType::Wall);
+    EXPECT_EQ(grid->getCellHash(), snapshot.getCellHash());
+}
+
+// Test dirty blocks are tracked per 32x32 region
+TEST_F(GridTest, DirtyBlocksTrackEdits) {
+    Grid large(100, 70); // 4x3 blocks
+    EXPECT_EQ(large.getBlocksX(), 4);
+    EXPECT_EQ(large.getBlocksY(), 3);
+    EXPECT_TRUE(large.getDirtyBlocks().empty());
+    
+    large.setCell(5, 5, CellType::Wall);
+    large.setCell(99, 69, CellType::Wall);
+    
+    EXPECT_TRUE(large.isBlockDirty(0, 0));
+    EXPECT_TRUE(large.isBlockDirty(3, 2));
+    EXPECT_FALSE(large.isBlockDirty(1, 0));
+    EXPECT_EQ(large.getDirtyBlocks().size(), 2);
+    
+    large.clearDirtyBlocks();
+    EXPECT_FALSE(large.isBlockDirty(0, 0));
+    EXPECT_TRUE(large.getDirtyBlocks().empty());
+}
+
+// Test subscribers receive batched changes on flush
+TEST_F(GridTest, SubscribersReceiveBatches) {
+    std::vector<GridChangeBatch> received;
+    GridSubscriptionId id = grid->subscribe([&received](const GridChangeBatch& batch) {
+        received.push_back(batch);
+    });
+    
+    std::uint64_t before = grid->getRevision();
+    grid->setCell({1, 1}, CellType::Wall);
+    grid->setCell({2, 1}, CellType::Wall);
+    grid->setCell({1, 1}, CellType::Empty); // Restores the cell, so it is not a change
+    EXPECT_TRUE(grid->hasPendingChanges());
+    EXPECT_TRUE(received.empty()); // Nothing delivered before flushing
+    
+    grid->flushChanges();
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_FALSE(grid->hasPendingChanges());
+    
+    const GridChangeBatch& batch = received[0];
+    EXPECT_EQ(batch.fromRevision, before);
+    EXPECT_EQ(batch.toRevision, before + 3);
+    ASSERT_EQ(batch.changes.size(), 1);
+    EXPECT_EQ(batch.changes[0].position, Position(2, 1));
+    EXPECT_EQ(batch.changes[0].oldType, CellType::Empty);
+    EXPECT_EQ(batch.changes[0].newType, CellType::Wall);
+    ASSERT_EQ(batch.blocks.size(), 1);
+    EXPECT_EQ(batch.blocks[0], Position(0, 0));
+    
+    // Flushing without changes does not notify
+    grid->flushChanges();
+    EXPECT_EQ(received.size(), 1);
+    
+    // A batch of restored cells still carries the revisions
+    grid->setCell({3, 3}, CellType::Mud);
+    grid->setCell({3, 3}, CellType::Empty);
+    grid->flushChanges();
+    ASSERT_EQ(received.size(), 2);
+    EXPECT_EQ(received[1].fromRevision, before + 3);
+    EXPECT_EQ(received[1].toRevision, before + 5);
+    EXPECT_TRUE(received[1].changes.empty());
+    EXPECT_TRUE(received[1].blocks.empty());
+    
+    // Unsubscribed listeners are not notified
+    grid->unsubscribe(id);
+    grid->setCell({3, 3}, CellType::Wall);
+    grid->flushChanges();
+    EXPECT_EQ(received.size(), 2);
+}
+
+// Test snapshots keep the contents they were taken with
+TEST_F(GridTest, SnapshotIsImmutable) {
+    grid->setCell({1, 1}, CellType::Wall);
+    Grid snapshot = grid->snapshot();
+    
+    grid->setCell({1, 1}, CellType::Empty);
+    grid->setCell({3, 3}, CellType::Wall);
+    
+    EXPECT_EQ(snapshot.getCell({1, 1}), CellType::Wall);
+    EXPECT_EQ(snapshot.getCell({3, 3}), CellType::Empty);
+    EXPECT_EQ(grid->getCell({1, 1}), CellType::Empty);
+    EXPECT_EQ(grid->getCell({3, 3}), CellType::Wall);
+    EXPECT_LT(snapshot.getRevision(), grid->getRevision());
+}
+
+// Test only edited blocks stop being shared
+TEST_F(GridTest, SnapshotCopiesOnWritePerBlock) {
+    Grid large(64, 64); // 2x2 blocks
+    Grid snapshot = large.snapshot();
+    
+    EXPECT_TRUE(large.sharesBlockWith(snapshot, 0, 0));
+    EXPECT_TRUE(large.sharesBlockWith(snapshot, 1, 1));
+    
+    large.setCell(40, 40, CellType::Wall);
+    
+    EXPECT_TRUE(large.sharesBlockWith(snapshot, 0, 0));
+    EXPECT_FALSE(large.sharesBlockWith(snapshot, 1, 1));
+    EXPECT_EQ(snapshot.getCell(40, 40), CellType::Empty);
+    
+    // Further edits of an unshared block stay in place
+    large.setCell(41, 40, CellType::Wall);
+    EXPECT_EQ(snapshot.getCell(41, 40), CellType::Empty);
+    EXPECT_EQ(large.getCell(41, 40), CellType::Wall);
+}
+
+// Test snapshots do not carry subscribers
+TEST_F(GridTest, SnapshotHasNoSubscribers) {
+    int notifications = 0;
+    grid->subscribe([&notifications](const GridChangeBatch&) { notifications++; });
+    
+    Grid snapshot = grid->snapshot();
+    snapshot.setCell({2, 2}, CellType::Wall);
+    snapshot.flushChanges();
+    EXPECT_EQ(notifications, 0);
+    
+    grid->setCell({2, 2}, CellType::Wall);
+    grid->flushChanges();
+    EXPECT_EQ(notifications, 1);
+}
+
+// Test terrain types are walkable and priced by the cost table
+TEST_F(GridTest, TerrainCosts) {
+    EXPECT_FLOAT_EQ(grid->getTerrainCost(CellType::Empty), 1.0f);
+    EXPECT_TRUE(grid->hasUniformCosts());
+    EXPECT_FLOAT_EQ(grid->getMinMoveCost(), 1.0f);
+    
+    grid->setCell({1, 1}, CellType::Mud);
+    grid->setCell({2, 2}, CellType::Road);
+    EXPECT_TRUE(grid->isWalkable(1, 1));
+    EXPECT_TRUE(grid->isWalkable(2, 2));
+    EXPECT_FLOAT_EQ(grid->getMoveCost({1, 1}), grid->getTerrainCost(CellType::Mud));
+    EXPECT_FALSE(grid->hasUniformCosts());
+    EXPECT_FLOAT_EQ(grid->getMinMoveCost(), grid->getTerrainCost(CellType::Road));
+    EXPECT_EQ(grid->getCellCount(CellType::Empty), 23);
+    
+    // Only terrain present on the grid counts
+    grid->setCell({2, 2}, CellType::Wall);
+    EXPECT_FLOAT_EQ(grid->getMinMoveCost(), 1.0f);
+    grid->setCell({1, 1}, CellType::Empty);
+    EXPECT_TRUE(grid->hasUniformCosts());
+    EXPECT_EQ(grid->getCellCount(CellType::Mud), 0);
+}
+
+// Test replacing the only cell of one terrain with another keeps the counts and costs
+TEST_F(GridTest, TerrainReplacedByTerrain) {
+    grid->setCell({1, 1}, CellType::Mud);
+    grid->setCell({1, 1}, CellType::Water);
+    EXPECT_EQ(grid->getCellCount(CellType::Mud), 0);
+    EXPECT_EQ(grid->getCellCount(CellType::Water), 1);
+    EXPECT_FALSE(grid->hasUniformCosts());
+    EXPECT_FLOAT_EQ(grid->getMinMoveCost(), 1.0f);
+    
+    grid->setCell({1, 1}, CellType::Road);
+    EXPECT_EQ(grid->getCellCount(CellType::Road), 1);
+    EXPECT_FLOAT_EQ(grid->getMinMoveCost(), grid->getTerrainCost(CellType::Road));
+    
+    grid->setCell({1, 1}, CellType::Empty);
+    EXPECT_EQ(grid->getCellCount(CellType::Road), 0);
+    EXPECT_EQ(grid->getCellCount(CellType::Empty), 25);
+    EXPECT_TRUE(grid->hasUniformCosts());
+}
+
+// Test cost changes are validated, bump the revision and reach snapshots
+TEST_F(GridTest, SetTerrainCost) {
+    EXPECT_FALSE(grid->setTerrainCost(CellType::Wall, 1.0f));
+    EXPECT_FALSE(grid->setTerrainCost(CellType::Mud, 0.0f));
+    EXPECT_FALSE(grid->setTerrainCost(CellType::Mud, -2.0f));
+    
+    int notifications = 0;
+    grid->subscribe([&notifications](const GridChangeBatch&) { notifications++; });
+    grid->setCell({0, 0}, CellType::Water);
+    std::uint64_t revision = grid->getRevision();
+    
+    // Pending edits are delivered before the cost changes
+    EXPECT_TRUE(grid->setTerrainCost(CellType::Water, 8.0f));
+    EXPECT_EQ(notifications, 1);
+    EXPECT_EQ(grid->getRevision(), revision + 1);
+    EXPECT_FLOAT_EQ(grid->getMoveCost({0, 0}), 8.0f);
+    EXPECT_TRUE(grid->setTerrainCost(CellType::Water, 8.0f));
+    EXPECT_EQ(grid->getRevision(), revision + 1);
+    
+    Grid snapshot = grid->snapshot();
+    EXPECT_FLOAT_EQ(snapshot.getTerrainCost(CellType::Water), 8.0f);
+    EXPECT_EQ(snapshot.getCellCount(CellType::Water), 1);
+    EXPECT_FALSE(snapshot.hasUniformCosts());
+}
+
+// Test diagonal neighbors under each corner-cutting rule
+TEST_F(GridTest, GetNeighborsEightConnected) {
+    Position center{2, 2};
+    Position neighbors[Grid::kMaxNeighbors];
+    
+    std::uint64_t revision = grid->getRevision();
+    grid->setMovement(Connectivity::Eight);
+    EXPECT_EQ(grid->getRevision(), revision + 1);
+    EXPECT_EQ(grid->getNeighbors(center, neighbors), 8);
+    
+    // Walls west and north of the center
+    grid->setCell({1, 2}, CellType::Wall);
+    grid->setCell({2, 1}, CellType::Wall);
+    
+    // Only the southeast diagonal has both sides open
+    EXPECT_EQ(grid->getNeighbors(center, neighbors), 3);
+    EXPECT_EQ(neighbors[2], Position(3, 3));
+    
+    // Northwest squeezes between the two walls
+    grid->setMovement(Connectivity::Eight, CornerCutting::NoSqueeze);
+    EXPECT_EQ(grid->getNeighbors(center, neighbors), 5);
+    
+    grid->setMovement(Connectivity::Eight, CornerCutting::Allow);
+    EXPECT_EQ(grid->getNeighbors(center, neighbors), 6);
+    EXPECT_EQ(grid->getNeighbors(center).size(), 6);
+    
+    // Diagonal moves cost more
+    EXPECT_FLOAT_EQ(grid->getStepCost(center, {3, 3}), Grid::kDiagonalCost);
+    EXPECT_FLOAT_EQ(grid->getStepCost(center, {3, 2}), 1.0f);
+    
+    grid->setMovement(Connectivity::Four);
+    EXPECT_EQ(grid->getNeighbors(center, neighbors), 2);
+}
+
 } 
\ No newline at end of file
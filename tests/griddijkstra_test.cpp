@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "pathfinding/griddijkstra.h"
+#include "pathfinding/pathfinder.h"
+#include <cmath>
+
+namespace pathfinding::test {
+
+class GridDijkstraTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 10x10 grid for testing
+        grid = std::make_unique<Grid>(10, 10);
+        dijkstra = std::make_unique<GridDijkstra>();
+    }
+
+    std::unique_ptr<Grid> grid;
+    std::unique_ptr<GridDijkstra> dijkstra;
+};
+
+// Test distances on an open grid are Manhattan distances
+TEST_F(GridDijkstraTest, OpenGridDistances) {
+    std::vector<Position> targets = {{0, 0}, {3, 4}, {9, 9}};
+    std::vector<float> distances;
+    
+    EXPECT_EQ(dijkstra->distancesTo(*grid, Position{0, 0}, targets, distances), 3);
+    ASSERT_EQ(distances.size(), 3);
+    EXPECT_FLOAT_EQ(distances[0], 0.0f);
+    EXPECT_FLOAT_EQ(distances[1], 7.0f);
+    EXPECT_FLOAT_EQ(distances[2], 18.0f);
+}
+
+// Test unreachable and invalid targets get infinity
+TEST_F(GridDijkstraTest, UnreachableTargets) {
+    for (int y = 0; y < 10; ++y) {
+        grid->setCell(Position{5, y}, CellType::Wall);
+    }
+    
+    std::vector<Position> targets = {{4, 9}, {6, 0}, {5, 5}, {-1, 3}};
+    std::vector<float> distances;
+    
+    EXPECT_EQ(dijkstra->distancesTo(*grid, Position{0, 0}, targets, distances), 1);
+    EXPECT_FLOAT_EQ(distances[0], 13.0f);
+    EXPECT_TRUE(std::isinf(distances[1]));
+    EXPECT_TRUE(std::isinf(distances[2]));
+    EXPECT_TRUE(std::isinf(distances[3]));
+}
+
+// Test the search stops once the nearby targets are settled
+TEST_F(GridDijkstraTest, StopsAtLastTarget) {
+    std::vector<float> distances;
+    dijkstra->distancesTo(*grid, Position{0, 0}, {{1, 0}, {0, 1}}, distances);
+    EXPECT_LT(dijkstra->getLastExpansions(), 10);
+    
+    // Cells left behind by the previous search are not reported
+    dijkstra->expandFrom(*grid, Position{9, 9}, 2.0f);
+    EXPECT_EQ(dijkstra->getLastExpansions(), 6);
+    EXPECT_FLOAT_EQ(dijkstra->getDistance(Position{8, 8}), 2.0f);
+    EXPECT_TRUE(std::isinf(dijkstra->getDistance(Position{0, 0})));
+}
+
+// Test distances match A* path costs
+TEST_F(GridDijkstraTest, MatchesPathfinder) {
+    grid->addTestObstacles();
+    Pathfinder pathfinder;
+    
+    std::vector<Position> targets;
+    for (int y = 0; y < 10; y += 3) {
+        for (int x = 0; x < 10; x += 3) {
+            targets.push_back(Position{x, y});
+        }
+    }
+    std::vector<float> distances;
+    dijkstra->distancesTo(*grid, Position{1, 1}, targets, distances);
+    
+    for (size_t i = 0; i < targets.size(); ++i) {
+        std::vector<Position> path;
+        if (pathfinder.findPath(*grid, Position{1, 1}, targets[i], path)) {
+            EXPECT_FLOAT_EQ(distances[i], pathfinder.getLastPathCost());
+        } else {
+            EXPECT_TRUE(std::isinf(distances[i]));
+        }
+    }
+}
+
+// Test both searches agree on terrain costs
+TEST_F(GridDijkstraTest, TerrainMatchesPathfinder) {
+    for (int i = 0; i < 10; ++i) {
+        grid->setCell({i, 4}, CellType::Mud);
+        grid->setCell({4, i}, CellType::Road);
+        grid->setCell({i, 7}, CellType::Water);
+    }
+    grid->setCell({6, 7}, CellType::Wall);
+    Pathfinder pathfinder;
+    
+    std::vector<Position> targets;
+    for (int y = 0; y < 10; y += 3) {
+        for (int x = 0; x < 10; x += 3) {
+            targets.push_back(Position{x, y});
+        }
+    }
+    std::vector<float> distances;
+    EXPECT_EQ(dijkstra->distancesTo(*grid, Position{0, 0}, targets, distances), targets.size());
+    
+    for (size_t i = 0; i < targets.size(); ++i) {
+        std::vector<Position> path;
+        ASSERT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, targets[i], path));
+        EXPECT_FLOAT_EQ(distances[i], pathfinder.getLastPathCost());
+    }
+}
+
+// Test both searches agree on 8-connected grids
+TEST_F(GridDijkstraTest, EightConnectedMatchesPathfinder) {
+    grid->addTestObstacles();
+    grid->setCell({5, 5}, CellType::Mud);
+    grid->setMovement(Connectivity::Eight);
+    Pathfinder pathfinder;
+    
+    std::vector<Position> targets;
+    for (int y = 0; y < 10; y += 3) {
+        for (int x = 0; x < 10; x += 3) {
+            targets.push_back(Position{x, y});
+        }
+    }
+    std::vector<float> distances;
+    dijkstra->distancesTo(*grid, Position{1, 1}, targets, distances);
+    
+    for (size_t i = 0; i < targets.size(); ++i) {
+        std::vector<Position> path;
+        if (pathfinder.findPath(*grid, Position{1, 1}, targets[i], path)) {
+            EXPECT_FLOAT_EQ(distances[i], pathfinder.getLastPathCost());
+        } else {
+            EXPECT_TRUE(std::isinf(distances[i]));
+        }
+    }
+}
+
+}
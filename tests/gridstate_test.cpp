@@ -200,4 +200,53 @@ TEST_F(GridStateTest, HashFunctionValues) {
     
     EXPECT_EQ(actualHash, expectedHash);
 }
+
+// Test a goal state carrying a GoalSet accepts any of its goals
+TEST_F(GridStateTest, GoalSetGoals) {
+    GoalSet goals(std::vector<Position>{{0, 4}, {4, 0}, {4, 0}});
+    EXPECT_EQ(goals.size(), 2);
+    
+    GridState goal(Position{0, 4}, grid.get());
+    goal.goals = &goals;
+    
+    GridState atSecond(Position{4, 0}, grid.get());
+    GridState elsewhere(Position{1, 1}, grid.get());
+    EXPECT_TRUE(atSecond.IsGoal(goal));
+    EXPECT_FALSE(elsewhere.IsGoal(goal));
+    
+    // Heuristic is the distance to the nearest goal
+    EXPECT_FLOAT_EQ(elsewhere.GoalDistanceEstimate(goal), 4.0f);
+    EXPECT_FLOAT_EQ(atSecond.GoalDistanceEstimate(goal), 0.0f);
+}
+
+// Test large goal sets fall back to the bounding box bound
+TEST_F(GridStateTest, GoalSetBoundingBox) {
+    GoalSet goals;
+    for (int i = 0; i <= static_cast<int>(GoalSet::kMaxExactGoals); ++i) {
+        goals.add(Position{10 + i, 20 + (i % 2) * 5});
+    }
+    
+    // Below the box, the middle of it
+    EXPECT_FLOAT_EQ(goals.estimate(Position{12, 22}), 0.0f);
+    EXPECT_FLOAT_EQ(goals.estimate(Position{0, 0}), 30.0f);
+    EXPECT_TRUE(goals.contains(Position{11, 25}));
+    EXPECT_FALSE(goals.contains(Position{11, 20}));
+}
+
+// Test the octile heuristic and diagonal step costs
+TEST_F(GridStateTest, EightConnected) {
+    grid->setMovement(Connectivity::Eight);
+    GridState start(Position{0, 0}, grid.get());
+    GridState goal(Position{3, 1}, grid.get());
+    GridState diagonal(Position{1, 1}, grid.get());
+    
+    EXPECT_FLOAT_EQ(GridState::estimate(Position{0, 0}, Position{3, 1}, Connectivity::Eight),
+                    2.0f + Grid::kDiagonalCost);
+    EXPECT_FLOAT_EQ(start.GoalDistanceEstimate(goal), 2.0f + Grid::kDiagonalCost);
+    EXPECT_FLOAT_EQ(start.GetCost(diagonal), Grid::kDiagonalCost);
+    
+    // The fixed point cost stays close to sqrt(2)
+    EXPECT_NEAR(Grid::kDiagonalCost, std::sqrt(2.0f), 1e-3f);
+}
+
 } 
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "pathfinding/idastar.h"
+#include "pathfinding/pathfinder.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class IDAStarTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 20x20 grid with scattered walls and terrain
+        grid = makeScatteredGrid(20, 20, 5);
+        grid->setCell(start, CellType::Empty);
+        grid->setCell(goal, CellType::Empty);
+    }
+
+    std::unique_ptr<Grid> grid;
+    Position start{0, 0};
+    Position goal{19, 19};
+};
+
+// Test paths are optimal with both movement rules
+TEST_F(IDAStarTest, MatchesAStar) {
+    Pathfinder pathfinder(2000);
+    IDAStarSearch idastar;
+    std::vector<Position> expected, path;
+    
+    for (Connectivity connectivity : {Connectivity::Four, Connectivity::Eight}) {
+        grid->setMovement(connectivity);
+        ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, expected));
+        ASSERT_TRUE(idastar.findPath(*grid, start, goal, path));
+        EXPECT_FLOAT_EQ(idastar.getLastPathCost(), pathfinder.getLastPathCost());
+        EXPECT_FLOAT_EQ(walkCost(*grid, path), idastar.getLastPathCost());
+        EXPECT_EQ(path.front(), start);
+        EXPECT_EQ(path.back(), goal);
+        EXPECT_GT(idastar.getLastIterations(), 1);
+    }
+}
+
+// Test a tiny transposition table only costs time, not optimality
+TEST_F(IDAStarTest, SmallTable) {
+    Pathfinder pathfinder(2000);
+    IDAStarSearch large;
+    IDAStarSearch small(2048);
+    EXPECT_LE(small.getMemoryBytes(), 2048u);
+    
+    std::vector<Position> path;
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(large.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(small.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(small.getLastPathCost(), pathfinder.getLastPathCost());
+    EXPECT_GE(small.getLastExpansions(), large.getLastExpansions());
+}
+
+// Test the expansion cap fails the search as out of memory
+TEST_F(IDAStarTest, ExpansionLimit) {
+    IDAStarSearch idastar;
+    idastar.setMaxExpansions(10);
+    std::vector<Position> path;
+    
+    EXPECT_FALSE(idastar.findPath(*grid, start, goal, path));
+    EXPECT_TRUE(idastar.isLastOutOfMemory());
+    EXPECT_TRUE(path.empty());
+}
+
+// Test walled off goals fail once every reachable cell was searched
+TEST_F(IDAStarTest, Unreachable) {
+    grid->setCell(Position{18, 19}, CellType::Wall);
+    grid->setCell(Position{19, 18}, CellType::Wall);
+    grid->setCell(Position{18, 18}, CellType::Wall);
+    
+    IDAStarSearch idastar;
+    std::vector<Position> path;
+    EXPECT_FALSE(idastar.findPath(*grid, start, goal, path));
+    EXPECT_FALSE(idastar.isLastOutOfMemory());
+}
+
+// Test Pathfinder can be switched to IDA*
+TEST_F(IDAStarTest, PathfinderEngine) {
+    Pathfinder astar(2000);
+    Pathfinder pathfinder(2000);
+    pathfinder.setSearchAlgorithm(SearchAlgorithm::IDAStar, 64 * 1024);
+    EXPECT_EQ(pathfinder.getSearchAlgorithm(), SearchAlgorithm::IDAStar);
+    
+    std::vector<Position> expected, path;
+    ASSERT_TRUE(astar.findPath(*grid, start, goal, expected));
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), astar.getLastPathCost());
+}
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "pathfinding/log.h"
+#include "pathfinding/pathfinder.h"
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace pathfinding::test {
+
+class LogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sink = std::make_unique<RingBufferLogSink>(64);
+        setLogSink(sink.get());
+        setLogLevel(LogLevel::Info);
+    }
+
+    void TearDown() override {
+        setLogSink(nullptr);
+        setLogLevel(LogLevel::Info);
+    }
+
+    // Messages below PATHFINDING_LOG_MIN_LEVEL are removed at compile time
+    static bool compiledOut(LogLevel level) {
+        return static_cast<int>(level) < PATHFINDING_LOG_MIN_LEVEL;
+    }
+
+    std::unique_ptr<RingBufferLogSink> sink;
+};
+
+// Test records are formatted when drained
+TEST_F(LogTest, FormatsOnDrain) {
+    if (compiledOut(LogLevel::Info)) {
+        GTEST_SKIP() << "Info messages are compiled out";
+    }
+    PF_LOG_INFO("Path from ({}, {}) costs {}", 3, 4, 2.5f);
+    PF_LOG_ERROR("No arguments");
+
+    std::ostringstream out;
+    EXPECT_EQ(sink->drain(out), 2);
+    EXPECT_EQ(out.str(), "[info] Path from (3, 4) costs 2.5\n[error] No arguments\n");
+    EXPECT_EQ(sink->drain(out), 0);
+}
+
+// Test the runtime level filters messages
+TEST_F(LogTest, LevelFilter) {
+    if (compiledOut(LogLevel::Debug)) {
+        GTEST_SKIP() << "Debug messages are compiled out";
+    }
+    PF_LOG_DEBUG("Hidden");
+    EXPECT_FALSE(logEnabled(LogLevel::Debug));
+
+    setLogLevel(LogLevel::Debug);
+    PF_LOG_DEBUG("Shown");
+
+    std::ostringstream out;
+    EXPECT_EQ(sink->drain(out), 1);
+    EXPECT_EQ(out.str(), "[debug] Shown\n");
+}
+
+// Test arguments are not evaluated for disabled messages
+TEST_F(LogTest, DisabledMessagesSkipArguments) {
+    int evaluations = 0;
+    auto count = [&evaluations]() { return ++evaluations; };
+
+    PF_LOG_TRACE("Value {}", count());
+    setLogSink(nullptr);
+    PF_LOG_ERROR("Value {}", count());
+
+    EXPECT_EQ(evaluations, 0);
+}
+
+// Test a full buffer drops and counts new messages
+TEST_F(LogTest, FullBufferDrops) {
+    if (compiledOut(LogLevel::Info)) {
+        GTEST_SKIP() << "Info messages are compiled out";
+    }
+    for (size_t i = 0; i < sink->getCapacity() + 10; ++i) {
+        PF_LOG_INFO("Message {}", i);
+    }
+    EXPECT_EQ(sink->getDroppedCount(), 10);
+
+    LogRecord first;
+    ASSERT_TRUE(sink->pop(first));
+    EXPECT_EQ(first.args[0], 0.0);
+}
+
+// Test concurrent producers lose nothing while there is room
+TEST_F(LogTest, ConcurrentProducers) {
+    if (compiledOut(LogLevel::Info)) {
+        GTEST_SKIP() << "Info messages are compiled out";
+    }
+    RingBufferLogSink big(8192);
+    setLogSink(&big);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 1000; ++i) {
+                PF_LOG_INFO("Thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::ostringstream out;
+    EXPECT_EQ(big.drain(out), 4000);
+    EXPECT_EQ(big.getDroppedCount(), 0);
+}
+
+// Test Pathfinder is silent by default and logs through the sink when asked
+TEST_F(LogTest, PathfinderMessages) {
+    if (compiledOut(LogLevel::Warning)) {
+        GTEST_SKIP() << "Warning messages are compiled out";
+    }
+    Grid grid(5, 5);
+    Pathfinder pathfinder;
+    std::vector<Position> path;
+
+    grid.setCell(Position{4, 4}, CellType::Wall);
+    EXPECT_FALSE(pathfinder.findPath(grid, Position{0, 0}, Position{4, 4}, path));
+    EXPECT_TRUE(pathfinder.findPath(grid, Position{0, 0}, Position{2, 0}, path));
+
+    std::ostringstream out;
+    EXPECT_EQ(sink->drain(out), 1);
+    EXPECT_EQ(out.str(), "[warning] Goal position (4, 4) is not valid or walkable\n");
+}
+}
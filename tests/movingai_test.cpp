@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "pathfinding/movingai.h"
+#include "pathfinding/pathfinder.h"
+#include <sstream>
+
+namespace pathfinding::test {
+
+class MovingAITest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Placeholder grid, replaced by the loaders
+        grid = std::make_unique<Grid>(1, 1);
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test a map is loaded with the right dimensions and terrain
+TEST_F(MovingAITest, LoadsMap) {
+    std::istringstream map(
+        "type octile\n"
+        "height 3\n"
+        "width 4\n"
+        "map\n"
+        "..@.\n"
+        "GTS.\n"
+        "..W.\n");
+
+    ASSERT_TRUE(loadMovingAIMap(map, *grid));
+    EXPECT_EQ(grid->getWidth(), 4);
+    EXPECT_EQ(grid->getHeight(), 3);
+
+    EXPECT_TRUE(grid->isWalkable(0, 0));
+    EXPECT_FALSE(grid->isWalkable(2, 0));  // Out of bounds terrain
+    EXPECT_TRUE(grid->isWalkable(0, 1));   // Ground
+    EXPECT_FALSE(grid->isWalkable(1, 1));  // Trees
+    EXPECT_TRUE(grid->isWalkable(2, 1));   // Swamp
+    EXPECT_FALSE(grid->isWalkable(2, 2));  // Water
+}
+
+// Test malformed maps are rejected
+TEST_F(MovingAITest, RejectsMalformedMap) {
+    std::istringstream shortRows(
+        "type octile\nheight 2\nwidth 4\nmap\n....\n..\n");
+    EXPECT_FALSE(loadMovingAIMap(shortRows, *grid));
+
+    std::istringstream missingRows(
+        "type octile\nheight 3\nwidth 2\nmap\n..\n");
+    EXPECT_FALSE(loadMovingAIMap(missingRows, *grid));
+
+    std::istringstream noHeader("....\n");
+    EXPECT_FALSE(loadMovingAIMap(noHeader, *grid));
+
+    // Grid is left as it was
+    EXPECT_EQ(grid->getWidth(), 1);
+}
+
+// Test scenario lines are parsed
+TEST_F(MovingAITest, LoadsScenarios) {
+    std::istringstream scen(
+        "version 1\n"
+        "0\tarena.map\t49\t49\t1\t11\t1\t12\t1.00000000\n"
+        "3\tarena.map\t49\t49\t8\t3\t20\t7\t13.65685425\n");
+
+    std::vector<MovingAIScenario> scenarios;
+    ASSERT_TRUE(loadMovingAIScenarios(scen, scenarios));
+    ASSERT_EQ(scenarios.size(), 2);
+
+    EXPECT_EQ(scenarios[1].bucket, 3);
+    EXPECT_EQ(scenarios[1].mapName, "arena.map");
+    EXPECT_EQ(scenarios[1].mapWidth, 49);
+    EXPECT_EQ(scenarios[1].start, Position(8, 3));
+    EXPECT_EQ(scenarios[1].goal, Position(20, 7));
+    EXPECT_NEAR(scenarios[1].optimalLength, 13.65685425, 1e-6);
+
+    std::istringstream broken("version 1\n0 arena.map 49 49 1 11\n");
+    EXPECT_FALSE(loadMovingAIScenarios(broken, scenarios));
+}
+
+// Test a loaded map can be searched
+TEST_F(MovingAITest, SearchLoadedMap) {
+    std::istringstream map(
+        "type octile\nheight 3\nwidth 3\nmap\n"
+        "...\n"
+        "@@.\n"
+        "...\n");
+    ASSERT_TRUE(loadMovingAIMap(map, *grid));
+
+    Pathfinder pathfinder;
+    std::vector<Position> path;
+    EXPECT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, Position{0, 2}, path));
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), 6.0f);
+}
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "pathfinding/openlist.h"
+#include "pathfinding/pathfinder.h"
+
+namespace pathfinding::test {
+
+struct TestNode {
+    float f;
+    size_t openKey;
+    size_t openIndex;
+};
+
+struct TestNodeCompare {
+    bool operator()(const TestNode* x, const TestNode* y) const { return x->f > y->f; }
+};
+
+class OpenListTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        list = std::make_unique<OpenList<TestNode, TestNodeCompare>>();
+        nodes = {{5.0f, 0, 0}, {3.0f, 0, 0}, {5.0f, 0, 0}, {8.0f, 0, 0}, {3.0f, 0, 0}};
+    }
+
+    std::unique_ptr<OpenList<TestNode, TestNodeCompare>> list;
+    std::vector<TestNode> nodes;
+};
+
+// Test buckets pop in f order, last in first out on ties
+TEST_F(OpenListTest, BucketsLifoOrder) {
+    list->setPolicy(OpenListPolicy::Buckets, 1.0f);
+    for (TestNode& node : nodes) {
+        list->push(&node);
+    }
+    EXPECT_EQ(list->size(), 5);
+
+    EXPECT_EQ(list->pop(), &nodes[4]);
+    EXPECT_EQ(list->pop(), &nodes[1]);
+    EXPECT_EQ(list->pop(), &nodes[2]);
+
+    // Lowering f moves a node up
+    nodes[3].f = 2.0f;
+    list->update(&nodes[3]);
+    EXPECT_EQ(list->top(), &nodes[3]);
+
+    list->erase(&nodes[3]);
+    EXPECT_EQ(list->pop(), &nodes[0]);
+    EXPECT_TRUE(list->empty());
+}
+
+// Test f values between quanta still come out in order
+TEST_F(OpenListTest, BucketsInexactOrder) {
+    list->setPolicy(OpenListPolicy::Buckets, 1.0f);
+    nodes[0].f = 3.75f;
+    nodes[2].f = 3.25f;
+    for (TestNode& node : nodes) {
+        list->push(&node);
+    }
+
+    float last = 0.0f;
+    while (!list->empty()) {
+        TestNode* node = list->pop();
+        EXPECT_GE(node->f, last);
+        last = node->f;
+    }
+}
+
+// Test both policies find equally good paths
+TEST_F(OpenListTest, PoliciesAgree) {
+    Grid grid(40, 30);
+    grid.addTestObstacles();
+    Pathfinder buckets;
+    Pathfinder heap;
+    heap.setOpenListPolicy(OpenListPolicy::Heap);
+    EXPECT_EQ(buckets.getOpenListPolicy(), OpenListPolicy::Buckets);
+    EXPECT_EQ(heap.getOpenListPolicy(), OpenListPolicy::Heap);
+
+    std::vector<Position> path;
+    for (int y = 0; y < 30; y += 7) {
+        ASSERT_TRUE(buckets.findPath(grid, Position{2, 2}, Position{39, y}, path));
+        ASSERT_TRUE(heap.findPath(grid, Position{2, 2}, Position{39, y}, path));
+        EXPECT_FLOAT_EQ(buckets.getLastPathCost(), heap.getLastPathCost());
+    }
+}
+}
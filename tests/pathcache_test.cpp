@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathcache.h"
+#include "pathfinding/pathfinder.h"
+#include "pathfinding/grid.h"
+
+namespace pathfinding::test {
+
+class PathCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 10x10 grid for testing
+        grid = std::make_unique<Grid>(10, 10);
+        cache = std::make_unique<PathCache>();
+    }
+
+    // Straight horizontal path along row y from x0 to x1
+    std::vector<Position> row(int y, int x0, int x1) {
+        std::vector<Position> path;
+        for (int x = x0; x <= x1; ++x) {
+            path.push_back(Position{x, y});
+        }
+        return path;
+    }
+
+    std::unique_ptr<Grid> grid;
+    std::unique_ptr<PathCache> cache;
+};
+
+// Test exact hits and misses
+TEST_F(PathCacheTest, ExactHit) {
+    std::vector<Position> path;
+    float cost = 0.0f;
+
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+
+    cache->store(*grid, Position{0, 0}, Position{5, 0}, row(0, 0, 5), 5.0f);
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+    EXPECT_EQ(path.size(), 6);
+    EXPECT_FLOAT_EQ(cost, 5.0f);
+
+    EXPECT_EQ(cache->getStats().hits, 1);
+    EXPECT_EQ(cache->getStats().misses, 1);
+    EXPECT_FLOAT_EQ(cache->getStats().hitRate(), 0.5f);
+}
+
+// Test a query starting on a cached path is served from its tail
+TEST_F(PathCacheTest, SuffixHit) {
+    cache->store(*grid, Position{0, 3}, Position{7, 3}, row(3, 0, 7), 7.0f);
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_TRUE(cache->lookup(*grid, Position{4, 3}, Position{7, 3}, path, cost));
+    ASSERT_EQ(path.size(), 4);
+    EXPECT_EQ(path.front(), Position(4, 3));
+    EXPECT_EQ(path.back(), Position(7, 3));
+    EXPECT_FLOAT_EQ(cost, 3.0f);
+    EXPECT_EQ(cache->getStats().suffixHits, 1);
+
+    // A start off the path misses
+    EXPECT_FALSE(cache->lookup(*grid, Position{4, 4}, Position{7, 3}, path, cost));
+}
+
+// Test least recently used entries are evicted first
+TEST_F(PathCacheTest, LruEviction) {
+    PathCache small(2, 1000);
+    std::vector<Position> path;
+    float cost = 0.0f;
+
+    small.store(*grid, Position{0, 0}, Position{2, 0}, row(0, 0, 2), 2.0f);
+    small.store(*grid, Position{0, 1}, Position{2, 1}, row(1, 0, 2), 2.0f);
+    EXPECT_TRUE(small.lookup(*grid, Position{0, 0}, Position{2, 0}, path, cost)); // Refresh first
+    small.store(*grid, Position{0, 2}, Position{2, 2}, row(2, 0, 2), 2.0f);
+
+    EXPECT_EQ(small.size(), 2);
+    EXPECT_EQ(small.getStats().evictions, 1);
+    EXPECT_TRUE(small.lookup(*grid, Position{0, 0}, Position{2, 0}, path, cost));
+    EXPECT_FALSE(small.lookup(*grid, Position{0, 1}, Position{2, 1}, path, cost));
+}
+
+// Test the cap on stored positions
+TEST_F(PathCacheTest, CellCap) {
+    PathCache small(100, 10);
+    small.store(*grid, Position{0, 0}, Position{5, 0}, row(0, 0, 5), 5.0f);
+    small.store(*grid, Position{0, 1}, Position{5, 1}, row(1, 0, 5), 5.0f);
+
+    EXPECT_EQ(small.size(), 1);
+    EXPECT_LE(small.getCachedCells(), 10);
+}
+
+// Test a new wall only evicts paths crossing it
+TEST_F(PathCacheTest, WallInvalidatesCrossingPathsOnly) {
+    cache->store(*grid, Position{0, 0}, Position{5, 0}, row(0, 0, 5), 5.0f);
+    cache->store(*grid, Position{0, 5}, Position{5, 5}, row(5, 0, 5), 5.0f);
+
+    grid->setCell(Position{3, 0}, CellType::Wall);
+    cache->invalidateCell(*grid, Position{3, 0}, CellType::Wall);
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+    EXPECT_EQ(cache->getStats().invalidations, 1);
+}
+
+// Test a freed cell only evicts paths it could shorten
+TEST_F(PathCacheTest, FreedCellInvalidatesShortenablePaths) {
+    // Detour around a wall at (2, 1): cost 4 instead of 2
+    grid->setCell(Position{2, 1}, CellType::Wall);
+    std::vector<Position> detour = {{1, 1}, {1, 2}, {2, 2}, {3, 2}, {3, 1}};
+    cache->store(*grid, Position{1, 1}, Position{3, 1}, detour, 4.0f);
+    cache->store(*grid, Position{0, 8}, Position{5, 8}, row(8, 0, 5), 5.0f);
+
+    grid->setCell(Position{2, 1}, CellType::Empty);
+    cache->invalidateCell(*grid, Position{2, 1}, CellType::Empty);
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_FALSE(cache->lookup(*grid, Position{1, 1}, Position{3, 1}, path, cost));
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 8}, Position{5, 8}, path, cost));
+}
+
+// Test terrain evicts paths crossing it and paths it could make cheaper
+TEST_F(PathCacheTest, TerrainInvalidatesAffectedPaths) {
+    cache->store(*grid, Position{0, 0}, Position{5, 0}, row(0, 0, 5), 5.0f);
+    cache->store(*grid, Position{0, 5}, Position{5, 5}, row(5, 0, 5), 5.0f);
+    cache->store(*grid, Position{0, 9}, Position{9, 9}, row(9, 0, 9), 9.0f);
+
+    // Mud on a path makes it dearer
+    grid->setCell(Position{3, 0}, CellType::Mud);
+    cache->invalidateCell(*grid, Position{3, 0}, CellType::Mud);
+
+    // Road at half cost could shorten the long path through a small detour, not the row 5 one
+    grid->setCell(Position{4, 8}, CellType::Road);
+    cache->invalidateCell(*grid, Position{4, 8}, CellType::Road);
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 9}, Position{9, 9}, path, cost));
+
+    // A cost change clears the cache through the revision
+    grid->setTerrainCost(CellType::Road, 0.25f);
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+    EXPECT_EQ(cache->size(), 0);
+}
+
+// Test a wall beside a diagonal step evicts the path when corners cannot be cut
+TEST_F(PathCacheTest, WallBesideDiagonalStep) {
+    grid->setMovement(Connectivity::Eight);
+    std::vector<Position> diagonal = {{0, 0}, {1, 1}, {2, 2}};
+    cache->store(*grid, Position{0, 0}, Position{2, 2}, diagonal, 2 * Grid::kDiagonalCost);
+    cache->store(*grid, Position{0, 5}, Position{5, 5}, row(5, 0, 5), 5.0f);
+
+    grid->setCell(Position{2, 1}, CellType::Wall);
+    cache->invalidateCell(*grid, Position{2, 1}, CellType::Wall);
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{2, 2}, path, cost));
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+}
+
+// Test unreported edits clear everything
+TEST_F(PathCacheTest, UnreportedEditClearsCache) {
+    cache->store(*grid, Position{0, 5}, Position{5, 5}, row(5, 0, 5), 5.0f);
+    grid->setCell(Position{9, 9}, CellType::Wall);
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+    EXPECT_EQ(cache->size(), 0);
+    EXPECT_EQ(cache->getRevision(), grid->getRevision());
+}
+
+// Test Pathfinder uses the cache and stays correct after edits
+TEST_F(PathCacheTest, PathfinderIntegration) {
+    Pathfinder pathfinder;
+    pathfinder.setPathCache(cache.get());
+    std::vector<Position> path;
+
+    EXPECT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_GT(pathfinder.getLastSearchSteps(), 0);
+
+    EXPECT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_EQ(pathfinder.getLastSearchSteps(), 0);
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), 4.0f);
+    EXPECT_EQ(cache->getStats().hits, 1);
+
+    grid->setCell(Position{2, 0}, CellType::Wall);
+    cache->invalidateCell(*grid, Position{2, 0}, CellType::Wall);
+
+    EXPECT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_GT(pathfinder.getLastSearchSteps(), 0);
+    for (const auto& pos : path) {
+        EXPECT_NE(pos, Position(2, 0));
+    }
+}
+
+// Test the cache follows grid change batches
+TEST_F(PathCacheTest, GridSubscription) {
+    grid->subscribe([this](const GridChangeBatch& batch) {
+        cache->onGridChanged(batch);
+    });
+
+    cache->store(*grid, Position{0, 0}, Position{5, 0}, row(0, 0, 5), 5.0f);
+    cache->store(*grid, Position{0, 5}, Position{5, 5}, row(5, 0, 5), 5.0f);
+
+    grid->setCell(Position{2, 0}, CellType::Wall);
+    grid->setCell(Position{9, 9}, CellType::Wall);
+    grid->flushChanges();
+
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_EQ(cache->getRevision(), grid->getRevision());
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+}
+
+// Test lookups between an edit and its flush miss without clearing the cache
+TEST_F(PathCacheTest, LookupBeforeFlush) {
+    grid->subscribe([this](const GridChangeBatch& batch) {
+        cache->onGridChanged(batch);
+    });
+
+    cache->store(*grid, Position{0, 0}, Position{5, 0}, row(0, 0, 5), 5.0f);
+    cache->store(*grid, Position{0, 5}, Position{5, 5}, row(5, 0, 5), 5.0f);
+    grid->setCell(Position{2, 0}, CellType::Wall);
+
+    // The wall is not reported yet, so neither path is served but both are kept;
+    // paths found meanwhile are not stored
+    std::vector<Position> path;
+    float cost = 0.0f;
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+    cache->store(*grid, Position{0, 9}, Position{5, 9}, row(9, 0, 5), 5.0f);
+    EXPECT_EQ(cache->size(), 2);
+    EXPECT_EQ(cache->getStats().invalidations, 0);
+
+    // The flush evicts only the path through the wall
+    grid->flushChanges();
+    EXPECT_EQ(cache->getRevision(), grid->getRevision());
+    EXPECT_EQ(cache->getStats().invalidations, 1);
+    EXPECT_FALSE(cache->lookup(*grid, Position{0, 0}, Position{5, 0}, path, cost));
+    EXPECT_TRUE(cache->lookup(*grid, Position{0, 5}, Position{5, 5}, path, cost));
+}
+
+// Test paths found on another grid with the same revision are not served
+TEST_F(PathCacheTest, OtherGridIgnored) {
+    Grid a(5, 3);
+    Grid b(5, 3);
+    a.setCell(Position{2, 0}, CellType::Wall);
+    b.setCell(Position{2, 1}, CellType::Wall);
+    ASSERT_EQ(a.getRevision(), b.getRevision());
+
+    Pathfinder pathfinder;
+    pathfinder.setPathCache(cache.get());
+    std::vector<Position> path;
+    ASSERT_TRUE(pathfinder.findPath(a, Position{0, 1}, Position{4, 1}, path));
+    ASSERT_TRUE(pathfinder.findPath(b, Position{0, 1}, Position{4, 1}, path));
+    EXPECT_GT(pathfinder.getLastSearchSteps(), 0);
+    EXPECT_EQ(cache->getStats().hits + cache->getStats().suffixHits, 0);
+    for (const auto& pos : path) {
+        EXPECT_TRUE(b.isWalkable(pos));
+    }
+
+    // Nor are paths found on the same cells under other movement rules
+    Grid eight(a);
+    eight.setMovement(Connectivity::Eight);
+    Grid four(a);
+    four.setTerrainCost(CellType::Water, 5.0f);
+    ASSERT_EQ(four.getRevision(), eight.getRevision());
+    ASSERT_EQ(four.getCellHash(), eight.getCellHash());
+    ASSERT_TRUE(pathfinder.findPath(four, Position{0, 1}, Position{4, 1}, path));
+    ASSERT_TRUE(pathfinder.findPath(eight, Position{0, 1}, Position{4, 1}, path));
+    EXPECT_GT(pathfinder.getLastSearchSteps(), 0);
+}
+}
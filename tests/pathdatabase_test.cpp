@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathdatabase.h"
+#include "pathfinding/character.h"
+#include "pathfinding/pathfinder.h"
+#include "test_grids.h"
+#include <cstring>
+#include <sstream>
+
+namespace pathfinding::test {
+
+class PathDatabaseTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 16x12 grid with scattered walls and terrain
+        grid = makeScatteredGrid(16, 12, 5);
+    }
+
+    // Every pair of cells gets a path of optimal cost, or none when A* finds none
+    void expectOptimal(const PathDatabase& database) {
+        Pathfinder plain(1000);
+        expectMatchesAStar(*grid, plain, 1, 3, [&](const Position& start, const Position& goal,
+                                                   std::vector<Position>& path, float& cost) {
+            bool found = database.getPath(start, goal, path);
+            cost = walkCost(*grid, path);
+            return found;
+        });
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test next steps follow shortest paths with both movement rules
+TEST_F(PathDatabaseTest, ShortestPaths) {
+    PathDatabase database;
+    ASSERT_TRUE(database.build(*grid));
+    EXPECT_TRUE(database.isValidFor(*grid));
+    expectOptimal(database);
+    
+    grid->setMovement(Connectivity::Eight);
+    EXPECT_FALSE(database.isValidFor(*grid));
+    ASSERT_TRUE(database.build(*grid, 3));
+    expectOptimal(database);
+}
+
+// Test runs compress open maps far below one entry per pair
+TEST_F(PathDatabaseTest, Compression) {
+    Grid open(32, 32);
+    PathDatabase database;
+    ASSERT_TRUE(database.build(open));
+    EXPECT_LT(database.getRunCount(), 32u * 32u * 32u);
+    
+    Position next;
+    ASSERT_TRUE(database.nextStep(Position{0, 0}, Position{5, 0}, next));
+    EXPECT_EQ(next, Position(1, 0));
+    EXPECT_FALSE(database.nextStep(Position{3, 3}, Position{3, 3}, next));
+}
+
+// Test walls and separate areas have no next step
+TEST_F(PathDatabaseTest, Unreachable) {
+    Grid split(8, 4);
+    for (int y = 0; y < 4; ++y) {
+        split.setCell(Position{4, y}, CellType::Wall);
+    }
+    PathDatabase database;
+    ASSERT_TRUE(database.build(split));
+    
+    Position next;
+    std::vector<Position> path;
+    EXPECT_FALSE(database.nextStep(Position{0, 0}, Position{7, 0}, next));
+    EXPECT_FALSE(database.nextStep(Position{0, 0}, Position{4, 0}, next));
+    EXPECT_FALSE(database.nextStep(Position{0, 0}, Position{20, 0}, next));
+    EXPECT_FALSE(database.getPath(Position{0, 0}, Position{7, 0}, path));
+    EXPECT_TRUE(path.empty());
+}
+
+// Test saved tables load and attach in place
+TEST_F(PathDatabaseTest, SaveLoadAttach) {
+    PathDatabase database;
+    ASSERT_TRUE(database.build(*grid));
+    std::stringstream stream;
+    ASSERT_TRUE(database.save(stream));
+    std::string bytes = stream.str();
+    EXPECT_EQ(bytes.size(), database.getMemoryBytes());
+    
+    PathDatabase loaded;
+    ASSERT_TRUE(loaded.load(stream));
+    EXPECT_TRUE(loaded.isValidFor(*grid));
+    expectOptimal(loaded);
+    
+    std::vector<std::uint32_t> mapped(bytes.size() / sizeof(std::uint32_t));
+    std::memcpy(mapped.data(), bytes.data(), bytes.size());
+    PathDatabase attached;
+    ASSERT_TRUE(attached.attach(mapped.data(), bytes.size()));
+    EXPECT_EQ(attached.getRunCount(), database.getRunCount());
+    expectOptimal(attached);
+    
+    // Truncated or foreign data is rejected
+    EXPECT_FALSE(attached.attach(mapped.data(), bytes.size() - 4));
+    EXPECT_TRUE(attached.empty());
+    mapped[0] = 0;
+    EXPECT_FALSE(attached.attach(mapped.data(), bytes.size()));
+}
+
+// Test tables for another map are not used
+TEST_F(PathDatabaseTest, OtherMapRejected) {
+    PathDatabase database;
+    ASSERT_TRUE(database.build(*grid));
+    
+    Pathfinder pathfinder(1000);
+    pathfinder.setPathDatabase(&database);
+    grid->setCell(Position{8, 6}, grid->isWalkable(Position{8, 6}) ? CellType::Wall : CellType::Empty);
+    EXPECT_FALSE(database.isValidFor(*grid));
+    
+    // Pathfinder falls back to searching
+    std::vector<Position> path;
+    Pathfinder plain(1000);
+    ASSERT_TRUE(plain.findPath(*grid, Position{1, 1}, Position{14, 10}, path));
+    ASSERT_TRUE(pathfinder.findPath(*grid, Position{1, 1}, Position{14, 10}, path));
+    EXPECT_EQ(pathfinder.getLastSearchSteps(), plain.getLastSearchSteps());
+    EXPECT_GT(pathfinder.getLastSearchSteps(), 0);
+    
+    // Nor is it used on another grid with the same revision
+    Grid line(5, 1);
+    line.setCell(Position{0, 0}, CellType::Mud);
+    line.setCell(Position{4, 0}, CellType::Mud);
+    Grid walled(5, 1);
+    walled.setCell(Position{2, 0}, CellType::Wall);
+    walled.setCell(Position{4, 0}, CellType::Mud);
+    ASSERT_EQ(line.getRevision(), walled.getRevision());
+    ASSERT_TRUE(database.build(line));
+    EXPECT_TRUE(database.isValidFor(line));
+    line = walled;
+    EXPECT_FALSE(database.isValidFor(line));
+    EXPECT_FALSE(pathfinder.findPath(line, Position{0, 0}, Position{4, 0}, path));
+}
+
+// Test Pathfinder answers from the database without searching
+TEST_F(PathDatabaseTest, PathfinderUsesDatabase) {
+    Grid open(20, 20);
+    open.setCell(Position{10, 10}, CellType::Mud);
+    PathDatabase database;
+    ASSERT_TRUE(database.build(open));
+    
+    Pathfinder pathfinder(1000);
+    pathfinder.setPathDatabase(&database);
+    std::vector<Position> path;
+    ASSERT_TRUE(pathfinder.findPath(open, Position{0, 10}, Position{19, 10}, path));
+    EXPECT_EQ(pathfinder.getLastSearchSteps(), 0);
+    EXPECT_FLOAT_EQ(pathfinder.getLastPathCost(), 20.0f);
+    EXPECT_EQ(path.front(), Position(0, 10));
+    EXPECT_EQ(path.back(), Position(19, 10));
+}
+
+// Test characters walk database paths one query per step
+TEST_F(PathDatabaseTest, CharacterFollowsDatabase) {
+    Grid open(10, 10);
+    PathDatabase database;
+    ASSERT_TRUE(database.build(open));
+    
+    Character character(Position{0, 0});
+    character.setPathDatabase(&database);
+    ASSERT_TRUE(character.findPathTo(open, Position{6, 3}));
+    EXPECT_EQ(character.getCurrentPath().size(), 1);
+    
+    int steps = 0;
+    while (character.hasPath() && steps < 100) {
+        character.followPath();
+        steps++;
+    }
+    EXPECT_EQ(character.getPosition(), Position(6, 3));
+    EXPECT_EQ(steps, 9);
+}
+}
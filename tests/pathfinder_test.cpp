@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "pathfinding/pathfinder.h"
 #include "pathfinding/grid.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 namespace pathfinding::test {
 
@@ -157,4 +160,350 @@ TEST_F(PathfinderTest, SearchStepsCount) {
     // For simple paths, shouldn't need too many steps
     EXPECT_LT(pathfinder->getLastSearchSteps(), 50);
 }
+
+// Test search statistics describe the last search
+TEST_F(PathfinderTest, SearchStatsAreCollected) {
+#if PATHFINDING_SEARCH_STATS
+    grid->setCell(Position{2, 0}, CellType::Wall);
+    grid->setCell(Position{2, 1}, CellType::Wall);
+    std::vector<Position> path;
+    
+    EXPECT_TRUE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    const SearchStats& stats = pathfinder->getLastSearchStats();
+    
+    // Every step pops a node; all but the goal are expanded
+    EXPECT_EQ(stats.heapPops, static_cast<size_t>(pathfinder->getLastSearchSteps()));
+    EXPECT_EQ(stats.nodesExpanded + 1, stats.heapPops);
+    EXPECT_GE(stats.nodesGenerated, stats.nodesExpanded);
+    EXPECT_GE(stats.heapPushes, stats.heapPops);
+    EXPECT_GT(stats.peakOpenSize, 0);
+    EXPECT_GT(stats.peakClosedSize, 0);
+    EXPECT_GE(stats.peakAllocatedNodes, stats.peakClosedSize);
+    EXPECT_GE(stats.searchMicros, 0.0);
+    
+    // Unreachable goal: every popped node is expanded and nothing is extracted
+    for (int y = 0; y < 5; ++y) {
+        grid->setCell(Position{2, y}, CellType::Wall);
+    }
+    EXPECT_FALSE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_EQ(pathfinder->getLastSearchStats().nodesExpanded, pathfinder->getLastSearchStats().heapPops);
+    EXPECT_DOUBLE_EQ(pathfinder->getLastSearchStats().extractionMicros, 0.0);
+#else
+    GTEST_SKIP() << "Built with PATHFINDING_SEARCH_STATS=0";
+#endif
+}
+
+// Test distance queries agree with full searches
+TEST_F(PathfinderTest, DistanceOnly) {
+    grid->setCell(Position{1, 1}, CellType::Wall);
+    std::vector<Position> path;
+    float distance = 0.0f;
+    
+    ASSERT_TRUE(pathfinder->findPath(*grid, Position{0, 1}, Position{2, 1}, path));
+    EXPECT_TRUE(pathfinder->findDistance(*grid, Position{0, 1}, Position{2, 1}, distance));
+    EXPECT_FLOAT_EQ(distance, pathfinder->getLastPathCost());
+    EXPECT_FLOAT_EQ(distance, static_cast<float>(path.size() - 1));
+    
+    // Start on the goal
+    EXPECT_TRUE(pathfinder->findDistance(*grid, Position{3, 3}, Position{3, 3}, distance));
+    EXPECT_FLOAT_EQ(distance, 0.0f);
+    
+    // Unreachable
+    for (int x = 0; x < 5; ++x) {
+        grid->setCell(Position{x, 2}, CellType::Wall);
+    }
+    EXPECT_FALSE(pathfinder->findDistance(*grid, Position{0, 0}, Position{4, 4}, distance));
+    EXPECT_TRUE(std::isinf(distance));
+}
+
+// Test bulk teardown gives every node back between distance queries
+TEST_F(PathfinderTest, DistanceReleasesNodes) {
+    Grid large(40, 40);
+    Pathfinder limited(2000);
+    float distance = 0.0f;
+    
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(limited.findDistance(large, Position{0, 0}, Position{39, 39 - i % 10}, distance));
+        EXPECT_FLOAT_EQ(distance, static_cast<float>(78 - i % 10));
+    }
+    
+    // Full searches still work on the same allocator afterwards
+    std::vector<Position> path;
+    EXPECT_TRUE(limited.findPath(large, Position{0, 0}, Position{39, 39}, path));
+    EXPECT_EQ(path.size(), 79);
+}
+
+// Test one-to-many distances
+TEST_F(PathfinderTest, DistancesToTargets) {
+    for (int x = 0; x < 5; ++x) {
+        grid->setCell(Position{x, 2}, CellType::Wall);
+    }
+    std::vector<float> distances;
+    
+    EXPECT_EQ(pathfinder->findDistances(*grid, Position{0, 0}, {{4, 1}, {4, 4}, {0, 0}}, distances), 2);
+    EXPECT_FLOAT_EQ(distances[0], 5.0f);
+    EXPECT_TRUE(std::isinf(distances[1]));
+    EXPECT_FLOAT_EQ(distances[2], 0.0f);
+    
+    // A blocked start reaches nothing without searching
+    EXPECT_EQ(pathfinder->findDistances(*grid, Position{0, 2}, {{4, 1}, {0, 0}}, distances), 0);
+    ASSERT_EQ(distances.size(), 2);
+    EXPECT_TRUE(std::isinf(distances[0]));
+    EXPECT_TRUE(std::isinf(distances[1]));
+    EXPECT_EQ(pathfinder->getLastSearchSteps(), 0);
+}
+
+// Test the nearest of several targets is found in one search
+TEST_F(PathfinderTest, NearestOfManyTargets) {
+    Grid world(40, 30);
+    world.addTestObstacles();
+    std::vector<Position> targets = {{30, 25}, {13, 9}, {20, 7}, {12, 5}, {3, 28}};
+    Position start{8, 3};
+    
+    float best = 0.0f;
+    bool anyFound = false;
+    std::vector<Position> single;
+    for (const Position& target : targets) {
+        if (pathfinder->findPath(world, start, target, single) &&
+            (!anyFound || pathfinder->getLastPathCost() < best)) {
+            best = pathfinder->getLastPathCost();
+            anyFound = true;
+        }
+    }
+    ASSERT_TRUE(anyFound);
+    
+    std::vector<Position> path;
+    ASSERT_TRUE(pathfinder->findPathToNearest(world, start, targets, path));
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), best);
+    EXPECT_EQ(path.front(), start);
+    EXPECT_NE(std::find(targets.begin(), targets.end(), path.back()), targets.end());
+    EXPECT_EQ(path.size(), static_cast<size_t>(best) + 1);
+}
+
+// Test invalid targets are skipped and an all-invalid set fails
+TEST_F(PathfinderTest, NearestSkipsInvalidTargets) {
+    grid->setCell(Position{1, 0}, CellType::Wall);
+    std::vector<Position> path;
+    
+    ASSERT_TRUE(pathfinder->findPathToNearest(*grid, Position{0, 0}, {{1, 0}, {9, 9}, {4, 4}}, path));
+    EXPECT_EQ(path.back(), Position(4, 4));
+    
+    EXPECT_FALSE(pathfinder->findPathToNearest(*grid, Position{0, 0}, {{1, 0}, {-1, 2}}, path));
+    EXPECT_TRUE(path.empty());
+    
+    // Start on one of the targets
+    ASSERT_TRUE(pathfinder->findPathToNearest(*grid, Position{2, 2}, {{4, 4}, {2, 2}}, path));
+    EXPECT_EQ(path.size(), 1);
+}
+
+// Test an expansion budget yields a partial path heading towards the goal
+TEST_F(PathfinderTest, BoundedExpansionsPartialPath) {
+    Grid world(40, 30);
+    Position start{0, 0};
+    Position goal{39, 29};
+    std::vector<Position> path;
+    
+    SearchBudget budget;
+    budget.maxExpansions = 10;
+    ASSERT_TRUE(pathfinder->findPathBounded(world, start, goal, budget, path));
+    EXPECT_TRUE(pathfinder->isLastPathPartial());
+    EXPECT_LE(pathfinder->getLastSearchSteps(), 10);
+    ASSERT_GT(path.size(), 1);
+    EXPECT_EQ(path.front(), start);
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), static_cast<float>(path.size() - 1));
+    
+    // Every step is a move and the end is closer to the goal
+    for (size_t i = 1; i < path.size(); ++i) {
+        EXPECT_EQ(abs(path[i].x - path[i - 1].x) + abs(path[i].y - path[i - 1].y), 1);
+    }
+    EXPECT_LT(GridState::estimate(path.back(), goal), GridState::estimate(start, goal));
+    
+    // A large enough budget gives the full path
+    budget.maxExpansions = 100000;
+    ASSERT_TRUE(pathfinder->findPathBounded(world, start, goal, budget, path));
+    EXPECT_FALSE(pathfinder->isLastPathPartial());
+    EXPECT_EQ(path.back(), goal);
+    EXPECT_EQ(path.size(), 69);
+}
+
+// Test an unreachable goal yields a path to the closest reachable cell
+TEST_F(PathfinderTest, BoundedUnreachableGoal) {
+    for (int x = 0; x < 5; ++x) {
+        grid->setCell(Position{x, 3}, CellType::Wall);
+    }
+    std::vector<Position> path;
+    
+    ASSERT_TRUE(pathfinder->findPathBounded(*grid, Position{0, 0}, Position{2, 4}, SearchBudget(), path));
+    EXPECT_TRUE(pathfinder->isLastPathPartial());
+    EXPECT_EQ(path.back(), Position(2, 2));
+    EXPECT_EQ(path.size(), 5);
+    
+    // Walls as goals are allowed, out of bounds goals are not
+    ASSERT_TRUE(pathfinder->findPathBounded(*grid, Position{0, 0}, Position{4, 3}, SearchBudget(), path));
+    EXPECT_EQ(path.back(), Position(4, 2));
+    EXPECT_FALSE(pathfinder->findPathBounded(*grid, Position{0, 0}, Position{5, 3}, SearchBudget(), path));
+    EXPECT_FALSE(pathfinder->isLastPathPartial());
+}
+
+// Test a time budget caps the search
+TEST_F(PathfinderTest, BoundedTimePartialPath) {
+    Grid world(512, 512);
+    Pathfinder large(512 * 512 + 8);
+    std::vector<Position> path;
+    
+    SearchBudget budget;
+    budget.maxMicros = 1.0;
+    ASSERT_TRUE(large.findPathBounded(world, Position{0, 0}, Position{511, 511}, budget, path));
+    EXPECT_TRUE(large.isLastPathPartial());
+    EXPECT_LT(large.getLastSearchSteps(), 512 * 512);
+    EXPECT_EQ(path.front(), Position(0, 0));
+}
+
+// Test weighted searches stay within their bound
+TEST_F(PathfinderTest, WeightedSearchBound) {
+    Grid world(64, 64);
+    unsigned int seed = 12345;
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 16) % 100 < 25) {
+                world.setCell(Position{x, y}, CellType::Wall);
+            }
+        }
+    }
+    world.setCell(Position{0, 0}, CellType::Empty);
+    
+    Pathfinder weighted(64 * 64 + 8);
+    weighted.setHeuristicWeight(2.0f);
+    Pathfinder optimal(64 * 64 + 8);
+    std::vector<Position> path;
+    
+    int compared = 0;
+    for (int y = 63; y > 40; --y) {
+        Position goal{63 - (63 - y) / 2, y};
+        if (!optimal.findPath(world, Position{0, 0}, goal, path)) {
+            continue;
+        }
+        ASSERT_TRUE(weighted.findPath(world, Position{0, 0}, goal, path));
+        EXPECT_LE(weighted.getLastPathCost(), 2.0f * optimal.getLastPathCost());
+        EXPECT_GE(weighted.getLastPathCost(), optimal.getLastPathCost());
+        EXPECT_FLOAT_EQ(weighted.getLastSuboptimalityBound(), 2.0f);
+        EXPECT_FLOAT_EQ(optimal.getLastSuboptimalityBound(), 1.0f);
+        compared++;
+    }
+    EXPECT_GT(compared, 0);
+}
+
+// Test anytime searches end optimal without a time limit and bounded with one
+TEST_F(PathfinderTest, AnytimeSearch) {
+    Grid world(64, 64);
+    for (int x = 8; x < 56; ++x) {
+        world.setCell(Position{x, 32}, CellType::Wall);
+    }
+    for (int y = 8; y < 32; ++y) {
+        world.setCell(Position{55, y}, CellType::Wall);
+    }
+    Pathfinder anytime(64 * 64 + 8);
+    Pathfinder optimal(64 * 64 + 8);
+    std::vector<Position> path;
+    std::vector<Position> optimalPath;
+    
+    ASSERT_TRUE(optimal.findPath(world, Position{40, 60}, Position{40, 10}, optimalPath));
+    
+    AnytimeOptions options;
+    ASSERT_TRUE(anytime.findPathAnytime(world, Position{40, 60}, Position{40, 10}, options, path));
+    EXPECT_FLOAT_EQ(anytime.getLastPathCost(), optimal.getLastPathCost());
+    EXPECT_FLOAT_EQ(anytime.getLastSuboptimalityBound(), 1.0f);
+    EXPECT_EQ(path.size(), optimalPath.size());
+    EXPECT_EQ(path.back(), Position(40, 10));
+    
+    // No time to improve: the first solution comes with its bound
+    options.maxMicros = 1e-3;
+    ASSERT_TRUE(anytime.findPathAnytime(world, Position{40, 60}, Position{40, 10}, options, path));
+    EXPECT_GE(anytime.getLastSuboptimalityBound(), 1.0f);
+    EXPECT_LE(anytime.getLastSuboptimalityBound(), options.initialWeight);
+    EXPECT_LE(anytime.getLastPathCost(), anytime.getLastSuboptimalityBound() * optimal.getLastPathCost() + 1e-3f);
+    EXPECT_FLOAT_EQ(anytime.getLastPathCost(), static_cast<float>(path.size() - 1));
+}
+
+// Test a background search on a snapshot while the grid is being edited
+TEST_F(PathfinderTest, SearchOnSnapshotDuringEdits) {
+    Grid world(64, 64);
+    Grid snapshot = world.snapshot();
+    
+    bool found = false;
+    std::vector<Position> path;
+    std::thread worker([&snapshot, &found, &path]() {
+        Pathfinder background;
+        found = background.findPath(snapshot, Position{0, 0}, Position{20, 20}, path);
+    });
+    
+    // Wall off the goal in the live grid while the search runs
+    for (int i = 0; i < 1000; ++i) {
+        CellType type = (i % 2) ? CellType::Empty : CellType::Wall;
+        for (int x = 0; x < 64; ++x) {
+            world.setCell(Position{x, 10}, type);
+        }
+    }
+    world.setCell(Position{20, 20}, CellType::Wall);
+    worker.join();
+    
+    EXPECT_TRUE(found);
+    EXPECT_EQ(path.size(), 41);
+    EXPECT_EQ(snapshot.getCell(Position{20, 20}), CellType::Empty);
+    EXPECT_EQ(world.getCell(Position{20, 20}), CellType::Wall);
+}
+
+// Test terrain costs steer the path and its cost
+TEST_F(PathfinderTest, TerrainCosts) {
+    // Mud across every row but the last
+    for (int y = 0; y < 4; ++y) {
+        grid->setCell({2, y}, CellType::Mud);
+    }
+    std::vector<Position> path;
+    
+    // Crossing the mud (2 + 3 plain cells) beats the detour through row 4
+    ASSERT_TRUE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_EQ(path.size(), 5);
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), 5.0f);
+    
+    // Expensive enough mud makes the 12-step detour cheaper
+    grid->setTerrainCost(CellType::Mud, 20.0f);
+    ASSERT_TRUE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_EQ(path.size(), 13);
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), 12.0f);
+    for (const Position& pos : path) {
+        EXPECT_NE(grid->getCell(pos), CellType::Mud);
+    }
+    
+    // A road along row 4 is cheaper still: 3 plain cells down, 5 road cells, 4 plain cells up
+    for (int x = 0; x < 5; ++x) {
+        grid->setCell({x, 4}, CellType::Road);
+    }
+    ASSERT_TRUE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 0}, path));
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), 3.0f + 5 * 0.5f + 4.0f);
+}
+
+// Test 8-connected paths take diagonals without cutting corners
+TEST_F(PathfinderTest, EightConnected) {
+    grid->setMovement(Connectivity::Eight);
+    std::vector<Position> path;
+    
+    ASSERT_TRUE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 4}, path));
+    EXPECT_EQ(path.size(), 5);
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), 4 * Grid::kDiagonalCost);
+    
+    // A wall along the diagonal also blocks the diagonals next to it:
+    // two steps east, two diagonals, two steps south
+    grid->setCell({1, 1}, CellType::Wall);
+    grid->setCell({2, 2}, CellType::Wall);
+    grid->setCell({3, 3}, CellType::Wall);
+    ASSERT_TRUE(pathfinder->findPath(*grid, Position{0, 0}, Position{4, 4}, path));
+    EXPECT_FLOAT_EQ(pathfinder->getLastPathCost(), 4.0f + 2 * Grid::kDiagonalCost);
+    for (size_t i = 1; i < path.size(); ++i) {
+        EXPECT_TRUE(grid->isWalkable(path[i].x, path[i - 1].y));
+        EXPECT_TRUE(grid->isWalkable(path[i - 1].x, path[i].y));
+    }
+}
+
 } 
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathrequestscheduler.h"
+#include "pathfinding/grid.h"
+
+namespace pathfinding::test {
+
+class PathRequestSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 10x10 grid for testing
+        grid = std::make_unique<Grid>(10, 10);
+        scheduler = std::make_unique<PathRequestScheduler>(1000);
+    }
+
+    void runUntilIdle() {
+        for (int i = 0; i < 1000 && scheduler->getQueuedCount() > 0; ++i) {
+            scheduler->tick(*grid);
+        }
+        scheduler->tick(*grid);
+    }
+
+    std::unique_ptr<Grid> grid;
+    std::unique_ptr<PathRequestScheduler> scheduler;
+};
+
+// Test a single request is served
+TEST_F(PathRequestSchedulerTest, ServesRequest) {
+    PathRequestId id = scheduler->submit(Position{0, 0}, Position{3, 0});
+    EXPECT_EQ(scheduler->getStatus(id), PathRequestStatus::Pending);
+
+    scheduler->tick(*grid);
+    EXPECT_EQ(scheduler->getStatus(id), PathRequestStatus::Succeeded);
+
+    std::vector<Position> path;
+    EXPECT_TRUE(scheduler->takeResult(id, path));
+    ASSERT_EQ(path.size(), 4);
+    EXPECT_EQ(path.front(), Position(0, 0));
+    EXPECT_EQ(path.back(), Position(3, 0));
+
+    // Result can only be taken once
+    EXPECT_EQ(scheduler->getStatus(id), PathRequestStatus::Unknown);
+}
+
+// Test identical requests are merged and every caller gets the path
+TEST_F(PathRequestSchedulerTest, DeduplicatesIdenticalRequests) {
+    PathRequestId first = scheduler->submit(Position{0, 0}, Position{5, 5});
+    PathRequestId second = scheduler->submit(Position{0, 0}, Position{5, 5});
+    PathRequestId other = scheduler->submit(Position{0, 0}, Position{5, 4});
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(scheduler->getQueuedCount(), 2);
+    EXPECT_EQ(scheduler->getMergedCount(), 1);
+
+    runUntilIdle();
+
+    std::vector<Position> pathA;
+    std::vector<Position> pathB;
+    EXPECT_TRUE(scheduler->takeResult(first, pathA));
+    EXPECT_TRUE(scheduler->takeResult(second, pathB));
+    EXPECT_EQ(pathA.size(), 11);
+    EXPECT_EQ(pathB.size(), 11);
+}
+
+// Test the expansion budget spreads a search over several ticks
+TEST_F(PathRequestSchedulerTest, RespectsExpansionBudget) {
+    scheduler->setExpansionsPerTick(5);
+    PathRequestId id = scheduler->submit(Position{0, 0}, Position{9, 9});
+
+    int ticks = 0;
+    while (scheduler->getStatus(id) != PathRequestStatus::Succeeded && ticks < 1000) {
+        scheduler->tick(*grid);
+        EXPECT_LE(scheduler->getLastTickExpansions(), 5);
+        ticks++;
+    }
+
+    EXPECT_GT(ticks, 1);
+    EXPECT_EQ(scheduler->getStatus(id), PathRequestStatus::Succeeded);
+}
+
+// Test urgent requests are served before older, less urgent ones
+TEST_F(PathRequestSchedulerTest, UrgencyOrdersQueue) {
+    scheduler->setExpansionsPerTick(1);
+    PathRequestId relaxed = scheduler->submit(Position{0, 0}, Position{1, 0}, 0);
+    PathRequestId urgent = scheduler->submit(Position{9, 9}, Position{8, 9}, 5);
+
+    while (scheduler->getStatus(urgent) != PathRequestStatus::Succeeded) {
+        scheduler->tick(*grid);
+    }
+
+    EXPECT_EQ(scheduler->getStatus(relaxed), PathRequestStatus::Pending);
+}
+
+// Test shorter requests go first at equal urgency
+TEST_F(PathRequestSchedulerTest, DistanceOrdersQueue) {
+    scheduler->setExpansionsPerTick(1);
+    PathRequestId far = scheduler->submit(Position{0, 0}, Position{9, 9});
+    PathRequestId near = scheduler->submit(Position{5, 5}, Position{5, 6});
+
+    while (scheduler->getStatus(near) != PathRequestStatus::Succeeded) {
+        scheduler->tick(*grid);
+    }
+
+    EXPECT_EQ(scheduler->getStatus(far), PathRequestStatus::Pending);
+}
+
+// Test invalid and unreachable requests fail
+TEST_F(PathRequestSchedulerTest, FailedRequests) {
+    grid->setCell(Position{2, 2}, CellType::Wall);
+    for (int x = 0; x < 10; ++x) {
+        grid->setCell(Position{x, 5}, CellType::Wall);
+    }
+
+    PathRequestId wallGoal = scheduler->submit(Position{0, 0}, Position{2, 2});
+    PathRequestId unreachable = scheduler->submit(Position{0, 0}, Position{9, 9});
+
+    runUntilIdle();
+
+    std::vector<Position> path;
+    EXPECT_EQ(scheduler->getStatus(wallGoal), PathRequestStatus::Failed);
+    EXPECT_FALSE(scheduler->takeResult(wallGoal, path));
+    EXPECT_EQ(scheduler->getStatus(unreachable), PathRequestStatus::Failed);
+    EXPECT_FALSE(scheduler->takeResult(unreachable, path));
+    EXPECT_TRUE(path.empty());
+}
+
+// Test latency percentiles are reported
+TEST_F(PathRequestSchedulerTest, LatencyPercentiles) {
+    EXPECT_FLOAT_EQ(scheduler->getLatencyPercentile(50.0f), 0.0f);
+
+    for (int i = 0; i < 5; ++i) {
+        scheduler->submit(Position{0, i}, Position{9, i});
+    }
+    runUntilIdle();
+
+    EXPECT_EQ(scheduler->getCompletedCount(), 5);
+    EXPECT_GE(scheduler->getLatencyPercentile(99.0f), scheduler->getLatencyPercentile(50.0f));
+    EXPECT_GT(scheduler->getLatencyPercentile(100.0f), 0.0f);
+}
+
+// Test destroying the scheduler mid-search releases its nodes
+TEST_F(PathRequestSchedulerTest, DestroyWhileSearching) {
+    scheduler->setExpansionsPerTick(2);
+    scheduler->submit(Position{0, 0}, Position{9, 9});
+    scheduler->tick(*grid);
+
+    scheduler.reset();
+    SUCCEED();
+}
+
+// Test cancelled requests are dropped whether queued, searching or completed
+TEST_F(PathRequestSchedulerTest, CancelDropsRequests) {
+    scheduler->setExpansionsPerTick(2);
+    PathRequestId searching = scheduler->submit(Position{0, 0}, Position{9, 8});
+    PathRequestId queued = scheduler->submit(Position{0, 0}, Position{9, 9});
+    PathRequestId merged = scheduler->submit(Position{0, 0}, Position{9, 9});
+    scheduler->tick(*grid);
+    EXPECT_EQ(scheduler->getStatus(searching), PathRequestStatus::Searching);
+
+    // A merged caller keeps the request alive
+    EXPECT_TRUE(scheduler->cancel(merged));
+    EXPECT_EQ(scheduler->getStatus(queued), PathRequestStatus::Pending);
+    EXPECT_TRUE(scheduler->cancel(queued));
+    EXPECT_EQ(scheduler->getStatus(queued), PathRequestStatus::Unknown);
+    EXPECT_EQ(scheduler->getQueuedCount(), 0);
+
+    EXPECT_TRUE(scheduler->cancel(searching));
+    EXPECT_EQ(scheduler->getStatus(searching), PathRequestStatus::Unknown);
+    EXPECT_FALSE(scheduler->cancel(searching));
+    EXPECT_EQ(scheduler->getRequestCount(), 0);
+
+    // The scheduler goes on with later requests
+    scheduler->setExpansionsPerTick(1000);
+    PathRequestId done = scheduler->submit(Position{0, 0}, Position{9, 9});
+    scheduler->tick(*grid);
+    EXPECT_EQ(scheduler->getStatus(done), PathRequestStatus::Succeeded);
+    EXPECT_TRUE(scheduler->cancel(done));
+    EXPECT_EQ(scheduler->getRequestCount(), 0);
+}
+}
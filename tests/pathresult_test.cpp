@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathresult.h"
+#include "pathfinding/pathfinder.h"
+
+namespace pathfinding::test {
+
+class PathResultTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 40x30 grid for testing
+        grid = std::make_unique<Grid>(40, 30);
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test the cursor consumes steps without touching the buffer
+TEST_F(PathResultTest, CursorAdvances) {
+    PathResult path(std::vector<Position>{{0, 0}, {1, 0}, {2, 0}});
+    const Position* buffer = path.getSteps().data();
+
+    EXPECT_EQ(path.size(), 3);
+    path.advance();
+    EXPECT_EQ(path.size(), 2);
+    EXPECT_EQ(path.front(), Position(1, 0));
+    EXPECT_EQ(path[1], Position(2, 0));
+    EXPECT_EQ(path.getSteps().data(), buffer);
+
+    path.advance(5);
+    EXPECT_TRUE(path.empty());
+    EXPECT_EQ(path.getSteps().size(), 3);
+}
+
+// Test moving hands over the buffer
+TEST_F(PathResultTest, MoveKeepsBuffer) {
+    PathResult source(std::vector<Position>{{0, 0}, {0, 1}});
+    source.advance();
+    const Position* buffer = source.getSteps().data();
+
+    PathResult moved(std::move(source));
+    EXPECT_EQ(moved.getSteps().data(), buffer);
+    EXPECT_EQ(moved.size(), 1);
+    EXPECT_EQ(moved.front(), Position(0, 1));
+}
+
+// Test Pathfinder sizes the result once and reuses it
+TEST_F(PathResultTest, PathfinderFillsInPlace) {
+    Pathfinder pathfinder(2000);
+    PathResult path;
+
+    ASSERT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, Position{20, 10}, path));
+    EXPECT_EQ(path.size(), 31);
+    EXPECT_EQ(path.getSteps().capacity(), 31);
+    EXPECT_EQ(path.front(), Position(0, 0));
+    EXPECT_EQ(path.back(), Position(20, 10));
+
+    // A shorter path fits in the same buffer
+    path.advance(3);
+    const Position* buffer = path.getSteps().data();
+    ASSERT_TRUE(pathfinder.findPath(*grid, Position{5, 5}, Position{10, 5}, path));
+    EXPECT_EQ(path.getCursor(), 0);
+    EXPECT_EQ(path.size(), 6);
+    EXPECT_EQ(path.getSteps().data(), buffer);
+}
+
+// Test compression round trips and shrinks straight paths
+TEST_F(PathResultTest, CompressedRoundTrip) {
+    std::vector<Position> steps;
+    for (int x = 0; x <= 40; ++x) {
+        steps.push_back(Position{x, 0});
+    }
+    for (int i = 1; i <= 5; ++i) {
+        steps.push_back(Position{40 + i, i});  // Diagonal
+    }
+    steps.push_back(Position{45, 6});
+
+    PathResult path(steps);
+    CompressedPath compressed;
+    ASSERT_TRUE(compressed.assign(path));
+
+    // 40 east steps need two runs, then one diagonal and one south run
+    EXPECT_EQ(compressed.getRunCount(), 4);
+    EXPECT_EQ(compressed.size(), steps.size());
+    EXPECT_EQ(compressed.getStart(), Position(0, 0));
+
+    PathResult restored = compressed.decompress();
+    EXPECT_EQ(restored.getSteps(), steps);
+}
+
+// Test paths with gaps are rejected
+TEST_F(PathResultTest, CompressRejectsJumps) {
+    std::vector<Position> steps = {{0, 0}, {1, 0}, {3, 0}};
+    CompressedPath compressed;
+    EXPECT_FALSE(compressed.assign(steps.data(), steps.data() + steps.size()));
+    EXPECT_TRUE(compressed.empty());
+    EXPECT_TRUE(compressed.decompress().empty());
+}
+}
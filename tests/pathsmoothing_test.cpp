@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathsmoothing.h"
+#include "pathfinding/pathfinder.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class PathSmoothingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 20x20 grid for testing
+        grid = std::make_unique<Grid>(20, 20);
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test lines take one move per step in both walks
+TEST_F(PathSmoothingTest, GridLineSteps) {
+    GridLine four(Position{0, 0}, Position{5, -2}, Connectivity::Four);
+    int steps = 0;
+    Position previous = four.current();
+    while (!four.done()) {
+        const Position& next = four.next();
+        EXPECT_EQ(abs(next.x - previous.x) + abs(next.y - previous.y), 1);
+        previous = next;
+        steps++;
+    }
+    EXPECT_EQ(steps, 7);
+    EXPECT_EQ(previous, Position(5, -2));
+    
+    GridLine eight(Position{0, 0}, Position{5, -2}, Connectivity::Eight);
+    steps = 0;
+    while (!eight.done()) {
+        eight.next();
+        steps++;
+    }
+    EXPECT_EQ(steps, 5);
+    EXPECT_TRUE(GridLine().done());
+}
+
+// Test walls block the line and clear lines report their cost
+TEST_F(PathSmoothingTest, LineOfSight) {
+    float cost = 0.0f;
+    EXPECT_TRUE(grid->hasLineOfSight(Position{0, 0}, Position{6, 3}, &cost));
+    EXPECT_FLOAT_EQ(cost, 9.0f);
+    
+    grid->setMovement(Connectivity::Eight);
+    EXPECT_TRUE(grid->hasLineOfSight(Position{0, 0}, Position{6, 3}, &cost));
+    EXPECT_FLOAT_EQ(cost, 3.0f + 3 * Grid::kDiagonalCost);
+    
+    grid->setCell({3, 1}, CellType::Wall);
+    grid->setCell({3, 2}, CellType::Wall);
+    EXPECT_FALSE(grid->hasLineOfSight(Position{0, 0}, Position{6, 3}));
+    EXPECT_TRUE(grid->hasLineOfSight(Position{0, 5}, Position{6, 5}));
+    EXPECT_FALSE(grid->hasLineOfSight(Position{0, 0}, Position{25, 0}));
+}
+
+// Test an open path shrinks to its two ends at the same cost
+TEST_F(PathSmoothingTest, OpenGridStraightLine) {
+    grid->setMovement(Connectivity::Eight);
+    Pathfinder pathfinder;
+    std::vector<Position> path;
+    ASSERT_TRUE(pathfinder.findPath(*grid, Position{0, 0}, Position{19, 5}, path));
+    
+    std::vector<Position> waypoints;
+    EXPECT_EQ(smoothPath(*grid, path, waypoints), 2);
+    EXPECT_EQ(waypoints.front(), Position(0, 0));
+    EXPECT_EQ(waypoints.back(), Position(19, 5));
+    
+    std::vector<Position> walked;
+    expandWaypoints(waypoints, Connectivity::Eight, walked);
+    EXPECT_EQ(walked.size(), path.size());
+    EXPECT_FLOAT_EQ(walkCost(*grid, walked), pathfinder.getLastPathCost());
+}
+
+// Test waypoints turn around walls and the walk stays legal and no dearer
+TEST_F(PathSmoothingTest, AroundWalls) {
+    for (Connectivity connectivity : {Connectivity::Four, Connectivity::Eight}) {
+        Grid maze(20, 20);
+        maze.setMovement(connectivity);
+        for (int y = 0; y < 15; ++y) {
+            maze.setCell({7, y}, CellType::Wall);
+        }
+        for (int y = 5; y < 20; ++y) {
+            maze.setCell({13, y}, CellType::Wall);
+        }
+        *grid = maze;
+        
+        Pathfinder pathfinder;
+        std::vector<Position> path;
+        ASSERT_TRUE(pathfinder.findPath(*grid, Position{2, 2}, Position{18, 17}, path));
+        
+        std::vector<Position> waypoints;
+        smoothPath(*grid, path, waypoints);
+        EXPECT_LT(waypoints.size(), path.size() / 4);
+        
+        std::vector<Position> walked;
+        expandWaypoints(waypoints, connectivity, walked);
+        EXPECT_EQ(walked.back(), Position(18, 17));
+        EXPECT_LE(walkCost(*grid, walked), pathfinder.getLastPathCost() + 1e-4f);
+    }
+}
+
+// Test shortcuts across dearer terrain are not taken
+TEST_F(PathSmoothingTest, KeepsCheapTerrain) {
+    // An L-shaped road around a mud field
+    for (int i = 0; i < 10; ++i) {
+        grid->setCell({i, 0}, CellType::Road);
+        grid->setCell({9, i}, CellType::Road);
+        for (int j = 1; j < 10; ++j) {
+            grid->setCell({i, j}, i < 9 ? CellType::Mud : CellType::Road);
+        }
+    }
+    std::vector<Position> path;
+    for (int x = 0; x <= 9; ++x) {
+        path.push_back(Position{x, 0});
+    }
+    for (int y = 1; y <= 9; ++y) {
+        path.push_back(Position{9, y});
+    }
+    
+    std::vector<Position> waypoints;
+    EXPECT_EQ(smoothPath(*grid, path, waypoints), 3);
+    EXPECT_EQ(waypoints[1], Position(9, 0));
+}
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathfinder.h"
+#include "pathfinding/subgoalgraph.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class SubgoalGraphTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 24x24 8-connected grid with scattered walls and uniform costs
+        grid = makeScatteredGrid(24, 24, 9, false);
+        grid->setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    }
+
+    // Every sampled pair of walkable cells gets a valid path of the A* cost
+    void expectOptimal(SubgoalGraph& graph) {
+        Pathfinder plain(2000);
+        expectMatchesAStar(*grid, plain, 7, 5, [&](const Position& start, const Position& goal,
+                                                   std::vector<Position>& path, float& cost) {
+            bool found = graph.findPath(*grid, start, goal, path);
+            cost = graph.getLastPathCost();
+            return found;
+        });
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test subgoals sit on the corners of an obstacle
+TEST_F(SubgoalGraphTest, SubgoalsOnCorners) {
+    Grid open(5, 5);
+    open.setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    open.setCell(Position{2, 2}, CellType::Wall);
+
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(open));
+    EXPECT_EQ(graph.getSubgoalCount(), 4u);
+    EXPECT_TRUE(graph.isSubgoal(Position(1, 1)));
+    EXPECT_TRUE(graph.isSubgoal(Position(3, 1)));
+    EXPECT_TRUE(graph.isSubgoal(Position(1, 3)));
+    EXPECT_TRUE(graph.isSubgoal(Position(3, 3)));
+    EXPECT_FALSE(graph.isSubgoal(Position(2, 1)));
+
+    // Opposite corners see each other only through the two other corners
+    EXPECT_EQ(graph.getEdgeCount(), 8u);
+}
+
+// Test queries cost the same as A* on the grid
+TEST_F(SubgoalGraphTest, MatchesAStar) {
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(*grid));
+    EXPECT_TRUE(graph.isValidFor(*grid));
+    EXPECT_GT(graph.getSubgoalCount(), 0u);
+    expectOptimal(graph);
+}
+
+// Test the search expands far fewer nodes than A* in open space
+TEST_F(SubgoalGraphTest, ExpandsFewerNodes) {
+    Grid open(40, 40);
+    open.setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    for (int y = 5; y < 35; ++y) {
+        open.setCell(Position{20, y}, CellType::Wall);
+    }
+
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(open));
+    Pathfinder plain(2000);
+    std::vector<Position> path;
+    ASSERT_TRUE(plain.findPath(open, Position(10, 20), Position(30, 20), path));
+    ASSERT_TRUE(graph.findPath(open, Position(10, 20), Position(30, 20), path));
+    EXPECT_NEAR(graph.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+    EXPECT_LT(graph.getLastExpansions() * 10, static_cast<size_t>(plain.getLastSearchSteps()));
+}
+
+// Test grids the graph cannot describe are refused
+TEST_F(SubgoalGraphTest, UnsupportedGridsRejected) {
+    SubgoalGraph graph;
+    grid->setMovement(Connectivity::Eight, CornerCutting::Allow);
+    EXPECT_FALSE(graph.build(*grid));
+    EXPECT_FALSE(graph.isValidFor(*grid));
+
+    grid->setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    ASSERT_TRUE(graph.build(*grid));
+    grid->setCell(Position{0, 0}, CellType::Mud);
+    grid->setCell(Position{1, 0}, CellType::Mud);
+    EXPECT_FALSE(graph.isValidFor(*grid));
+    EXPECT_FALSE(graph.build(*grid));
+}
+
+// Test start equal to goal and unreachable goals
+TEST_F(SubgoalGraphTest, TrivialAndUnreachable) {
+    Grid walled(8, 8);
+    walled.setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    for (int y = 0; y < 8; ++y) {
+        walled.setCell(Position{4, y}, CellType::Wall);
+    }
+
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(walled));
+    std::vector<Position> path;
+    ASSERT_TRUE(graph.findPath(walled, Position(1, 1), Position(1, 1), path));
+    EXPECT_EQ(path.size(), 1u);
+    EXPECT_FALSE(graph.findPath(walled, Position(1, 1), Position(6, 6), path));
+    EXPECT_TRUE(path.empty());
+    EXPECT_FALSE(graph.findPath(walled, Position(1, 1), Position(4, 4), path));
+}
+
+// Test wall edits reported through a subscription keep the graph exact
+TEST_F(SubgoalGraphTest, UpdateMatchesRebuild) {
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(*grid));
+    size_t relinked = 0;
+    grid->subscribe([&](const GridChangeBatch& batch) { relinked += graph.update(*grid, batch); });
+
+    grid->setCell(Position{5, 5}, CellType::Wall);
+    grid->setCell(Position{6, 5}, CellType::Wall);
+    grid->setCell(Position{12, 12}, grid->isWalkable(Position(12, 12)) ? CellType::Wall : CellType::Empty);
+    grid->setCell(Position{18, 3}, CellType::Empty);
+    grid->flushChanges();
+    EXPECT_TRUE(graph.isValidFor(*grid));
+    EXPECT_GT(relinked, 0u);
+    EXPECT_LT(relinked, graph.getSubgoalCount());
+
+    SubgoalGraph fresh;
+    ASSERT_TRUE(fresh.build(*grid));
+    EXPECT_EQ(graph.getSubgoalCount(), fresh.getSubgoalCount());
+    EXPECT_EQ(graph.getEdgeCount(), fresh.getEdgeCount());
+    expectOptimal(graph);
+}
+
+// Test the pathfinder searches the graph while it matches the grid
+TEST_F(SubgoalGraphTest, PathfinderUsesGraph) {
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(*grid));
+    Pathfinder plain(2000);
+    Pathfinder pathfinder(2000);
+    pathfinder.setSubgoalGraph(&graph);
+    std::vector<Position> path;
+
+    Position start(0, 1);
+    Position goal(22, 23);
+    ASSERT_TRUE(grid->isWalkable(start) && grid->isWalkable(goal));
+    ASSERT_TRUE(plain.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_NEAR(pathfinder.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+    EXPECT_EQ(static_cast<size_t>(pathfinder.getLastSearchSteps()), graph.getLastExpansions());
+
+    // A stale graph is ignored
+    grid->setCell(Position{10, 10}, grid->isWalkable(Position(10, 10)) ? CellType::Wall : CellType::Empty);
+    EXPECT_FALSE(graph.isValidFor(*grid));
+    ASSERT_EQ(pathfinder.findPath(*grid, start, goal, path), plain.findPath(*grid, start, goal, path));
+    EXPECT_NEAR(pathfinder.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+}
+
+// Test a graph built for another grid with the same revision is not used
+TEST_F(SubgoalGraphTest, OtherGridIgnored) {
+    EqualRevisionGrids grids = makeEqualRevisionGrids(10, Connectivity::Eight, CornerCutting::Forbid);
+    SubgoalGraph graph;
+    ASSERT_TRUE(graph.build(grids.column));
+    EXPECT_FALSE(graph.isValidFor(grids.row));
+
+    Pathfinder pathfinder(1000);
+    pathfinder.setSubgoalGraph(&graph);
+    expectPlainCost(pathfinder, grids.row, Position(0, 0), Position(0, 9));
+}
+
+} // namespace pathfinding::test
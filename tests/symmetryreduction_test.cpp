@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "pathfinding/pathfinder.h"
+#include "pathfinding/symmetryreduction.h"
+#include "test_grids.h"
+
+namespace pathfinding::test {
+
+class SymmetryReductionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a 24x24 grid with scattered walls and terrain
+        grid = makeScatteredGrid(24, 24, 5);
+    }
+
+    // Every sampled pair of walkable cells gets a valid path of the A* cost
+    void expectOptimal(SymmetryReduction& reduction) {
+        Pathfinder plain(1000);
+        expectMatchesAStar(*grid, plain, 11, 7, [&](const Position& start, const Position& goal,
+                                                    std::vector<Position>& path, float& cost) {
+            bool found = reduction.findPath(*grid, start, goal, path);
+            cost = reduction.getLastPathCost();
+            return found;
+        });
+    }
+
+    std::unique_ptr<Grid> grid;
+};
+
+// Test an open room becomes one rectangle and only its border is kept
+TEST_F(SymmetryReductionTest, OpenRoomKeepsBorder) {
+    Grid open(10, 6);
+    SymmetryReduction reduction;
+    ASSERT_TRUE(reduction.build(open));
+    EXPECT_EQ(reduction.getRectangleCount(), 1u);
+    EXPECT_EQ(reduction.getBorderCount(), 60u - 8u * 4u);
+    EXPECT_TRUE(reduction.isBorder(Position(0, 3)));
+    EXPECT_TRUE(reduction.isBorder(Position(4, 5)));
+    EXPECT_FALSE(reduction.isBorder(Position(4, 3)));
+}
+
+// Test queries cost the same as A* on walls and mixed terrain
+TEST_F(SymmetryReductionTest, MatchesAStar) {
+    SymmetryReduction reduction;
+    ASSERT_TRUE(reduction.build(*grid));
+    EXPECT_TRUE(reduction.isValidFor(*grid));
+    EXPECT_GT(reduction.getRectangleCount(), 0u);
+    expectOptimal(reduction);
+
+    // Interior starts and goals in open rooms
+    for (int y = 2; y < 22; ++y) {
+        for (int x = 2; x < 22; ++x) {
+            grid->setCell(Position{x, y}, y < 12 ? CellType::Empty : CellType::Mud);
+        }
+    }
+    ASSERT_TRUE(reduction.build(*grid));
+    expectOptimal(reduction);
+}
+
+// Test the search expands far fewer nodes than A* around a wall between open rooms
+TEST_F(SymmetryReductionTest, ExpandsFewerNodes) {
+    Grid rooms(40, 40);
+    for (int y = 0; y < 36; ++y) {
+        rooms.setCell(Position{20, y}, CellType::Wall);
+    }
+
+    SymmetryReduction reduction;
+    ASSERT_TRUE(reduction.build(rooms));
+    Pathfinder plain(2000);
+    std::vector<Position> path;
+    ASSERT_TRUE(plain.findPath(rooms, Position(5, 10), Position(35, 10), path));
+    ASSERT_TRUE(reduction.findPath(rooms, Position(5, 10), Position(35, 10), path));
+    EXPECT_NEAR(reduction.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+    EXPECT_LT(reduction.getLastExpansions() * 4, static_cast<size_t>(plain.getLastSearchSteps()));
+}
+
+// Test grids the reduction cannot describe are refused, and edits make it stale
+TEST_F(SymmetryReductionTest, UnsupportedAndStale) {
+    SymmetryReduction reduction;
+    grid->setMovement(Connectivity::Eight, CornerCutting::Forbid);
+    EXPECT_FALSE(reduction.build(*grid));
+    EXPECT_FALSE(reduction.isValidFor(*grid));
+
+    grid->setMovement(Connectivity::Four);
+    ASSERT_TRUE(reduction.build(*grid));
+    grid->setCell(Position{10, 10}, grid->isWalkable(Position(10, 10)) ? CellType::Wall : CellType::Empty);
+    EXPECT_FALSE(reduction.isValidFor(*grid));
+    ASSERT_TRUE(reduction.build(*grid));
+    grid->setTerrainCost(CellType::Mud, 7.0f);
+    EXPECT_FALSE(reduction.isValidFor(*grid));
+}
+
+// Test start equal to goal, walls and unreachable goals
+TEST_F(SymmetryReductionTest, TrivialAndUnreachable) {
+    Grid walled(8, 8);
+    for (int y = 0; y < 8; ++y) {
+        walled.setCell(Position{4, y}, CellType::Wall);
+    }
+
+    SymmetryReduction reduction;
+    ASSERT_TRUE(reduction.build(walled));
+    std::vector<Position> path;
+    ASSERT_TRUE(reduction.findPath(walled, Position(1, 1), Position(1, 1), path));
+    EXPECT_EQ(path.size(), 1u);
+    EXPECT_FALSE(reduction.findPath(walled, Position(1, 1), Position(6, 6), path));
+    EXPECT_TRUE(path.empty());
+    EXPECT_FALSE(reduction.findPath(walled, Position(1, 1), Position(4, 4), path));
+}
+
+// Test the pathfinder searches the reduction while it matches the grid
+TEST_F(SymmetryReductionTest, PathfinderUsesReduction) {
+    Position start(0, 2);
+    Position goal(23, 23);
+    grid->setCell(start, CellType::Empty);
+    grid->setCell(goal, CellType::Empty);
+    SymmetryReduction reduction;
+    ASSERT_TRUE(reduction.build(*grid));
+    Pathfinder plain(1000);
+    Pathfinder pathfinder(1000);
+    pathfinder.setSymmetryReduction(&reduction);
+    std::vector<Position> path;
+
+    ASSERT_TRUE(plain.findPath(*grid, start, goal, path));
+    ASSERT_TRUE(pathfinder.findPath(*grid, start, goal, path));
+    EXPECT_NEAR(pathfinder.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+    EXPECT_EQ(static_cast<size_t>(pathfinder.getLastSearchSteps()), reduction.getLastExpansions());
+
+    // A stale reduction is ignored
+    grid->setCell(Position{10, 10}, grid->isWalkable(Position(10, 10)) ? CellType::Wall : CellType::Empty);
+    ASSERT_EQ(pathfinder.findPath(*grid, start, goal, path), plain.findPath(*grid, start, goal, path));
+    EXPECT_NEAR(pathfinder.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+}
+
+// Test a reduction built for another grid with the same revision is not used
+TEST_F(SymmetryReductionTest, OtherGridIgnored) {
+    EqualRevisionGrids grids = makeEqualRevisionGrids(10);
+    SymmetryReduction reduction;
+    ASSERT_TRUE(reduction.build(grids.column));
+    EXPECT_FALSE(reduction.isValidFor(grids.row));
+
+    Pathfinder pathfinder(1000);
+    pathfinder.setSymmetryReduction(&reduction);
+    expectPlainCost(pathfinder, grids.row, Position(0, 0), Position(0, 9));
+}
+
+} // namespace pathfinding::test
@@ -0,0 +1,98 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "pathfinding/grid.h"
+#include "pathfinding/pathfinder.h"
+#include <memory>
+#include <vector>
+
+namespace pathfinding::test {
+
+// Grid with a quarter of the cells walls and, unless withTerrain is false, about one in
+// seven road, mud or water, scattered by a fixed-seed LCG so every run sees the same map
+inline std::unique_ptr<Grid> makeScatteredGrid(int width, int height, unsigned int seed, bool withTerrain = true) {
+    auto grid = std::make_unique<Grid>(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1103515245u + 12345u;
+            int roll = (seed >> 16) % 100;
+            if (roll < 25) {
+                grid->setCell(Position{x, y}, CellType::Wall);
+            } else if (withTerrain && roll < 40) {
+                grid->setCell(Position{x, y}, static_cast<CellType>(2 + roll % 3));
+            }
+        }
+    }
+    return grid;
+}
+
+// Cost of walking path on grid, expecting every step to be a legal move
+inline float walkCost(const Grid& grid, const std::vector<Position>& path) {
+    float cost = 0.0f;
+    for (size_t i = 1; i < path.size(); ++i) {
+        EXPECT_TRUE(grid.canMove(path[i - 1], path[i]));
+        cost += grid.getStepCost(path[i - 1], path[i]);
+    }
+    return cost;
+}
+
+// Two grids of the same size, rules and revision that differ in their cells: one walled
+// down the middle column, the other along the middle row, each wall open at the far end
+struct EqualRevisionGrids {
+    Grid column;
+    Grid row;
+};
+
+inline EqualRevisionGrids makeEqualRevisionGrids(int side, Connectivity connectivity = Connectivity::Four,
+                                                 CornerCutting cornerCutting = CornerCutting::Forbid) {
+    EqualRevisionGrids grids = {Grid(side, side), Grid(side, side)};
+    grids.column.setMovement(connectivity, cornerCutting);
+    grids.row.setMovement(connectivity, cornerCutting);
+    for (int i = 0; i < side - 1; ++i) {
+        grids.column.setCell(Position{side / 2, i}, CellType::Wall);
+        grids.row.setCell(Position{i, side / 2}, CellType::Wall);
+    }
+    EXPECT_EQ(grids.column.getRevision(), grids.row.getRevision());
+    return grids;
+}
+
+// pathfinder finds a path from start to goal of the cost plain A* finds
+inline void expectPlainCost(Pathfinder& pathfinder, const Grid& grid, const Position& start, const Position& goal) {
+    Pathfinder plain(1000);
+    std::vector<Position> path;
+    ASSERT_TRUE(plain.findPath(grid, start, goal, path));
+    ASSERT_TRUE(pathfinder.findPath(grid, start, goal, path));
+    EXPECT_NEAR(pathfinder.getLastPathCost(), plain.getLastPathCost(), 1e-3f);
+}
+
+// For the pairs of walkable cells numbered from and to (row-major), stepping by fromStride
+// and toStride, query(start, goal, path, cost) finds a path exactly when plain does, and
+// its path runs from start to goal over legal moves at the cost plain A* finds
+template <typename Query>
+void expectMatchesAStar(const Grid& grid, Pathfinder& plain, int fromStride, int toStride, Query query) {
+    const int width = grid.getWidth();
+    const int cells = width * grid.getHeight();
+    std::vector<Position> expected;
+    std::vector<Position> path;
+
+    for (int from = 0; from < cells; from += fromStride) {
+        for (int to = 0; to < cells; to += toStride) {
+            Position start(from % width, from / width);
+            Position goal(to % width, to / width);
+            if (!grid.isWalkable(start) || !grid.isWalkable(goal)) {
+                continue;
+            }
+            bool found = plain.findPath(grid, start, goal, expected);
+            float cost = 0.0f;
+            ASSERT_EQ(query(start, goal, path, cost), found);
+            if (found) {
+                ASSERT_FALSE(path.empty());
+                EXPECT_EQ(path.front(), start);
+                EXPECT_EQ(path.back(), goal);
+                EXPECT_NEAR(walkCost(grid, path), plain.getLastPathCost(), 1e-3f);
+                EXPECT_NEAR(cost, plain.getLastPathCost(), 1e-3f);
+            }
+        }
+    }
+}
+
+} // namespace pathfinding::test
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "pathfinding/trace.h"
+#include "pathfinding/pathfinder.h"
+#include <sstream>
+#include <thread>
+
+namespace pathfinding::test {
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        clearTrace();
+    }
+
+    void TearDown() override {
+        setTracingEnabled(false);
+        clearTrace();
+    }
+
+    std::string dump() {
+        std::ostringstream out;
+        writeChromeTrace(out);
+        return out.str();
+    }
+};
+
+// Test nothing is recorded while tracing is off
+TEST_F(TraceTest, DisabledRecordsNothing) {
+    {
+        TraceScope scope("Disabled");
+    }
+    EXPECT_EQ(getTraceEventCount(), 0);
+    EXPECT_EQ(dump().find("Disabled"), std::string::npos);
+}
+
+// Test scopes become complete events in the Chrome trace
+TEST_F(TraceTest, RecordsScopes) {
+    setTracingEnabled(true);
+    {
+        TraceScope outer("Outer");
+        TraceScope inner("Inner");
+    }
+    setTracingEnabled(false);
+
+    EXPECT_EQ(getTraceEventCount(), 2);
+    std::string json = dump();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+    EXPECT_NE(json.find("{\"name\":\"Outer\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"Inner\",\"ph\":\"X\""), std::string::npos);
+
+    clearTrace();
+    EXPECT_EQ(getTraceEventCount(), 0);
+}
+
+// Test each thread gets its own id and name
+TEST_F(TraceTest, PerThreadBuffers) {
+    setTracingEnabled(true);
+    std::thread worker([]() {
+        setTraceThreadName("worker \"1\"");
+        TraceScope scope("WorkerScope");
+    });
+    worker.join();
+    {
+        TraceScope scope("MainScope");
+    }
+    setTracingEnabled(false);
+
+    std::string json = dump();
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker \\\"1\\\"\"}"), std::string::npos);
+
+    // Events of the finished worker are kept, on a different thread id
+    size_t workerEvent = json.find("\"name\":\"WorkerScope\"");
+    size_t mainEvent = json.find("\"name\":\"MainScope\"");
+    ASSERT_NE(workerEvent, std::string::npos);
+    ASSERT_NE(mainEvent, std::string::npos);
+    std::string workerTid = json.substr(json.find("\"tid\":", workerEvent), 8);
+    std::string mainTid = json.substr(json.find("\"tid\":", mainEvent), 8);
+    EXPECT_NE(workerTid, mainTid);
+}
+
+// Test control characters in names are escaped
+TEST_F(TraceTest, EscapesControlCharacters) {
+    setTracingEnabled(true);
+    setTraceThreadName("line\nbreak\ttab\x01");
+    {
+        TraceScope scope("Scope");
+    }
+    setTracingEnabled(false);
+
+    std::string json = dump();
+    EXPECT_NE(json.find("\"line\\nbreak\\ttab\\u0001\""), std::string::npos);
+    setTraceThreadName("");
+}
+
+// Test searches are instrumented
+TEST_F(TraceTest, PathfinderEvents) {
+    Grid grid(5, 5);
+    Pathfinder pathfinder;
+    std::vector<Position> path;
+
+    setTracingEnabled(true);
+    EXPECT_TRUE(pathfinder.findPath(grid, Position{0, 0}, Position{4, 4}, path));
+    setTracingEnabled(false);
+
+    std::string json = dump();
+#if PATHFINDING_TRACING
+    EXPECT_NE(json.find("Pathfinder::findPath"), std::string::npos);
+    EXPECT_NE(json.find("AStarSearch::SearchStep loop"), std::string::npos);
+    EXPECT_NE(json.find("Pathfinder::extractPath"), std::string::npos);
+#else
+    EXPECT_EQ(json.find("Pathfinder::findPath"), std::string::npos);
+#endif
+}
+}
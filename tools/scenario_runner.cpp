@@ -0,0 +1,400 @@
+// Runs every query of a MovingAI .scen file through a search engine and reports
+// per-bucket latency, expansion and optimality statistics as CSV or JSON.
+//
+// Usage: scenario_runner <file.scen> [--engine name] [--map-dir dir]
+//                        [--format csv|json] [--output file] [--list-engines]
+
+#include "pathfinding/movingai.h"
+#include "pathfinding/pathfinder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A search engine the runner can drive
+class ScenarioEngine {
+public:
+    virtual ~ScenarioEngine() = default;
+
+    // Returns true and fills cost/expansions if a path was found
+    virtual bool solve(const Grid& grid, const Position& start, const Position& goal,
+                       double& cost, int& expansions) = 0;
+};
+
+class PathfinderEngine : public ScenarioEngine {
+public:
+    explicit PathfinderEngine(const Grid& grid, SearchAlgorithm algorithm = SearchAlgorithm::AStar)
+        : pathfinder_(grid.getWidth() * grid.getHeight() + 8) {
+        pathfinder_.setSearchAlgorithm(algorithm);
+    }
+
+    bool solve(const Grid& grid, const Position& start, const Position& goal,
+               double& cost, int& expansions) override {
+        bool found = pathfinder_.findPath(grid, start, goal, path_);
+        cost = pathfinder_.getLastPathCost();
+        expansions = pathfinder_.getLastSearchSteps();
+        return found;
+    }
+
+private:
+    Pathfinder pathfinder_;
+    std::vector<Position> path_;
+};
+
+// A* over a simple subgoal graph built when the map is loaded
+class SubgoalGraphEngine : public ScenarioEngine {
+public:
+    explicit SubgoalGraphEngine(const Grid& grid)
+        : pathfinder_(grid.getWidth() * grid.getHeight() + 8) {
+        if (!graph_.build(grid)) {
+            std::cerr << "Subgoal graph unavailable, searching the grid\n";
+        }
+        pathfinder_.setSubgoalGraph(&graph_);
+    }
+
+    bool solve(const Grid& grid, const Position& start, const Position& goal,
+               double& cost, int& expansions) override {
+        bool found = pathfinder_.findPath(grid, start, goal, path_);
+        cost = pathfinder_.getLastPathCost();
+        expansions = pathfinder_.getLastSearchSteps();
+        return found;
+    }
+
+private:
+    SubgoalGraph graph_;
+    Pathfinder pathfinder_;
+    std::vector<Position> path_;
+};
+
+// Contraction hierarchy built when the map is loaded
+class HierarchyEngine : public ScenarioEngine {
+public:
+    explicit HierarchyEngine(const Grid& grid)
+        : pathfinder_(grid.getWidth() * grid.getHeight() + 8) {
+        hierarchy_.build(grid);
+        pathfinder_.setContractionHierarchy(&hierarchy_);
+    }
+
+    bool solve(const Grid& grid, const Position& start, const Position& goal,
+               double& cost, int& expansions) override {
+        bool found = pathfinder_.findPath(grid, start, goal, path_);
+        cost = pathfinder_.getLastPathCost();
+        expansions = pathfinder_.getLastSearchSteps();
+        return found;
+    }
+
+private:
+    ContractionHierarchy hierarchy_;
+    Pathfinder pathfinder_;
+    std::vector<Position> path_;
+};
+
+struct EngineEntry {
+    const char* name;
+    const char* description;
+    std::unique_ptr<ScenarioEngine> (*create)(const Grid& grid);  // Called once per map
+};
+
+const EngineEntry kEngines[] = {
+    {"astar", "A* through Pathfinder",
+     [](const Grid& grid) -> std::unique_ptr<ScenarioEngine> { return std::make_unique<PathfinderEngine>(grid); }},
+    {"fringe", "Fringe Search through Pathfinder, default memory budget",
+     [](const Grid& grid) -> std::unique_ptr<ScenarioEngine> {
+         return std::make_unique<PathfinderEngine>(grid, SearchAlgorithm::Fringe);
+     }},
+    {"idastar", "IDA* through Pathfinder, default memory budget",
+     [](const Grid& grid) -> std::unique_ptr<ScenarioEngine> {
+         return std::make_unique<PathfinderEngine>(grid, SearchAlgorithm::IDAStar);
+     }},
+    {"ssg", "A* over a simple subgoal graph built per map",
+     [](const Grid& grid) -> std::unique_ptr<ScenarioEngine> { return std::make_unique<SubgoalGraphEngine>(grid); }},
+    {"ch", "Contraction hierarchy built per map",
+     [](const Grid& grid) -> std::unique_ptr<ScenarioEngine> { return std::make_unique<HierarchyEngine>(grid); }},
+};
+
+// Scenario optima are octile lengths without corner cutting, the movement rules maps are
+// loaded with, so returned costs must match them (up to the fixed point diagonal cost)
+const bool kOptimumIsExact = true;
+const double kCostTolerance = 1e-3;
+
+struct QueryResult {
+    bool solved;
+    bool costError;
+    double micros;
+    int expansions;
+    double costRatio;  // Returned cost over the scenario optimum
+};
+
+struct BucketReport {
+    int bucket;
+    int count = 0;
+    int solved = 0;
+    int failed = 0;
+    int costErrors = 0;
+    double meanMicros = 0.0;
+    double p50Micros = 0.0;
+    double p95Micros = 0.0;
+    double maxMicros = 0.0;
+    double meanExpansions = 0.0;
+    double meanCostRatio = 0.0;
+};
+
+double percentile(std::vector<double> values, double percent) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(percent / 100.0 * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+BucketReport summarize(int bucket, const std::vector<QueryResult>& results) {
+    BucketReport report;
+    report.bucket = bucket;
+    report.count = static_cast<int>(results.size());
+
+    std::vector<double> latencies;
+    double ratioSum = 0.0;
+    double expansionSum = 0.0;
+
+    for (const QueryResult& result : results) {
+        latencies.push_back(result.micros);
+        expansionSum += result.expansions;
+        if (result.solved) {
+            report.solved++;
+            ratioSum += result.costRatio;
+        } else {
+            report.failed++;
+        }
+        if (result.costError) {
+            report.costErrors++;
+        }
+    }
+
+    if (!latencies.empty()) {
+        double total = 0.0;
+        for (double micros : latencies) {
+            total += micros;
+        }
+        report.meanMicros = total / latencies.size();
+        report.p50Micros = percentile(latencies, 50.0);
+        report.p95Micros = percentile(latencies, 95.0);
+        report.maxMicros = *std::max_element(latencies.begin(), latencies.end());
+        report.meanExpansions = expansionSum / latencies.size();
+    }
+    if (report.solved) {
+        report.meanCostRatio = ratioSum / report.solved;
+    }
+    return report;
+}
+
+void writeCsv(std::ostream& out, const std::vector<BucketReport>& reports) {
+    out << "bucket,count,solved,failed,cost_errors,mean_us,p50_us,p95_us,max_us,mean_expansions,mean_cost_ratio\n";
+    for (const BucketReport& r : reports) {
+        out << r.bucket << ',' << r.count << ',' << r.solved << ',' << r.failed << ',' << r.costErrors << ','
+            << r.meanMicros << ',' << r.p50Micros << ',' << r.p95Micros << ',' << r.maxMicros << ','
+            << r.meanExpansions << ',' << r.meanCostRatio << '\n';
+    }
+}
+
+// JSON string literal for text, escaping quotes, backslashes and control characters
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        switch (c) {
+        case '"': quoted += "\\\""; break;
+        case '\\': quoted += "\\\\"; break;
+        case '\n': quoted += "\\n"; break;
+        case '\r': quoted += "\\r"; break;
+        case '\t': quoted += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                quoted += escaped;
+            } else {
+                quoted += c;
+            }
+        }
+    }
+    return quoted + "\"";
+}
+
+// JSON has no NaN or infinity, so those become null
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+void writeJson(std::ostream& out, const std::string& engine, const std::string& scenarioFile,
+               const std::vector<BucketReport>& reports) {
+    out << "{\n  \"engine\": " << jsonString(engine) << ",\n  \"scenarios\": " << jsonString(scenarioFile) << ",\n"
+        << "  \"exact_optimum\": " << (kOptimumIsExact ? "true" : "false") << ",\n  \"buckets\": [";
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const BucketReport& r = reports[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\"bucket\": " << r.bucket << ", \"count\": " << r.count << ", \"solved\": " << r.solved
+            << ", \"failed\": " << r.failed << ", \"cost_errors\": " << r.costErrors
+            << ", \"mean_us\": " << jsonNumber(r.meanMicros) << ", \"p50_us\": " << jsonNumber(r.p50Micros)
+            << ", \"p95_us\": " << jsonNumber(r.p95Micros) << ", \"max_us\": " << jsonNumber(r.maxMicros)
+            << ", \"mean_expansions\": " << jsonNumber(r.meanExpansions)
+            << ", \"mean_cost_ratio\": " << jsonNumber(r.meanCostRatio) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void printUsage() {
+    std::cerr << "Usage: scenario_runner <file.scen> [--engine name] [--map-dir dir]\n"
+              << "                       [--format csv|json] [--output file] [--list-engines]\n";
+}
+}
+
+int main(int argc, char** argv) {
+    std::string scenarioFile;
+    std::string engineName = "astar";
+    std::string mapDir;
+    std::string format = "csv";
+    std::string outputFile;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--list-engines") {
+            for (const EngineEntry& entry : kEngines) {
+                std::cerr << entry.name << "\t" << entry.description << "\n";
+            }
+            return 0;
+        } else if (arg == "--engine" && hasValue) {
+            engineName = argv[++i];
+        } else if (arg == "--map-dir" && hasValue) {
+            mapDir = argv[++i];
+        } else if (arg == "--format" && hasValue) {
+            format = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (arg[0] != '-' && scenarioFile.empty()) {
+            scenarioFile = arg;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (scenarioFile.empty() || (format != "csv" && format != "json")) {
+        printUsage();
+        return 1;
+    }
+
+    const EngineEntry* engine = nullptr;
+    for (const EngineEntry& entry : kEngines) {
+        if (engineName == entry.name) {
+            engine = &entry;
+        }
+    }
+    if (!engine) {
+        std::cerr << "Unknown engine " << engineName << " (see --list-engines)\n";
+        return 1;
+    }
+
+    std::vector<MovingAIScenario> scenarios;
+    if (!loadMovingAIScenarios(scenarioFile, scenarios)) {
+        std::cerr << "Could not read scenarios from " << scenarioFile << "\n";
+        return 1;
+    }
+    if (mapDir.empty()) {
+        mapDir = std::filesystem::path(scenarioFile).parent_path().string();
+    }
+
+    std::ofstream file;
+    std::ostream out(std::cout.rdbuf());
+    if (!outputFile.empty()) {
+        file.open(outputFile);
+        if (!file) {
+            std::cerr << "Could not write " << outputFile << "\n";
+            return 1;
+        }
+        out.rdbuf(file.rdbuf());
+    }
+
+    // Maps and engines are created once per map file
+    struct LoadedMap {
+        std::unique_ptr<Grid> grid;
+        std::unique_ptr<ScenarioEngine> engine;
+    };
+    std::map<std::string, LoadedMap> maps;
+    std::map<int, std::vector<QueryResult>> buckets;
+    int errors = 0;
+
+    for (const MovingAIScenario& scenario : scenarios) {
+        LoadedMap& map = maps[scenario.mapName];
+        if (!map.grid) {
+            map.grid = std::make_unique<Grid>(1, 1);
+            std::string mapPath = (std::filesystem::path(mapDir) / scenario.mapName).string();
+            if (!loadMovingAIMap(mapPath, *map.grid)) {
+                std::cerr << "Could not read map " << mapPath << "\n";
+                return 1;
+            }
+            map.grid->setMovement(Connectivity::Eight, CornerCutting::Forbid);
+            map.engine = engine->create(*map.grid);
+        }
+
+        if (map.grid->getWidth() != scenario.mapWidth || map.grid->getHeight() != scenario.mapHeight) {
+            std::cerr << "Map " << scenario.mapName << " does not match the scenario size\n";
+            return 1;
+        }
+
+        QueryResult result;
+        double cost = 0.0;
+        auto begin = std::chrono::steady_clock::now();
+        result.solved = map.engine->solve(*map.grid, scenario.start, scenario.goal, cost, result.expansions);
+        result.micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+        double tolerance = kCostTolerance * std::max(1.0, scenario.optimalLength);
+        if (kOptimumIsExact) {
+            result.costError = result.solved && std::fabs(cost - scenario.optimalLength) > tolerance;
+        } else {
+            result.costError = result.solved && cost < scenario.optimalLength - tolerance;
+        }
+        result.costRatio = scenario.optimalLength > 0.0 ? cost / scenario.optimalLength : 1.0;
+
+        if (!result.solved || result.costError) {
+            errors++;
+            std::cerr << (result.solved ? "Cost mismatch" : "No path") << " for bucket " << scenario.bucket
+                      << " (" << scenario.start.x << "," << scenario.start.y << ") -> ("
+                      << scenario.goal.x << "," << scenario.goal.y << "): got " << cost
+                      << ", optimum " << scenario.optimalLength << "\n";
+        }
+
+        buckets[scenario.bucket].push_back(result);
+    }
+
+    std::vector<BucketReport> reports;
+    for (const auto& [bucket, results] : buckets) {
+        reports.push_back(summarize(bucket, results));
+    }
+
+    if (format == "json") {
+        writeJson(out, engine->name, scenarioFile, reports);
+    } else {
+        writeCsv(out, reports);
+    }
+
+    std::cerr << scenarios.size() << " scenarios, " << errors << " errors\n";
+    return errors ? 2 : 0;
+}